@@ -1,9 +1,24 @@
 #include "helloTriangle.hpp"
+#include "renderSettings.hpp"
+
+#include <gsl/gsl>
+
+#include <string_view>
+#include <string>
 
 auto
-main() -> int
+main(int argc, char** argv) -> int
 {
-    auto triangle = HelloTriangle{};
+    auto settings = RenderSettings{};
+
+    for(auto const* argument : gsl::make_span(argv, argc).subspan(1)) {
+        if(!parse_render_setting(argument, settings)) {
+            throw std::invalid_argument(
+                    "Unknown argument " + std::string{argument});
+        }
+    }
+
+    auto triangle = HelloTriangle{settings};
 
     triangle.run();
 
@@ -0,0 +1,182 @@
+#include "helloTriangle.hpp"
+#include "renderSettings.hpp"
+#include "frameTimings.hpp"
+
+#include <gsl/gsl>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <string>
+#include <vector>
+
+auto constexpr defaultBenchFrames = uint32_t{1000};
+
+// The first frame and frames that were not presented have no interval.
+[[nodiscard]] auto
+present_intervals(std::vector<vulkanUtils::FrameTimings> const& frames)
+        -> std::vector<std::chrono::nanoseconds>
+{
+    auto intervals = std::vector<std::chrono::nanoseconds>{};
+    intervals.reserve(frames.size());
+
+    for(auto const& frame : frames) {
+        if(frame.presentInterval.count() != 0) {
+            intervals.push_back(frame.presentInterval);
+        }
+    }
+
+    return intervals;
+}
+
+auto
+write_report(std::ostream& stream, HelloTriangle const& triangle) -> void
+{
+    using vulkanUtils::FrameTimings;
+    using vulkanUtils::percentiles;
+    using vulkanUtils::write_json;
+
+    auto const& settings = triangle.settings();
+    auto const& frames   = triangle.frameTimings();
+
+    auto const asyncCompute =
+            vulkanUtils::has_async_compute(triangle.queueTopology());
+    auto const dedicatedTransfer =
+            vulkanUtils::has_dedicated_transfer(triangle.queueTopology());
+    auto const& transfers = triangle.transferStats();
+    auto const batches    = triangle.drawBatchStats();
+    auto const pipelines  = triangle.pipelineRegistryStats();
+    auto const& shaders   = triangle.shaderCompileStats();
+    auto const& devices   = triangle.capabilityCacheStats();
+
+    stream << "{\n"
+           << "  \"device\": ";
+    write_json(stream, triangle.deviceName()) << ",\n"
+           << "  \"headless\": " << (settings.headless ? "true" : "false")
+           << ",\n"
+           << "  \"width\": " << settings.extent.width << ",\n"
+           << "  \"height\": " << settings.extent.height << ",\n"
+           << "  \"frames_in_flight\": " << settings.framesInFlight << ",\n"
+           << "  \"async_compute\": " << (asyncCompute ? "true" : "false")
+           << ",\n"
+           << "  \"dedicated_transfer\": "
+           << (dedicatedTransfer ? "true" : "false") << ",\n"
+           << "  \"present_profile\": \""
+           << vulkanUtils::to_string(settings.presentProfile) << "\",\n"
+           << "  \"triangles\": " << settings.triangleCount << ",\n"
+           << "  \"record_threads\": " << settings.recordThreads << ",\n"
+           << "  \"compile_threads\": " << settings.compileThreads << ",\n"
+           << "  \"batch_draws\": " << (settings.batchDraws ? "true" : "false")
+           << ",\n"
+           << "  \"rewrite_descriptors\": "
+           << (settings.rewriteDescriptors ? "true" : "false") << ",\n"
+           << "  \"tint\": " << (settings.tint ? "true" : "false") << ",\n"
+           << "  \"compute\": "
+           << (settings.computeInstances ? "true" : "false") << ",\n"
+           << "  \"indirect_commands\": " << batches.indirectCommands << ",\n"
+           << "  \"indirect_calls\": " << batches.indirectCalls << ",\n"
+           << "  \"shader_compiles\": " << shaders.compiles << ",\n"
+           << "  \"shader_cache_hits\": " << shaders.cacheHits << ",\n"
+           << "  \"capability_cache_hits\": " << devices.hits << ",\n"
+           << "  \"pipeline_lookups\": " << pipelines.lookups << ",\n"
+           << "  \"pipeline_compiles\": " << pipelines.compiles << ",\n"
+           << "  \"pipeline_wait_frames\": " << triangle.pipelineWaitFrames()
+           << ",\n"
+           << "  \"uploaded_bytes\": " << transfers.bytesUploaded << ",\n"
+           << "  \"upload_copies\": " << transfers.copies << ",\n"
+           << "  \"upload_submissions\": " << transfers.submissions << ",\n"
+           << "  \"frames\": " << frames.size() << ",\n";
+
+    stream << "  \"frame_time\": ";
+    write_json(stream, percentiles(frames, &FrameTimings::total)) << ",\n";
+
+    stream << "  \"fence_wait\": ";
+    write_json(stream, percentiles(frames, &FrameTimings::fenceWait)) << ",\n";
+
+    stream << "  \"acquire\": ";
+    write_json(stream, percentiles(frames, &FrameTimings::acquire)) << ",\n";
+
+    stream << "  \"image_wait\": ";
+    write_json(stream, percentiles(frames, &FrameTimings::imageWait)) << ",\n";
+
+    stream << "  \"record\": ";
+    write_json(stream, percentiles(frames, &FrameTimings::record)) << ",\n";
+
+    stream << "  \"submit\": ";
+    write_json(stream, percentiles(frames, &FrameTimings::submit)) << ",\n";
+
+    stream << "  \"present\": ";
+    write_json(stream, percentiles(frames, &FrameTimings::present)) << ",\n";
+
+    stream << "  \"stall\": ";
+    write_json(stream, percentiles(frames, &FrameTimings::stall)) << ",\n";
+
+    if(!settings.headless) {
+        auto const& config = triangle.presentConfig();
+
+        stream << "  \"present_mode\": \""
+               << vk::to_string(config.presentationMode) << "\",\n"
+               << "  \"swapchain_images\": " << config.imageCount << ",\n";
+
+        stream << "  \"present_interval\": ";
+        write_json(stream, percentiles(present_intervals(frames))) << ",\n";
+    }
+
+    stream << "  \"command_buffer_allocations\": "
+           << triangle.commandBufferAllocations() << ",\n";
+
+    stream << "  \"swapchain_recreations\": " << triangle.resizeHitches().size()
+           << ",\n";
+
+    stream << "  \"resize_hitch\": ";
+    write_json(stream, percentiles(triangle.resizeHitches())) << ",\n";
+
+    stream << "  \"gpu\": {";
+    auto separator = "\n";
+    for(auto const& [name, durations] : triangle.gpuTimer().history()) {
+        stream << separator << "    \"" << name << "\": ";
+        write_json(stream, percentiles(durations.samples()));
+        separator = ",\n";
+    }
+    stream << "\n  }\n";
+
+    stream << "}\n";
+}
+
+auto
+main(int argc, char** argv) -> int
+{
+    using namespace std::literals;
+
+    auto settings   = RenderSettings{};
+    auto outputPath = std::string{};
+
+    for(auto const* argument : gsl::make_span(argv, argc).subspan(1)) {
+        auto const arg = std::string_view{argument};
+
+        if(arg.substr(0, "--output="sv.size()) == "--output="sv) {
+            outputPath = arg.substr("--output="sv.size());
+        }
+        else if(!parse_render_setting(arg, settings)) {
+            throw std::invalid_argument("Unknown argument " + std::string{arg});
+        }
+    }
+
+    if(settings.frameCount == 0) {
+        settings.frameCount = defaultBenchFrames;
+    }
+
+    auto triangle = HelloTriangle{settings};
+    triangle.run();
+
+    if(outputPath.empty()) {
+        write_report(std::cout, triangle);
+    }
+    else {
+        auto file = std::ofstream(outputPath);
+        write_report(file, triangle);
+    }
+
+    return 0;
+}
@@ -6,5 +6,6 @@ cmake -Bbuild-release \
       -DCMAKE_BUILD_TYPE=Release
 
       #-DBUILD_TESTING=ON \
+      #-DSHADER_COMPILER=ON \
       #-G Ninja \
 
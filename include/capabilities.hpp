@@ -0,0 +1,160 @@
+#ifndef VK_TUT_CAPABILITIES_HPP
+#define VK_TUT_CAPABILITIES_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace vulkanUtils {
+
+// Everything device selection needs to know about a physical device, queried
+// once per device when the instance's devices are enumerated.
+struct DeviceInfo {
+    vk::PhysicalDevice device;
+    vk::PhysicalDeviceProperties properties;
+    vk::PhysicalDeviceFeatures features;
+    vk::PhysicalDeviceMemoryProperties memoryProperties;
+    std::vector<vk::ExtensionProperties> extensions;
+    std::vector<vk::QueueFamilyProperties> queueFamilies;
+};
+
+[[nodiscard]] auto
+query_device(vk::PhysicalDevice const& device) -> DeviceInfo;
+
+// The instance extensions and layers, enumerated once. Names are looked up
+// in hash sets rather than scanned for.
+class InstanceCapabilities {
+public:
+    InstanceCapabilities();
+
+    [[nodiscard]] auto
+    has_extension(std::string const& name) const -> bool;
+
+    [[nodiscard]] auto
+    has_layer(std::string const& name) const -> bool;
+
+    // Both print every name that is missing, not just the first.
+    [[nodiscard]] auto
+    supports_extensions(std::vector<char const*> const& names) const -> bool;
+
+    [[nodiscard]] auto
+    supports_layers(std::vector<char const*> const& names) const -> bool;
+
+private:
+    std::unordered_set<std::string> m_extensions;
+    std::unordered_set<std::string> m_layers;
+};
+
+// A snapshot of one physical device with hashed lookups. Features and limits
+// are plain structs, read straight from the snapshot.
+class DeviceCapabilities {
+public:
+    explicit DeviceCapabilities(DeviceInfo info);
+
+    [[nodiscard]] auto
+    info() const noexcept -> DeviceInfo const&;
+
+    [[nodiscard]] auto
+    limits() const noexcept -> vk::PhysicalDeviceLimits const&;
+
+    [[nodiscard]] auto
+    has_feature(vk::Bool32 vk::PhysicalDeviceFeatures::*feature) const noexcept
+            -> bool;
+
+    [[nodiscard]] auto
+    has_extension(std::string const& name) const -> bool;
+
+    // Prints the first missing extension along with the device's name.
+    [[nodiscard]] auto
+    supports_extensions(std::vector<char const*> const& names) const -> bool;
+
+    // Indices of the families supporting every one of the flags, in order.
+    // Any combination of graphics, compute, transfer and sparse binding is
+    // a single lookup, other flags are ignored.
+    [[nodiscard]] auto
+    queue_families(vk::QueueFlags flags) const
+            -> std::vector<uint32_t> const&;
+
+private:
+    DeviceInfo m_info;
+    std::unordered_set<std::string> m_extensions;
+    std::unordered_map<VkQueueFlags, std::vector<uint32_t>> m_queueFamilies;
+};
+
+// Identifies a device and the driver it runs on. A new driver version can
+// change anything the device reports, so it starts a new entry.
+struct DeviceKey {
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint32_t apiVersion;
+    std::array<uint8_t, VK_UUID_SIZE> pipelineCacheUUID;
+};
+
+[[nodiscard]] auto
+operator==(DeviceKey const& lhs, DeviceKey const& rhs) noexcept -> bool;
+
+[[nodiscard]] auto
+device_key(vk::PhysicalDeviceProperties const& properties) noexcept
+        -> DeviceKey;
+
+struct DeviceKeyHash {
+    [[nodiscard]] auto
+    operator()(DeviceKey const& key) const noexcept -> size_t;
+};
+
+struct CapabilityCacheStats {
+    bool loadedFromDisk;
+    uint32_t hits;
+    uint32_t misses;
+};
+
+auto
+operator<<(std::ostream& stream, CapabilityCacheStats const& stats)
+        -> std::ostream&;
+
+// Persists what each physical device reported, keyed by its DeviceKey. A
+// warm start only asks each device for its properties, which hold the key;
+// features, memory properties, extensions and queue families come from the
+// file. The file is rewritten whenever a device missed.
+class CapabilityCache {
+public:
+    explicit CapabilityCache(std::string filePath);
+
+    [[nodiscard]] auto
+    filePath() const noexcept -> std::string const&;
+
+    [[nodiscard]] auto
+    stats() const noexcept -> CapabilityCacheStats const&;
+
+    [[nodiscard]] auto
+    enumerate_devices(vk::Instance const& instance) -> std::vector<DeviceInfo>;
+
+    auto
+    save() const -> void;
+
+private:
+    // A DeviceInfo without the handle and properties, which are per run.
+    struct Entry {
+        vk::PhysicalDeviceFeatures features;
+        vk::PhysicalDeviceMemoryProperties memoryProperties;
+        std::vector<vk::ExtensionProperties> extensions;
+        std::vector<vk::QueueFamilyProperties> queueFamilies;
+    };
+
+    std::string const m_filePath;
+    std::unordered_map<DeviceKey, Entry, DeviceKeyHash> m_entries;
+    CapabilityCacheStats m_stats;
+
+    auto
+    load() -> void;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_CAPABILITIES_HPP
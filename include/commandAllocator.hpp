@@ -0,0 +1,59 @@
+#ifndef VK_TUT_COMMAND_ALLOCATOR_HPP
+#define VK_TUT_COMMAND_ALLOCATOR_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace vulkanUtils {
+
+// A frame's transient pool and every command buffer ever allocated from it.
+// The handles are never freed individually, they go with the pool.
+struct CommandFrame {
+    vk::UniqueCommandPool commandPool;
+    std::vector<vk::CommandBuffer> primaries;
+    std::vector<vk::CommandBuffer> secondaries;
+    size_t primariesUsed;
+    size_t secondariesUsed;
+};
+
+// Hands out command buffers from one transient pool per frame in flight.
+// Resetting a frame resets its whole pool in one call and makes all of its
+// command buffers available again, so once every frame has been as busy as
+// it gets nothing is allocated or freed anymore.
+class CommandAllocator {
+public:
+    explicit CommandAllocator(
+            vk::Device const& logicalDevice,
+            uint32_t queueFamily,
+            uint32_t framesInFlight);
+
+    [[nodiscard]] auto
+    boundDevice() const noexcept -> vk::Device const&;
+
+    // Command buffers allocated from the driver since construction.
+    [[nodiscard]] auto
+    allocationCount() const noexcept -> uint64_t;
+
+    // The frame's fence must have signalled, none of its command buffers may
+    // still be pending.
+    auto
+    reset(uint32_t frameIndex) -> void;
+
+    // The command buffer is in the initial state and only valid until the
+    // frame is reset.
+    [[nodiscard]] auto
+    allocate(uint32_t frameIndex, vk::CommandBufferLevel level)
+            -> vk::CommandBuffer;
+
+private:
+    std::vector<CommandFrame> m_frames;
+    uint64_t m_allocationCount;
+
+    std::reference_wrapper<vk::Device const> m_boundDevice;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_COMMAND_ALLOCATOR_HPP
@@ -0,0 +1,76 @@
+#ifndef VK_TUT_COMPUTE_PIPELINE_HPP
+#define VK_TUT_COMPUTE_PIPELINE_HPP
+
+#include "pipelineCache.hpp"
+#include "pipelineDescription.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <vector>
+
+namespace vulkanUtils {
+
+[[nodiscard]] auto
+create_compute_pipeline(
+        PipelineCache& pipelineCache,
+        ShaderStageDescription const& stage,
+        vk::PipelineLayout const& layout) -> vk::UniquePipeline;
+
+// Enough work groups to cover count invocations, the shader has to skip the
+// ones past the end of the last group.
+[[nodiscard]] auto constexpr group_count(
+        uint32_t const count,
+        uint32_t const groupSize) noexcept -> uint32_t
+{
+    return (count + groupSize - 1) / groupSize;
+}
+
+struct ComputeDispatch {
+    vk::Pipeline pipeline;
+    vk::PipelineLayout layout;
+
+    // Bound from set 0 onwards.
+    std::vector<vk::DescriptorSet> sets;
+    vk::Extent3D groups;
+};
+
+// Where the memory a dispatch touches was last used, and where what it
+// writes is used next. A side with no stages gets no barrier.
+struct DispatchDependencies {
+    vk::PipelineStageFlags producerStages;
+    vk::AccessFlags producerAccess;
+    vk::PipelineStageFlags consumerStages;
+    vk::AccessFlags consumerAccess;
+};
+
+// A global memory barrier, which covers every buffer without naming them and
+// is no more expensive for drivers than one barrier per buffer.
+auto
+memory_barrier(
+        vk::CommandBuffer const& commandBuffer,
+        vk::PipelineStageFlags srcStages,
+        vk::AccessFlags srcAccess,
+        vk::PipelineStageFlags dstStages,
+        vk::AccessFlags dstAccess) -> void;
+
+// Moves a colour image into the general layout storage images are accessed
+// in by compute shaders. An undefined old layout discards its contents.
+auto
+storage_image_barrier(
+        vk::CommandBuffer const& commandBuffer,
+        vk::Image const& image,
+        vk::ImageLayout oldLayout,
+        vk::PipelineStageFlags srcStages,
+        vk::AccessFlags srcAccess) -> void;
+
+// Waits for the producers, binds and dispatches, then makes the shader's
+// writes visible to the consumers. Push constants have to be pushed first.
+auto
+record_dispatch(
+        vk::CommandBuffer const& commandBuffer,
+        ComputeDispatch const& dispatch,
+        DispatchDependencies const& dependencies) -> void;
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_COMPUTE_PIPELINE_HPP
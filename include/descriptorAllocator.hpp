@@ -0,0 +1,119 @@
+#ifndef VK_TUT_DESCRIPTOR_ALLOCATOR_HPP
+#define VK_TUT_DESCRIPTOR_ALLOCATOR_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace vulkanUtils {
+
+// Descriptors of a type reserved per set when sizing a pool.
+struct DescriptorPoolRatio {
+    vk::DescriptorType type;
+    float perSet;
+};
+
+[[nodiscard]] auto
+default_pool_ratios() -> std::vector<DescriptorPoolRatio>;
+
+struct DescriptorStats {
+    uint32_t pools;
+    uint64_t poolAllocations;
+    uint64_t reusedSets;
+    uint64_t poolResets;
+};
+
+auto
+operator<<(std::ostream& stream, DescriptorStats const& stats)
+        -> std::ostream&;
+
+// Allocates long lived descriptor sets from pools that are added as the
+// previous ones run out, each twice the size of the last. Sets are never
+// freed back to a pool; released sets are kept per layout and handed out
+// again for the same layout, so the pools never fragment.
+class DescriptorAllocator {
+public:
+    static uint32_t constexpr defaultSetsPerPool = 64;
+    static uint32_t constexpr maxSetsPerPool     = 4096;
+
+    explicit DescriptorAllocator(
+            vk::Device const& logicalDevice,
+            uint32_t setsPerPool                    = defaultSetsPerPool,
+            std::vector<DescriptorPoolRatio> ratios = default_pool_ratios());
+
+    [[nodiscard]] auto
+    boundDevice() const noexcept -> vk::Device const&;
+
+    [[nodiscard]] auto
+    stats() const -> DescriptorStats;
+
+    [[nodiscard]] auto
+    allocate(vk::DescriptorSetLayout const& layout) -> vk::DescriptorSet;
+
+    // The GPU must be done with the set.
+    auto
+    release(vk::DescriptorSetLayout const& layout, vk::DescriptorSet set)
+            -> void;
+
+private:
+    std::vector<DescriptorPoolRatio> const m_ratios;
+    uint32_t m_nextPoolSize;
+
+    mutable std::mutex m_mutex;
+    std::vector<vk::UniqueDescriptorPool> m_pools;
+    std::unordered_map<VkDescriptorSetLayout, std::vector<vk::DescriptorSet>>
+            m_released;
+    DescriptorStats m_stats;
+
+    std::reference_wrapper<vk::Device const> const m_boundDevice;
+};
+
+// A frame's pools and how many of them are in use.
+struct DescriptorFrame {
+    std::vector<vk::UniqueDescriptorPool> pools;
+    size_t current;
+};
+
+// Linear descriptor set allocation for sets that only live for one frame.
+// Every frame in flight has its own pools, which are reset as a whole once
+// the frame's fence has signalled instead of freeing sets one at a time.
+class FrameDescriptorAllocator {
+public:
+    explicit FrameDescriptorAllocator(
+            vk::Device const& logicalDevice,
+            uint32_t framesInFlight,
+            uint32_t setsPerPool = DescriptorAllocator::defaultSetsPerPool,
+            std::vector<DescriptorPoolRatio> ratios = default_pool_ratios());
+
+    [[nodiscard]] auto
+    boundDevice() const noexcept -> vk::Device const&;
+
+    [[nodiscard]] auto
+    stats() const noexcept -> DescriptorStats const&;
+
+    // The frame's fence must have signalled.
+    auto
+    reset(uint32_t frameIndex) -> void;
+
+    // The set is only valid until the frame is reset.
+    [[nodiscard]] auto
+    allocate(uint32_t frameIndex, vk::DescriptorSetLayout const& layout)
+            -> vk::DescriptorSet;
+
+private:
+    std::vector<DescriptorPoolRatio> const m_ratios;
+    uint32_t const m_setsPerPool;
+
+    std::vector<DescriptorFrame> m_frames;
+    DescriptorStats m_stats;
+
+    std::reference_wrapper<vk::Device const> const m_boundDevice;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_DESCRIPTOR_ALLOCATOR_HPP
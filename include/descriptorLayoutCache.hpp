@@ -0,0 +1,61 @@
+#ifndef VK_TUT_DESCRIPTOR_LAYOUT_CACHE_HPP
+#define VK_TUT_DESCRIPTOR_LAYOUT_CACHE_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace vulkanUtils {
+
+// Bindings sorted by binding number, so that the same set of bindings always
+// makes the same key.
+struct DescriptorLayoutKey {
+    std::vector<vk::DescriptorSetLayoutBinding> bindings;
+};
+
+[[nodiscard]] auto
+operator==(DescriptorLayoutKey const& lhs, DescriptorLayoutKey const& rhs)
+        -> bool;
+
+[[nodiscard]] auto
+make_layout_key(std::vector<vk::DescriptorSetLayoutBinding> bindings)
+        -> DescriptorLayoutKey;
+
+struct DescriptorLayoutKeyHash {
+    [[nodiscard]] auto
+    operator()(DescriptorLayoutKey const& key) const noexcept -> size_t;
+};
+
+// Creates each distinct descriptor set layout once. Layouts handed out stay
+// valid for the lifetime of the cache, so they double as keys elsewhere.
+class DescriptorLayoutCache {
+public:
+    explicit DescriptorLayoutCache(vk::Device const& logicalDevice);
+
+    [[nodiscard]] auto
+    boundDevice() const noexcept -> vk::Device const&;
+
+    [[nodiscard]] auto
+    size() const -> size_t;
+
+    [[nodiscard]] auto
+    get(std::vector<vk::DescriptorSetLayoutBinding> bindings)
+            -> vk::DescriptorSetLayout;
+
+private:
+    mutable std::mutex m_mutex;
+    std::unordered_map<
+            DescriptorLayoutKey,
+            vk::UniqueDescriptorSetLayout,
+            DescriptorLayoutKeyHash>
+            m_layouts;
+
+    std::reference_wrapper<vk::Device const> const m_boundDevice;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_DESCRIPTOR_LAYOUT_CACHE_HPP
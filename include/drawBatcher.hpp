@@ -0,0 +1,116 @@
+#ifndef VK_TUT_DRAW_BATCHER_HPP
+#define VK_TUT_DRAW_BATCHER_HPP
+
+#include "memoryAllocator.hpp"
+#include "meshBuffer.hpp"
+#include "vertexLayout.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace vulkanUtils {
+
+// A range of a mesh's indices, drawn once per submitted instance.
+struct SubMesh {
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+};
+
+// A frame's packed instance data and indirect commands, both host visible.
+struct BatchBuffers {
+    AllocatedBuffer instances;
+    AllocatedBuffer commands;
+};
+
+struct QueuedDraw {
+    vk::Pipeline pipeline;
+    MeshBuffer const* mesh;
+    SubMesh subMesh;
+    InstanceTransform instance;
+};
+
+// A run of indirect commands sharing a pipeline and mesh.
+struct IndirectBatch {
+    vk::Pipeline pipeline;
+    MeshBuffer const* mesh;
+    uint32_t firstCommand;
+    uint32_t commandCount;
+};
+
+// Sorts the draws and merges runs of identical geometry into instanced
+// commands, whose instances are the sorted draws' positions. Replaces the
+// contents of commands and batches.
+auto
+build_batches(
+        std::vector<QueuedDraw>& draws,
+        std::vector<vk::DrawIndexedIndirectCommand>& commands,
+        std::vector<IndirectBatch>& batches) -> void;
+
+struct DrawBatchStats {
+    uint32_t draws;
+    uint32_t indirectCommands;
+    uint32_t indirectCalls;
+};
+
+// Collects a frame's draws and turns them into as few indirect draws as
+// possible. Draws are sorted by pipeline, mesh and sub-mesh; every run of
+// identical geometry becomes one instanced indirect command, and every run
+// of commands sharing a pipeline and mesh is issued by one
+// drawIndexedIndirect call. Instance data is packed into a host visible
+// buffer per frame in flight, bound at binding 1.
+class DrawBatcher {
+public:
+    explicit DrawBatcher(
+            vk::Device const& logicalDevice,
+            MemoryAllocator& allocator,
+            vk::PhysicalDeviceFeatures const& features,
+            uint32_t framesInFlight,
+            uint32_t maxDraws);
+
+    [[nodiscard]] auto
+    boundDevice() const noexcept -> vk::Device const&;
+
+    // Of the last recorded frame.
+    [[nodiscard]] auto
+    stats() const noexcept -> DrawBatchStats const&;
+
+    auto
+    add(vk::Pipeline const& pipeline,
+        MeshBuffer const& mesh,
+        SubMesh const& subMesh,
+        InstanceTransform const& instance) -> void;
+
+    // Packs the frame's buffers, whose previous use must have retired, and
+    // records the draws inside a render pass with viewport and scissor set.
+    // Clears the collected draws.
+    auto
+    record(vk::CommandBuffer const& commandBuffer, uint32_t frameIndex)
+            -> void;
+
+private:
+    uint32_t const m_maxDraws;
+    bool const m_multiDrawIndirect;
+    bool const m_indirectFirstInstance;
+
+    std::vector<BatchBuffers> const m_frames;
+    std::vector<QueuedDraw> m_draws;
+    std::vector<vk::DrawIndexedIndirectCommand> m_commands;
+    std::vector<IndirectBatch> m_batches;
+    DrawBatchStats m_stats;
+
+    std::reference_wrapper<vk::Device const> const m_boundDevice;
+
+    auto
+    record_indirect(
+            vk::CommandBuffer const& commandBuffer,
+            BatchBuffers const& frame,
+            uint32_t firstCommand,
+            uint32_t commandCount) -> void;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_DRAW_BATCHER_HPP
@@ -0,0 +1,90 @@
+#ifndef VK_TUT_FRAME_RING_HPP
+#define VK_TUT_FRAME_RING_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace vulkanUtils {
+
+// Everything a single frame in flight owns while the GPU works on it.
+struct FrameContext {
+    vk::UniqueSemaphore imageAvailable;
+    vk::UniqueSemaphore renderFinished;
+    vk::UniqueFence inFlight;
+};
+
+// Ring of frame contexts with a runtime depth. Alongside the ring it tracks
+// which frame last rendered into each target image, so that the CPU only
+// blocks on an image when an older frame is still using it.
+class FrameRing {
+public:
+    explicit FrameRing(
+            vk::Device const& logicalDevice,
+            uint32_t depth,
+            size_t imageCount);
+
+    [[nodiscard]] auto
+    boundDevice() const noexcept -> vk::Device const&;
+
+    [[nodiscard]] auto
+    depth() const noexcept -> uint32_t;
+
+    [[nodiscard]] auto
+    currentIndex() const noexcept -> uint32_t;
+
+    [[nodiscard]] auto
+    current() const noexcept -> FrameContext const&;
+
+    // Number of frames advanced past since construction.
+    [[nodiscard]] auto
+    frameNumber() const noexcept -> uint64_t;
+
+    // Blocks until the current frame's previous submission has retired.
+    auto
+    wait_for_current() const -> void;
+
+    // Blocks until no other frame is rendering into the image, then marks the
+    // image as owned by the current frame.
+    auto
+    claim_image(uint32_t imageIndex) -> void;
+
+    auto
+    advance() noexcept -> void;
+
+    // Forgets image ownership, e.g. after the target images were recreated.
+    auto
+    reset_images(size_t imageCount) -> void;
+
+private:
+    std::vector<FrameContext> const m_frames;
+    std::vector<vk::Fence> m_imagesInFlight;
+    uint32_t m_current;
+    uint64_t m_frameNumber;
+
+    std::reference_wrapper<vk::Device const> const m_boundDevice;
+};
+
+// Destroys everything retired whose releaseFrame, a FrameRing frame number,
+// has been reached.
+template<typename Retired>
+auto
+release_retired(std::vector<Retired>& retired, uint64_t const frameNumber)
+        -> void
+{
+    auto const released = std::remove_if(
+            std::begin(retired),
+            std::end(retired),
+            [frameNumber](Retired const& resources) {
+                return resources.releaseFrame <= frameNumber;
+            });
+
+    retired.erase(released, std::end(retired));
+}
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_FRAME_RING_HPP
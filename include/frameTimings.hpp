@@ -0,0 +1,55 @@
+#ifndef VK_TUT_FRAME_TIMINGS_HPP
+#define VK_TUT_FRAME_TIMINGS_HPP
+
+#include <chrono>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace vulkanUtils {
+
+// CPU time spent in each step of drawing a single frame.
+struct FrameTimings {
+    std::chrono::nanoseconds fenceWait;
+    std::chrono::nanoseconds acquire;
+    std::chrono::nanoseconds imageWait;
+    std::chrono::nanoseconds record;
+    std::chrono::nanoseconds submit;
+    std::chrono::nanoseconds present;
+
+    // Time the CPU was blocked on the GPU, the fence and image waits combined.
+    std::chrono::nanoseconds stall;
+    std::chrono::nanoseconds total;
+
+    // Time since the previous frame was handed to the presentation engine,
+    // zero for frames that were not presented.
+    std::chrono::nanoseconds presentInterval;
+};
+
+struct TimingPercentiles {
+    double p50Ms;
+    double p95Ms;
+    double p99Ms;
+    double meanMs;
+    double maxMs;
+};
+
+[[nodiscard]] auto
+percentiles(std::vector<std::chrono::nanoseconds> samples) -> TimingPercentiles;
+
+[[nodiscard]] auto
+percentiles(
+        std::vector<FrameTimings> const& frames,
+        std::chrono::nanoseconds FrameTimings::*step) -> TimingPercentiles;
+
+auto
+write_json(std::ostream& stream, TimingPercentiles const& timings)
+        -> std::ostream&;
+
+// Writes value as a quoted JSON string, escaping what JSON requires.
+auto
+write_json(std::ostream& stream, std::string_view value) -> std::ostream&;
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_FRAME_TIMINGS_HPP
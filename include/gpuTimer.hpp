@@ -0,0 +1,122 @@
+#ifndef VK_TUT_GPU_TIMER_HPP
+#define VK_TUT_GPU_TIMER_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vulkanUtils {
+
+// Fixed capacity history of GPU durations, oldest samples are overwritten.
+class DurationRing {
+public:
+    explicit DurationRing(size_t capacity);
+
+    auto
+    push(std::chrono::nanoseconds duration) -> void;
+
+    [[nodiscard]] auto
+    latest() const noexcept -> std::chrono::nanoseconds;
+
+    [[nodiscard]] auto
+    samples() const -> std::vector<std::chrono::nanoseconds>;
+
+    [[nodiscard]] auto
+    size() const noexcept -> size_t;
+
+private:
+    std::vector<std::chrono::nanoseconds> m_samples;
+    size_t m_next;
+    size_t m_size;
+};
+
+// Timestamp queries bracketing named scopes inside command buffers. There is
+// one query pool per frame in flight; a frame's results are read back without
+// blocking once its fence has signalled, by calling collect() before the
+// frame's command buffer is recorded again.
+class GpuTimer {
+public:
+    class Scope {
+    public:
+        Scope(GpuTimer& timer,
+              vk::CommandBuffer const& commandBuffer,
+              uint32_t query) noexcept;
+
+        Scope(Scope&&)      = delete;
+        Scope(Scope const&) = delete;
+        auto
+        operator=(Scope&&) = delete;
+        auto
+        operator=(Scope const&) = delete;
+
+        ~Scope();
+
+    private:
+        std::reference_wrapper<GpuTimer> const m_timer;
+        vk::CommandBuffer const m_commandBuffer;
+        uint32_t const m_query;
+    };
+
+    static uint32_t constexpr defaultMaxScopes      = 32;
+    static size_t constexpr defaultHistoryCapacity = 1024;
+
+    explicit GpuTimer(
+            vk::Device const& logicalDevice,
+            vk::PhysicalDeviceLimits const& limits,
+            vk::QueueFamilyProperties const& queueFamily,
+            uint32_t framesInFlight,
+            uint32_t maxScopes     = defaultMaxScopes,
+            size_t historyCapacity = defaultHistoryCapacity);
+
+    [[nodiscard]] auto
+    boundDevice() const noexcept -> vk::Device const&;
+
+    [[nodiscard]] auto
+    supported() const noexcept -> bool;
+
+    auto
+    collect(uint32_t frameIndex) -> void;
+
+    auto
+    begin_frame(vk::CommandBuffer const& commandBuffer, uint32_t frameIndex)
+            -> void;
+
+    [[nodiscard]] auto
+    scope(vk::CommandBuffer const& commandBuffer, std::string_view name)
+            -> Scope;
+
+    [[nodiscard]] auto
+    history() const noexcept -> std::map<std::string, DurationRing> const&;
+
+private:
+    static uint32_t constexpr noQuery = ~0u;
+
+    double const m_timestampPeriod;
+    uint64_t const m_timestampMask;
+    uint32_t const m_maxScopes;
+    size_t const m_historyCapacity;
+
+    std::vector<vk::UniqueQueryPool> const m_queryPools;
+    std::vector<std::vector<std::string>> m_frameScopes;
+    std::vector<uint64_t> m_results;
+
+    uint32_t m_currentFrame;
+    std::map<std::string, DurationRing> m_history;
+
+    std::reference_wrapper<vk::Device const> const m_boundDevice;
+
+    auto
+    write_timestamp(
+            vk::CommandBuffer const& commandBuffer,
+            vk::PipelineStageFlagBits stage,
+            uint32_t query) -> void;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_GPU_TIMER_HPP
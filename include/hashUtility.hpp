@@ -0,0 +1,42 @@
+#ifndef VK_TUT_HASH_UTILITY_HPP
+#define VK_TUT_HASH_UTILITY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace vulkanUtils {
+
+[[nodiscard]] inline auto
+hash_combine(size_t const seed, size_t const value) noexcept -> size_t
+{
+    return seed ^ (value + 0x9e3779b9u + (seed << 6u) + (seed >> 2u));
+}
+
+// Stable across runs and platforms, unlike std::hash, so it can name data
+// that is written to disk. Pass a previous result as the seed to continue it.
+[[nodiscard]] inline auto
+fnv1a(void const* const data,
+      size_t const size,
+      uint64_t hash = uint64_t{14695981039346656037u}) noexcept -> uint64_t
+{
+    auto const* const bytes = static_cast<unsigned char const*>(data);
+    for(auto i = size_t{0}; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * uint64_t{1099511628211u};
+    }
+
+    return hash;
+}
+
+// Folds the std::hash of each value into the seed, in order.
+template<typename... Values>
+[[nodiscard]] auto
+hash_values(size_t seed, Values const&... values) noexcept -> size_t
+{
+    ((seed = hash_combine(seed, std::hash<Values>{}(values))), ...);
+    return seed;
+}
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_HASH_UTILITY_HPP
@@ -5,29 +5,94 @@
 #include "surface.hpp"
 #include "vulkanUtility.hpp"
 #include "shaderUtility.hpp"
+#include "shaderCompiler.hpp"
+#include "shaderWatcher.hpp"
 #include "instance.hpp"
 #include "loaderDispatcher.hpp"
 #include "debugMessenger.hpp"
 #include "physicalDevice.hpp"
+#include "pipelineCache.hpp"
+#include "pipelineRegistry.hpp"
+#include "memoryAllocator.hpp"
+#include "transferBatch.hpp"
+#include "meshBuffer.hpp"
+#include "vertexLayout.hpp"
+#include "parallelRecorder.hpp"
+#include "commandAllocator.hpp"
+#include "drawBatcher.hpp"
+#include "descriptorLayoutCache.hpp"
+#include "pipelineLayoutCache.hpp"
+#include "descriptorAllocator.hpp"
+#include "uniformRing.hpp"
+#include "offscreenTarget.hpp"
+#include "renderSettings.hpp"
+#include "frameTimings.hpp"
+#include "gpuTimer.hpp"
+#include "frameRing.hpp"
+#include "swapchain.hpp"
+#include "presentPolicy.hpp"
 
 #include <vulkan/vulkan.hpp>
 #include <GLFW/glfw3.h>
 
+#include <chrono>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <stdexcept>
+#include <string>
 #include <cstdlib>
 
-static int constexpr maxFramesInFlight{2};
-using SemaphoreArray   = std::array<vk::UniqueSemaphore, maxFramesInFlight>;
-using MemoryFenceArray = std::array<vk::UniqueFence, maxFramesInFlight>;
+// Matches the Frame uniform block in triangle.vert.
+struct FrameUniforms {
+    glm::vec2 scale;
+    glm::vec2 offset;
+};
+
+// Matches the Draw push constant block in triangle.vert.
+struct DrawConstants {
+    glm::vec4 tint;
+};
+
+// Matches the Animation push constant block in instances.comp.
+struct AnimationConstants {
+    float time;
+    uint32_t count;
+};
+
+// The compute pass moving the triangles around their cells. It reads the
+// uploaded instances and writes the ones that are drawn.
+struct InstanceAnimation {
+    shaderUtils::ComputeShader shader;
+    vulkanUtils::AllocatedBuffer animated;
+    vk::PipelineLayout layout;
+    vk::UniquePipeline pipeline;
+    vk::DescriptorSet set;
+};
+
+struct RecordedFrame {
+    vk::CommandBuffer commandBuffer;
+
+    // Has to be waited on before uploaded buffers are read, null if nothing
+    // was uploaded for the frame.
+    vk::Semaphore uploaded;
+};
 
 class HelloTriangle {
 public:
-    static int constexpr width  = 800;
-    static int constexpr height = 600;
+    static auto constexpr pipelineCachePath   = "pipeline_cache.bin";
+    static auto constexpr capabilityCachePath = "capabilities.bin";
+
+    explicit HelloTriangle(RenderSettings settings = {});
+
+    HelloTriangle(HelloTriangle&&)      = delete;
+    HelloTriangle(HelloTriangle const&) = delete;
+    auto
+    operator=(HelloTriangle&&) = delete;
+    auto
+    operator=(HelloTriangle const&) = delete;
 
-    HelloTriangle();
+    ~HelloTriangle();
 
     auto
     run() -> void
@@ -36,69 +101,174 @@ public:
         cleanup();
     }
 
+    [[nodiscard]] auto
+    settings() const noexcept -> RenderSettings const&;
+
+    [[nodiscard]] auto
+    deviceName() const -> std::string;
+
+    [[nodiscard]] auto
+    frameTimings() const noexcept
+            -> std::vector<vulkanUtils::FrameTimings> const&;
+
+    [[nodiscard]] auto
+    gpuTimer() const noexcept -> vulkanUtils::GpuTimer const&;
+
+    [[nodiscard]] auto
+    queueTopology() const noexcept -> vulkanUtils::QueueTopology const&;
+
+    [[nodiscard]] auto
+    transferQueue() const noexcept -> vk::Queue const&;
+
+    [[nodiscard]] auto
+    computeQueue() const noexcept -> vk::Queue const&;
+
+    [[nodiscard]] auto
+    transferStats() const noexcept -> vulkanUtils::TransferStats const&;
+
+    // Command buffers allocated from the driver, flat once warmed up.
+    [[nodiscard]] auto
+    commandBufferAllocations() const -> uint64_t;
+
+    [[nodiscard]] auto
+    pipelineRegistryStats() const -> vulkanUtils::PipelineRegistryStats;
+
+    [[nodiscard]] auto
+    shaderCompileStats() const noexcept
+            -> shaderUtils::ShaderCompileStats const&;
+
+    [[nodiscard]] auto
+    capabilityCacheStats() const noexcept
+            -> vulkanUtils::CapabilityCacheStats const&;
+
+    // Frames recorded without draws while their pipeline was compiling.
+    [[nodiscard]] auto
+    pipelineWaitFrames() const noexcept -> uint32_t;
+
+    // Empty unless draws are batched.
+    [[nodiscard]] auto
+    drawBatchStats() const noexcept -> vulkanUtils::DrawBatchStats;
+
+    [[nodiscard]] auto
+    presentConfig() const noexcept -> vulkanUtils::PresentConfig const&;
+
+    // Time each swapchain recreation held up the frame that triggered it.
+    [[nodiscard]] auto
+    resizeHitches() const noexcept
+            -> std::vector<std::chrono::nanoseconds> const&;
+
 private:
+    RenderSettings const m_settings;
+
     glfwUtils::UniqueWindow const m_window;
 
     std::vector<char const*> const m_validationLayers{
             "VK_LAYER_KHRONOS_validation"};
     std::vector<char const*> const m_extensions;
 
+    vulkanUtils::InstanceCapabilities const m_instanceCapabilities;
     vulkanUtils::Instance const m_instance;
 
     vulkanUtils::DynamicFuncDispatcher const m_dynamicFuncDispatcher;
     vulkanUtils::DebugMessenger const m_debugMessenger;
 
-    std::vector<char const*> const m_deviceExtensions{
-            VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+    std::vector<char const*> const m_deviceExtensions;
+    vulkanUtils::CapabilityCache m_capabilityCache;
     vulkanUtils::PhysicalDevice const m_physicalDevice;
 
-    vulkanUtils::Surface const m_surface;
+    std::optional<vulkanUtils::Surface> const m_surface;
     vk::SurfaceCapabilitiesKHR const m_surfaceCaps;
 
     std::vector<vk::SurfaceFormatKHR> const m_surfaceFormats;
-    vk::SurfaceFormatKHR const m_chosenSurfaceFormat;
+    std::vector<vk::SurfaceFormatKHR> const m_requestedSurfaceFormats{
+            vulkanUtils::defaultSurfaceFormat};
+    vk::SurfaceFormatKHR m_chosenSurfaceFormat;
+
+    vulkanUtils::PresentPolicy const m_presentPolicy;
+    vulkanUtils::PresentConfig m_presentConfig;
 
     vulkanUtils::QueueFamily const m_graphicsQueues;
     vulkanUtils::QueueFamily const m_presentationQueues;
-    std::vector<float> const m_queuePriorities;
+    vulkanUtils::QueueTopology const m_queueTopology;
     std::vector<uint32_t> const m_queueIndicies;
 
     vk::UniqueDevice const m_logicalDevice;
     vk::Queue const m_graphicsQueue;
     vk::Queue const m_presentQueue;
+    vk::Queue const m_transferQueue;
+    vk::Queue const m_computeQueue;
 
-    std::vector<vk::SurfaceFormatKHR> const m_requestedSurfaceFormats{
-            vulkanUtils::defaultSurfaceFormat};
-    std::vector<vk::PresentModeKHR> const m_requestedPresentationModes{
-            vk::PresentModeKHR::eFifoRelaxed,
-            vk::PresentModeKHR::eFifo};
+    vulkanUtils::PipelineCache m_pipelineCache;
+    vulkanUtils::MemoryAllocator m_allocator;
 
-    shaderUtils::VertexShader const m_vertShader;
-    shaderUtils::FragmentShader const m_fragShader;
+    vulkanUtils::DescriptorLayoutCache m_descriptorLayouts;
+    vulkanUtils::PipelineLayoutCache m_pipelineLayouts;
+    vulkanUtils::DescriptorAllocator m_descriptors;
+    vulkanUtils::FrameDescriptorAllocator m_frameDescriptors;
 
-    vk::PipelineColorBlendAttachmentState const m_colourBlendAttatchment;
-    vk::PipelineColorBlendStateCreateInfo const m_colourBlendState;
+    vulkanUtils::UniformRing m_uniforms;
+    vk::DescriptorSetLayout const m_frameSetLayout;
+    vk::DescriptorSet const m_frameSet;
 
-    vk::UniquePipelineLayout const m_pipelineLayout;
-    vk::UniqueCommandPool const m_commandPool;
+    vulkanUtils::TransferBatch m_transfers;
+    vulkanUtils::MeshBuffer const m_triangleMesh;
+    std::vector<vulkanUtils::InstanceTransform> const m_instances;
+    vulkanUtils::AllocatedBuffer const m_instanceBuffer;
+    std::vector<vk::DrawIndexedIndirectCommand> const m_drawList;
 
-    SemaphoreArray const m_imageAvailableSignals;
-    SemaphoreArray const m_renderFinishedSignals;
-    MemoryFenceArray const m_memoryFences;
+    shaderUtils::ShaderCompiler m_shaderCompiler;
+    shaderUtils::ShaderModuleCache m_shaderModules;
+    shaderUtils::VertexShader m_vertShader;
+    shaderUtils::FragmentShader m_fragShader;
+    std::optional<shaderUtils::ShaderWatcher> m_shaderWatcher;
 
+    vk::PipelineLayout const m_pipelineLayout;
+    vulkanUtils::PipelineRegistry m_pipelines;
+    std::optional<InstanceAnimation> m_animation;
+    vulkanUtils::CommandAllocator m_commands;
+
+    std::optional<vulkanUtils::OffscreenTarget> const m_offscreenTarget;
+
+    vk::Extent2D m_swapChainExtent;
     vk::UniqueSwapchainKHR m_swapChain;
     std::vector<vk::Image> m_swapChainImages;
     std::vector<vk::UniqueImageView> m_imageViews;
 
     vk::UniqueRenderPass m_renderPass;
-    vk::UniquePipeline m_graphicsPipeline;
+    vulkanUtils::PendingPipeline m_graphicsPipeline;
 
     std::vector<vk::UniqueFramebuffer> m_framebuffers;
-    std::vector<vk::UniqueCommandBuffer> m_commandBuffers;
+    std::vector<vulkanUtils::RetiredSwapchain> m_retiredSwapchains;
+    std::vector<vulkanUtils::RetiredPipelines> m_retiredPipelines;
+    bool m_swapchainStale;
+
+    vulkanUtils::FrameRing m_frames;
+    std::optional<vulkanUtils::ParallelRecorder> m_recorder;
+    std::optional<vulkanUtils::DrawBatcher> m_batcher;
+    vulkanUtils::GpuTimer m_gpuTimer;
+
+    std::vector<vulkanUtils::FrameTimings> m_frameTimings;
+    std::vector<std::chrono::nanoseconds> m_resizeHitches;
+    uint32_t m_pipelineWaitFrames;
+
+    [[nodiscard]] auto
+    recreate_swapchain() -> bool;
+
+    auto
+    hot_reload() -> void;
+
+    [[nodiscard]] auto
+    record_frame(uint32_t frameIndex, uint32_t imageIndex) -> RecordedFrame;
 
     auto
     main_loop() -> void;
 
+    auto
+    window_loop() -> void;
+
+    auto
+    offscreen_loop() -> void;
+
     static auto
     cleanup() -> void;
 };
@@ -1,15 +1,20 @@
 #ifndef VK_TUT_INSTANCE_HPP
 #define VK_TUT_INSTANCE_HPP
 
+#include "capabilities.hpp"
+
 #include <vulkan/vulkan.hpp>
 
 #include <vector>
 #include <string_view>
 
 namespace vulkanUtils {
+// Throws before creating the instance if capabilities lacks any of the
+// layers or extensions, naming every one that is missing.
 class Instance {
 public:
     explicit Instance(
+            InstanceCapabilities const& capabilities,
             std::vector<char const*> validationLayers,
             std::vector<char const*> extensions);
 
@@ -0,0 +1,182 @@
+#ifndef VK_TUT_MEMORY_ALLOCATOR_HPP
+#define VK_TUT_MEMORY_ALLOCATOR_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace vulkanUtils {
+
+// Buffers and linearly tiled images have to be kept bufferImageGranularity
+// apart from optimally tiled images in the same block.
+enum class ResourceKind { Linear, Optimal };
+
+enum class AllocationStrategy {
+    // Long lived resources. Freed ranges are merged with their neighbours
+    // and reused by the best fitting later allocation.
+    FreeList,
+    // Short lived resources, bumped off the end of a block and only
+    // reclaimed all at once by MemoryAllocator::reset_linear.
+    Linear
+};
+
+class MemoryAllocator;
+class MemoryBlock;
+
+// A range of a memory block, handed back to the allocator when destroyed.
+class Allocation {
+public:
+    Allocation() noexcept = default;
+
+    Allocation(Allocation&& other) noexcept;
+    Allocation(Allocation const&) = delete;
+    auto
+    operator=(Allocation&& other) noexcept -> Allocation&;
+    auto
+    operator=(Allocation const&) = delete;
+
+    ~Allocation();
+
+    [[nodiscard]] auto
+    memory() const noexcept -> vk::DeviceMemory;
+
+    [[nodiscard]] auto
+    offset() const noexcept -> vk::DeviceSize;
+
+    [[nodiscard]] auto
+    size() const noexcept -> vk::DeviceSize;
+
+    // Persistently mapped pointer to the range, null unless the memory is
+    // host visible.
+    [[nodiscard]] auto
+    mapped() const noexcept -> void*;
+
+private:
+    friend class MemoryAllocator;
+
+    explicit Allocation(
+            MemoryAllocator* allocator,
+            MemoryBlock* block,
+            vk::DeviceSize offset,
+            vk::DeviceSize size,
+            uint64_t generation) noexcept;
+
+    auto
+    release() noexcept -> void;
+
+    MemoryAllocator* m_allocator = nullptr;
+    MemoryBlock* m_block         = nullptr;
+    vk::DeviceSize m_offset      = 0;
+    vk::DeviceSize m_size        = 0;
+    uint64_t m_generation        = 0;
+};
+
+// The allocation is declared first so that the resource is destroyed before
+// its memory is handed back.
+struct AllocatedBuffer {
+    Allocation allocation;
+    vk::UniqueBuffer buffer;
+};
+
+struct AllocatedImage {
+    Allocation allocation;
+    vk::UniqueImage image;
+};
+
+struct HeapStats {
+    vk::DeviceSize heapSize;
+    vk::DeviceSize reservedBytes;
+    vk::DeviceSize usedBytes;
+    uint32_t blockCount;
+    uint32_t allocationCount;
+};
+
+struct MemoryStats {
+    // Indexed by memory heap.
+    std::vector<HeapStats> heaps;
+};
+
+auto
+operator<<(std::ostream& stream, MemoryStats const& stats) -> std::ostream&;
+
+// Reserves large blocks of device memory per memory type and sub-allocates
+// resources from them, so that vkAllocateMemory is called once per block
+// instead of once per resource. Blocks of host visible memory stay mapped.
+class MemoryAllocator {
+public:
+    static auto constexpr defaultBlockSize = vk::DeviceSize{64} * 1024 * 1024;
+
+    explicit MemoryAllocator(
+            vk::Device const& logicalDevice,
+            vk::PhysicalDeviceMemoryProperties const& memoryProperties,
+            vk::PhysicalDeviceLimits const& limits,
+            vk::DeviceSize blockSize = defaultBlockSize);
+
+    MemoryAllocator(MemoryAllocator&&)      = delete;
+    MemoryAllocator(MemoryAllocator const&) = delete;
+    auto
+    operator=(MemoryAllocator&&) = delete;
+    auto
+    operator=(MemoryAllocator const&) = delete;
+
+    ~MemoryAllocator();
+
+    [[nodiscard]] auto
+    boundDevice() const noexcept -> vk::Device const&;
+
+    [[nodiscard]] auto
+    allocate(
+            vk::MemoryRequirements const& requirements,
+            vk::MemoryPropertyFlags properties,
+            ResourceKind kind,
+            AllocationStrategy strategy = AllocationStrategy::FreeList)
+            -> Allocation;
+
+    [[nodiscard]] auto
+    create_buffer(
+            vk::BufferCreateInfo const& createInfo,
+            vk::MemoryPropertyFlags properties,
+            AllocationStrategy strategy = AllocationStrategy::FreeList)
+            -> AllocatedBuffer;
+
+    [[nodiscard]] auto
+    create_image(
+            vk::ImageCreateInfo const& createInfo,
+            vk::MemoryPropertyFlags properties) -> AllocatedImage;
+
+    // Reclaims every linear allocation at once. The GPU must be done with
+    // all of them; handles that outlive the reset become no-ops.
+    auto
+    reset_linear() -> void;
+
+    [[nodiscard]] auto
+    stats() const -> MemoryStats;
+
+private:
+    friend class Allocation;
+
+    vk::PhysicalDeviceMemoryProperties const m_memoryProperties;
+    vk::DeviceSize const m_bufferImageGranularity;
+    vk::DeviceSize const m_blockSize;
+
+    mutable std::mutex m_mutex;
+    // Indexed by memory type.
+    std::vector<std::vector<std::unique_ptr<MemoryBlock>>> m_blocks;
+
+    std::reference_wrapper<vk::Device const> const m_boundDevice;
+
+    [[nodiscard]] auto
+    block_size(uint32_t memoryType) const noexcept -> vk::DeviceSize;
+
+    auto
+    free(MemoryBlock& block, vk::DeviceSize offset, uint64_t generation)
+            -> void;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_MEMORY_ALLOCATOR_HPP
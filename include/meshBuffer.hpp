@@ -0,0 +1,77 @@
+#ifndef VK_TUT_MESH_BUFFER_HPP
+#define VK_TUT_MESH_BUFFER_HPP
+
+#include "memoryAllocator.hpp"
+#include "transferBatch.hpp"
+
+#include <vulkan/vulkan.hpp>
+#include <gsl/gsl>
+
+#include <vector>
+
+namespace vulkanUtils {
+
+template<typename Vertex>
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+// Creates a device local buffer with the given usage and queues the data to
+// be copied into it.
+[[nodiscard]] auto
+upload_buffer(
+        MemoryAllocator& allocator,
+        TransferBatch& transfers,
+        gsl::span<std::byte const> data,
+        vk::BufferUsageFlags usage) -> AllocatedBuffer;
+
+// Device local vertex and index buffers, filled through a TransferBatch.
+// Nothing may be drawn with them before the batch's next submission has been
+// acquired by the graphics queue.
+class MeshBuffer {
+public:
+    explicit MeshBuffer(
+            MemoryAllocator& allocator,
+            TransferBatch& transfers,
+            gsl::span<std::byte const> vertexData,
+            gsl::span<uint32_t const> indices);
+
+    [[nodiscard]] auto
+    vertexBuffer() const noexcept -> vk::Buffer const&;
+
+    [[nodiscard]] auto
+    indexBuffer() const noexcept -> vk::Buffer const&;
+
+    [[nodiscard]] auto
+    indexCount() const noexcept -> uint32_t;
+
+    auto
+    bind(vk::CommandBuffer const& commandBuffer) const -> void;
+
+    auto
+    draw(vk::CommandBuffer const& commandBuffer) const -> void;
+
+private:
+    AllocatedBuffer const m_vertices;
+    AllocatedBuffer const m_indices;
+    uint32_t const m_indexCount;
+};
+
+template<typename Vertex>
+[[nodiscard]] auto
+create_mesh(
+        MemoryAllocator& allocator,
+        TransferBatch& transfers,
+        MeshData<Vertex> const& mesh) -> MeshBuffer
+{
+    return MeshBuffer(
+            allocator,
+            transfers,
+            gsl::as_bytes(gsl::make_span(mesh.vertices)),
+            gsl::make_span(mesh.indices));
+}
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_MESH_BUFFER_HPP
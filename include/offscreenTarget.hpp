@@ -0,0 +1,47 @@
+#ifndef VK_TUT_OFFSCREEN_TARGET_HPP
+#define VK_TUT_OFFSCREEN_TARGET_HPP
+
+#include "memoryAllocator.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace vulkanUtils {
+
+// Device-local colour images standing in for swapchain images when rendering
+// without a window.
+class OffscreenTarget {
+public:
+    explicit OffscreenTarget(
+            MemoryAllocator& allocator,
+            vk::Format format,
+            vk::Extent2D extent,
+            uint32_t imageCount);
+
+    [[nodiscard]] auto
+    boundDevice() const noexcept -> vk::Device const&;
+
+    [[nodiscard]] auto
+    format() const noexcept -> vk::Format;
+
+    [[nodiscard]] auto
+    extent() const noexcept -> vk::Extent2D;
+
+    [[nodiscard]] auto
+    images() const noexcept -> std::vector<vk::Image> const&;
+
+private:
+    vk::Format const m_format;
+    vk::Extent2D const m_extent;
+
+    std::vector<AllocatedImage> const m_images;
+    std::vector<vk::Image> const m_imageHandles;
+
+    std::reference_wrapper<vk::Device const> const m_boundDevice;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_OFFSCREEN_TARGET_HPP
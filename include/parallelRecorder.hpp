@@ -0,0 +1,100 @@
+#ifndef VK_TUT_PARALLEL_RECORDER_HPP
+#define VK_TUT_PARALLEL_RECORDER_HPP
+
+#include "commandAllocator.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vulkanUtils {
+
+// Worker threads that each record a slice of a draw list into their own
+// secondary command buffer. Every worker has its own command allocator, so
+// no pool is ever touched by two threads.
+class ParallelRecorder {
+public:
+    // Records draws [first, first + count) into a secondary command buffer
+    // that has already been begun inside the render pass.
+    using RecordSlice = std::function<
+            void(vk::CommandBuffer const&, uint32_t first, uint32_t count)>;
+
+    explicit ParallelRecorder(
+            vk::Device const& logicalDevice,
+            uint32_t queueFamily,
+            uint32_t threadCount,
+            uint32_t framesInFlight);
+
+    ParallelRecorder(ParallelRecorder&&)      = delete;
+    ParallelRecorder(ParallelRecorder const&) = delete;
+    auto
+    operator=(ParallelRecorder&&) = delete;
+    auto
+    operator=(ParallelRecorder const&) = delete;
+
+    ~ParallelRecorder();
+
+    [[nodiscard]] auto
+    boundDevice() const noexcept -> vk::Device const&;
+
+    [[nodiscard]] auto
+    threadCount() const noexcept -> uint32_t;
+
+    // Summed over the workers' allocators.
+    [[nodiscard]] auto
+    allocationCount() const -> uint64_t;
+
+    // Splits the draws evenly over the workers and blocks until all of them
+    // are recorded, the frame's fence must have signalled. The returned
+    // buffers are in draw order, ready to be executed by the primary command
+    // buffer. Rethrows the first exception thrown by a worker.
+    [[nodiscard]] auto
+    record(uint32_t frameIndex,
+           vk::CommandBufferInheritanceInfo const& inheritance,
+           uint32_t drawCount,
+           RecordSlice const& recordSlice)
+            -> std::vector<vk::CommandBuffer> const&;
+
+private:
+    struct Job {
+        uint32_t frameIndex;
+        vk::CommandBufferInheritanceInfo const* inheritance;
+        uint32_t drawCount;
+        RecordSlice const* recordSlice;
+    };
+
+    std::vector<CommandAllocator> m_allocators;
+    std::vector<vk::CommandBuffer> m_recorded;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_jobReady;
+    std::condition_variable m_jobDone;
+    Job m_job;
+    uint64_t m_generation;
+    uint32_t m_remaining;
+    bool m_stopping;
+    std::vector<std::exception_ptr> m_errors;
+
+    std::reference_wrapper<vk::Device const> const m_boundDevice;
+
+    std::vector<std::thread> m_threads;
+
+    auto
+    work(uint32_t worker) -> void;
+
+    // Wakes every worker to exit and joins it.
+    auto
+    stop() -> void;
+
+    auto
+    record_slice(uint32_t worker, Job const& job) -> void;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_PARALLEL_RECORDER_HPP
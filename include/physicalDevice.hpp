@@ -1,6 +1,8 @@
 #ifndef VK_TUT_PHYSICAL_DEVICE
 #define VK_TUT_PHYSICAL_DEVICE
 
+#include "capabilities.hpp"
+
 #include <vulkan/vulkan.hpp>
 
 #include <vector>
@@ -13,11 +15,41 @@ struct QueueFamily {
     long position;
 };
 
+// Devices are compared by type first, discrete before integrated before
+// virtual before CPU, then by device local memory and finally by how many of
+// the optional features they support.
+struct DeviceScore {
+    uint32_t typeRank;
+    vk::DeviceSize deviceLocalMemory;
+    uint32_t optionalFeatures;
+};
+
+[[nodiscard]] auto
+operator<(DeviceScore const& lhs, DeviceScore const& rhs) noexcept -> bool;
+
+[[nodiscard]] auto
+enumerate_devices(vk::Instance const& instance) -> std::vector<DeviceInfo>;
+
+[[nodiscard]] auto
+score_device(
+        DeviceInfo const& device,
+        vk::PhysicalDeviceFeatures const& optionalFeatures) noexcept
+        -> DeviceScore;
+
+// Picks the best scoring device that supports all of the extensions and
+// required features. The VKTUT_DEVICE environment variable overrides the
+// choice with either a device index or part of a device name. Devices are
+// read through capabilityCache when one is given.
 class PhysicalDevice {
 public:
+    static auto constexpr overrideVariable = "VKTUT_DEVICE";
+
     explicit PhysicalDevice(
             vk::Instance const& instance,
-            std::vector<char const*> extensions);
+            std::vector<char const*> extensions,
+            vk::PhysicalDeviceFeatures const& requiredFeatures = {},
+            vk::PhysicalDeviceFeatures const& optionalFeatures = {},
+            CapabilityCache* capabilityCache                   = nullptr);
 
     [[nodiscard]] auto
     boundInstance() const noexcept -> vk::Instance const&;
@@ -25,6 +57,23 @@ public:
     [[nodiscard]] auto
     extensions() const noexcept -> std::vector<char const*> const&;
 
+    [[nodiscard]] auto
+    capabilities() const noexcept -> DeviceCapabilities const&;
+
+    [[nodiscard]] auto
+    properties() const noexcept -> vk::PhysicalDeviceProperties const&;
+
+    [[nodiscard]] auto
+    features() const noexcept -> vk::PhysicalDeviceFeatures const&;
+
+    [[nodiscard]] auto
+    memoryProperties() const noexcept
+            -> vk::PhysicalDeviceMemoryProperties const&;
+
+    [[nodiscard]] auto
+    queueFamilies() const noexcept
+            -> std::vector<vk::QueueFamilyProperties> const&;
+
     [[nodiscard]] auto
     operator*() const noexcept -> vk::PhysicalDevice const&;
 
@@ -40,8 +89,8 @@ public:
             vk::SurfaceKHR const& surface) const -> QueueFamily;
 
 private:
-    vk::PhysicalDevice const m_physicalDevice;
     std::vector<char const*> const m_extensions;
+    DeviceCapabilities const m_capabilities;
 
     std::reference_wrapper<vk::Instance const> const m_boundInstance;
 };
@@ -0,0 +1,120 @@
+#ifndef VK_TUT_PIPELINE_CACHE_HPP
+#define VK_TUT_PIPELINE_CACHE_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace vulkanUtils {
+
+struct PipelineCacheStats {
+    bool loadedFromDisk;
+    std::chrono::nanoseconds loadTime;
+
+    uint32_t hits;
+    uint32_t misses;
+    std::chrono::nanoseconds hitTime;
+    std::chrono::nanoseconds missTime;
+
+    // Creations that overlapped another one, whose effect on the cache size
+    // can't be told apart, along with how much they grew it in total.
+    uint32_t overlapped;
+    std::chrono::nanoseconds overlappedTime;
+    size_t overlappedGrowth;
+};
+
+auto
+operator<<(std::ostream& stream, PipelineCacheStats const& stats)
+        -> std::ostream&;
+
+// Wraps a vk::PipelineCache that is seeded from, and written back to, a blob
+// on disk. The blob is discarded if it was produced by a different device or
+// driver. A creation counts as a hit when it did not grow the cache, which is
+// only judged for creations that ran while no other one did.
+class PipelineCache {
+public:
+    explicit PipelineCache(
+            vk::Device const& logicalDevice,
+            vk::PhysicalDeviceProperties const& deviceProperties,
+            std::string filePath);
+
+    PipelineCache(PipelineCache&&)      = delete;
+    PipelineCache(PipelineCache const&) = delete;
+    auto
+    operator=(PipelineCache&&) = delete;
+    auto
+    operator=(PipelineCache const&) = delete;
+
+    ~PipelineCache();
+
+    [[nodiscard]] auto
+    boundDevice() const noexcept -> vk::Device const&;
+
+    [[nodiscard]] auto
+    filePath() const noexcept -> std::string const&;
+
+    [[nodiscard]] auto
+    stats() const -> PipelineCacheStats;
+
+    [[nodiscard]] auto
+    create_graphics_pipeline(vk::GraphicsPipelineCreateInfo const& createInfo)
+            -> vk::UniquePipeline;
+
+    [[nodiscard]] auto
+    create_compute_pipeline(vk::ComputePipelineCreateInfo const& createInfo)
+            -> vk::UniquePipeline;
+
+    auto
+    save() const -> void;
+
+    [[nodiscard]] auto
+    operator*() const noexcept -> vk::PipelineCache const&;
+
+    [[nodiscard]] auto
+    operator->() const noexcept -> vk::PipelineCache const*;
+
+private:
+    vk::PhysicalDeviceProperties const m_deviceProperties;
+    std::string const m_filePath;
+
+    mutable std::mutex m_statsMutex;
+    PipelineCacheStats m_stats;
+    uint32_t m_activeCreations;
+    uint64_t m_startedCreations;
+
+    vk::UniquePipelineCache const m_pipelineCache;
+
+    std::reference_wrapper<vk::Device const> const m_boundDevice;
+
+    [[nodiscard]] auto
+    cache_size() const -> size_t;
+
+    // Numbered so finish_creation can tell whether another one started
+    // meanwhile.
+    struct Creation {
+        uint64_t number;
+        bool startedAlone;
+    };
+
+    [[nodiscard]] auto
+    start_creation() -> Creation;
+
+    auto
+    finish_creation(
+            Creation const& creation,
+            std::chrono::nanoseconds duration,
+            size_t growth) -> void;
+
+    // Times create, which is handed the device and cache, and records it.
+    template<typename Create>
+    [[nodiscard]] auto
+    timed_creation(Create const& create) -> vk::UniquePipeline;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_PIPELINE_CACHE_HPP
@@ -0,0 +1,97 @@
+#ifndef VK_TUT_PIPELINE_DESCRIPTION_HPP
+#define VK_TUT_PIPELINE_DESCRIPTION_HPP
+
+#include "pipelineCache.hpp"
+#include "shaderUtility.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace vulkanUtils {
+
+struct ShaderStageDescription {
+    vk::ShaderStageFlagBits stage;
+    vk::ShaderModule module;
+    std::string entryPoint;
+    shaderUtils::SpecializationConstants specialization;
+};
+
+[[nodiscard]] auto
+operator==(ShaderStageDescription const& lhs, ShaderStageDescription const& rhs)
+        -> bool;
+
+template<shaderUtils::ShaderType Type>
+[[nodiscard]] auto
+shader_stage_description(
+        shaderUtils::Shader<Type> const& shader,
+        std::string entryPoint = "main") -> ShaderStageDescription
+{
+    return {shaderUtils::Shader<Type>::vkType,
+            **shader.module,
+            std::move(entryPoint),
+            shader.specialization};
+}
+
+// Everything a graphics pipeline is built from, held by value so that two
+// descriptions compare equal exactly when they would build the same pipeline.
+// The viewport is taken from extent unless it is a dynamic state.
+struct GraphicsPipelineDescription {
+    std::vector<ShaderStageDescription> stages;
+
+    std::vector<vk::VertexInputBindingDescription> vertexBindings;
+    std::vector<vk::VertexInputAttributeDescription> vertexAttributes;
+    vk::PrimitiveTopology topology;
+
+    vk::PolygonMode polygonMode;
+    vk::CullModeFlags cullMode;
+    vk::FrontFace frontFace;
+
+    std::vector<vk::PipelineColorBlendAttachmentState> blendAttachments;
+    std::array<float, 4> blendConstants;
+
+    std::vector<vk::DynamicState> dynamicStates;
+    vk::Extent2D extent;
+
+    vk::PipelineLayout layout;
+    vk::RenderPass renderPass;
+    uint32_t subpass;
+};
+
+[[nodiscard]] auto
+operator==(
+        GraphicsPipelineDescription const& lhs,
+        GraphicsPipelineDescription const& rhs) -> bool;
+
+[[nodiscard]] auto
+operator!=(
+        GraphicsPipelineDescription const& lhs,
+        GraphicsPipelineDescription const& rhs) -> bool;
+
+struct GraphicsPipelineDescriptionHash {
+    [[nodiscard]] auto
+    operator()(GraphicsPipelineDescription const& description) const noexcept
+            -> size_t;
+};
+
+// Filled triangle lists, back face culled, alpha blended into one attachment,
+// with a dynamic viewport and scissor. Stages, vertex input, layout and
+// render pass are left for the caller.
+[[nodiscard]] auto
+default_pipeline_description() -> GraphicsPipelineDescription;
+
+auto
+set_vertex_input(
+        GraphicsPipelineDescription& description,
+        vk::PipelineVertexInputStateCreateInfo const& vertexInput) -> void;
+
+[[nodiscard]] auto
+create_graphics_pipeline(
+        PipelineCache& pipelineCache,
+        GraphicsPipelineDescription const& description) -> vk::UniquePipeline;
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_PIPELINE_DESCRIPTION_HPP
@@ -0,0 +1,66 @@
+#ifndef VK_TUT_PIPELINE_LAYOUT_CACHE_HPP
+#define VK_TUT_PIPELINE_LAYOUT_CACHE_HPP
+
+#include "descriptorLayoutCache.hpp"
+#include "spirvReflection.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace vulkanUtils {
+
+// Set layouts come from a DescriptorLayoutCache, so equal sets are equal
+// handles and the key can compare those instead of the bindings.
+struct PipelineLayoutKey {
+    std::vector<vk::DescriptorSetLayout> setLayouts;
+    std::vector<vk::PushConstantRange> pushConstants;
+};
+
+[[nodiscard]] auto
+operator==(PipelineLayoutKey const& lhs, PipelineLayoutKey const& rhs)
+        -> bool;
+
+struct PipelineLayoutKeyHash {
+    [[nodiscard]] auto
+    operator()(PipelineLayoutKey const& key) const noexcept -> size_t;
+};
+
+// Creates each distinct pipeline layout once, so that pipelines whose
+// shaders reflect to the same interface share a layout and stay compatible
+// for descriptor sets and push constants bound before switching between
+// them. Layouts handed out stay valid for the lifetime of the cache.
+class PipelineLayoutCache {
+public:
+    PipelineLayoutCache(
+            vk::Device const& logicalDevice,
+            DescriptorLayoutCache& descriptorLayouts);
+
+    [[nodiscard]] auto
+    boundDevice() const noexcept -> vk::Device const&;
+
+    [[nodiscard]] auto
+    size() const -> size_t;
+
+    [[nodiscard]] auto
+    get(shaderUtils::PipelineLayoutDescription const& description)
+            -> vk::PipelineLayout;
+
+private:
+    mutable std::mutex m_mutex;
+    std::unordered_map<
+            PipelineLayoutKey,
+            vk::UniquePipelineLayout,
+            PipelineLayoutKeyHash>
+            m_layouts;
+
+    std::reference_wrapper<DescriptorLayoutCache> const m_descriptorLayouts;
+    std::reference_wrapper<vk::Device const> const m_boundDevice;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_PIPELINE_LAYOUT_CACHE_HPP
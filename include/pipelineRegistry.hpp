@@ -0,0 +1,182 @@
+#ifndef VK_TUT_PIPELINE_REGISTRY_HPP
+#define VK_TUT_PIPELINE_REGISTRY_HPP
+
+#include "frameRing.hpp"
+#include "pipelineCache.hpp"
+#include "pipelineDescription.hpp"
+#include "shaderUtility.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace vulkanUtils {
+
+struct PipelineRegistryStats {
+    uint32_t lookups;
+    uint32_t compiles;
+};
+
+auto
+operator<<(std::ostream& stream, PipelineRegistryStats const& stats)
+        -> std::ostream&;
+
+// A pipeline that may still be compiling. Until it is ready, or if it failed
+// to compile, the fallback is handed out instead. A null fallback means the
+// draws have to be skipped. Without a future the fallback is used for good.
+class PendingPipeline {
+public:
+    explicit PendingPipeline(
+            std::shared_future<vk::Pipeline> compiled,
+            vk::Pipeline fallback = {});
+
+    [[nodiscard]] auto
+    ready() const -> bool;
+
+    // Never blocks.
+    [[nodiscard]] auto
+    current() const -> vk::Pipeline;
+
+    // Null unless compilation has finished with an error.
+    [[nodiscard]] auto
+    error() const -> std::exception_ptr;
+
+private:
+    std::shared_future<vk::Pipeline> m_compiled;
+    vk::Pipeline m_fallback;
+};
+
+// Owns every graphics pipeline, keyed by the description it was built from,
+// so identical state is only ever compiled once. New pipelines are compiled
+// by worker threads sharing the pipeline cache, without workers they are
+// compiled by the thread asking for them.
+class PipelineRegistry {
+public:
+    explicit PipelineRegistry(
+            PipelineCache& pipelineCache,
+            uint32_t compileThreads = 0);
+
+    PipelineRegistry(PipelineRegistry&&)      = delete;
+    PipelineRegistry(PipelineRegistry const&) = delete;
+    auto
+    operator=(PipelineRegistry&&) = delete;
+    auto
+    operator=(PipelineRegistry const&) = delete;
+
+    ~PipelineRegistry();
+
+    [[nodiscard]] auto
+    compileThreads() const noexcept -> uint32_t;
+
+    [[nodiscard]] auto
+    size() const -> size_t;
+
+    [[nodiscard]] auto
+    stats() const -> PipelineRegistryStats;
+
+    // Returns without waiting for the compiler when there are workers. The
+    // future holds a null pipeline if its render pass was released first. A
+    // failed compile is forgotten, so asking again retries it.
+    [[nodiscard]] auto
+    request(GraphicsPipelineDescription const& description)
+            -> std::shared_future<vk::Pipeline>;
+
+    // Blocks until the pipeline is compiled.
+    [[nodiscard]] auto
+    get(GraphicsPipelineDescription const& description) -> vk::Pipeline;
+
+    // Hands back the pipelines built against a render pass that is about to
+    // be destroyed, for the caller to keep alive until the GPU is done.
+    // Queued compiles for it are dropped and running ones waited for.
+    [[nodiscard]] auto
+    release_render_pass(vk::RenderPass renderPass)
+            -> std::vector<vk::UniquePipeline>;
+
+    // The same for pipelines using a shader module that has been replaced.
+    [[nodiscard]] auto
+    release_shader_module(vk::ShaderModule module)
+            -> std::vector<vk::UniquePipeline>;
+
+    // Drops every queued compile and waits for the running ones, after which
+    // the objects the descriptions refer to may be destroyed.
+    auto
+    wait_idle() -> void;
+
+private:
+    using DescriptionFilter =
+            std::function<bool(GraphicsPipelineDescription const&)>;
+
+    struct Entry {
+        std::shared_future<vk::Pipeline> compiled;
+        vk::UniquePipeline pipeline;
+    };
+
+    struct CompileJob {
+        GraphicsPipelineDescription description;
+        std::promise<vk::Pipeline> promise;
+    };
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<
+            GraphicsPipelineDescription,
+            Entry,
+            GraphicsPipelineDescriptionHash>
+            m_pipelines;
+    PipelineRegistryStats m_stats;
+
+    std::condition_variable m_jobReady;
+    std::condition_variable m_compileDone;
+    std::deque<CompileJob> m_queue;
+    std::vector<GraphicsPipelineDescription const*> m_compiling;
+    bool m_stopping;
+
+    std::reference_wrapper<PipelineCache> const m_pipelineCache;
+
+    std::vector<std::thread> m_threads;
+
+    auto
+    work() -> void;
+
+    // Wakes every worker to exit and joins it.
+    auto
+    stop() -> void;
+
+    auto
+    compile(CompileJob& job, std::unique_lock<std::mutex>& lock) -> void;
+
+    // Drops the matching queued compiles, waits for the running ones and
+    // hands back every matching pipeline.
+    [[nodiscard]] auto
+    release(DescriptionFilter const& filter) -> std::vector<vk::UniquePipeline>;
+
+    // Resolves the dropped jobs to a null pipeline and forgets them. The lock
+    // must be held.
+    auto
+    drop_queued(DescriptionFilter const& filter) -> void;
+};
+
+// Pipelines and shader modules replaced by a reload. They are kept until the
+// frames that may still use them have retired, the release frame is only set
+// once their replacement is ready.
+struct RetiredPipelines {
+    static auto constexpr unscheduled = std::numeric_limits<uint64_t>::max();
+
+    std::vector<vk::UniquePipeline> pipelines;
+    std::vector<shaderUtils::SharedShaderModule> modules;
+
+    uint64_t releaseFrame;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_PIPELINE_REGISTRY_HPP
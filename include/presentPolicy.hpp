@@ -0,0 +1,59 @@
+#ifndef VK_TUT_PRESENT_POLICY_HPP
+#define VK_TUT_PRESENT_POLICY_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace vulkanUtils {
+
+enum class PresentProfile {
+    // Tear free and paced by the display.
+    Vsync,
+    // Shows the newest finished frame as soon as possible.
+    Latency,
+    // Never waits on the display, tearing if it has to.
+    Throughput
+};
+
+struct PresentPolicy {
+    // In order of preference. FIFO is used if none of them are supported.
+    std::vector<vk::PresentModeKHR> presentationModes;
+    // Images requested on top of the surface's minimum.
+    uint32_t extraImages;
+};
+
+struct PresentConfig {
+    vk::PresentModeKHR presentationMode;
+    uint32_t imageCount;
+};
+
+[[nodiscard]] auto
+present_policy(PresentProfile profile) -> PresentPolicy;
+
+// Accepts "vsync", "latency" or "throughput".
+[[nodiscard]] auto
+parse_present_profile(std::string_view name) -> PresentProfile;
+
+[[nodiscard]] auto
+to_string(PresentProfile profile) noexcept -> char const*;
+
+// Picks the policy's first supported mode and an image count within the
+// surface's limits. MAILBOX always gets a spare image, so that a finished
+// frame can replace the queued one without waiting for the display.
+[[nodiscard]] auto
+choose_present_config(
+        PresentPolicy const& policy,
+        std::vector<vk::PresentModeKHR> const& supportedPresentationModes,
+        vk::SurfaceCapabilitiesKHR const& surfaceCaps) noexcept
+        -> PresentConfig;
+
+auto
+operator<<(std::ostream& stream, PresentConfig const& config)
+        -> std::ostream&;
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_PRESENT_POLICY_HPP
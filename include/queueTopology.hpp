@@ -0,0 +1,59 @@
+#ifndef VK_TUT_QUEUE_TOPOLOGY_HPP
+#define VK_TUT_QUEUE_TOPOLOGY_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <ostream>
+#include <vector>
+
+namespace vulkanUtils {
+
+struct QueueLocation {
+    uint32_t family;
+    uint32_t index;
+};
+
+// Which queue each kind of work is submitted to. Transfer and compute work
+// prefer families dedicated to them, then a queue of their own in a shared
+// family, and only share the graphics queue as a last resort. Callers can
+// therefore always submit to them without checking what the device offers.
+struct QueueTopology {
+    QueueLocation graphics;
+    QueueLocation present;
+    QueueLocation transfer;
+    QueueLocation compute;
+
+    // Priorities of the queues to create, indexed by queue family.
+    std::vector<std::vector<float>> priorities;
+};
+
+[[nodiscard]] auto
+create_queue_topology(
+        std::vector<vk::QueueFamilyProperties> const& queueFamilies,
+        uint32_t graphicsFamily,
+        uint32_t presentFamily) -> QueueTopology;
+
+// True if transfers run on a family without graphics or compute support.
+[[nodiscard]] auto
+has_dedicated_transfer(QueueTopology const& topology) noexcept -> bool;
+
+// True if compute work has a queue of its own that can overlap graphics.
+[[nodiscard]] auto
+has_async_compute(QueueTopology const& topology) noexcept -> bool;
+
+// The returned infos point into the topology's priorities.
+[[nodiscard]] auto
+queue_create_infos(QueueTopology const& topology)
+        -> std::vector<vk::DeviceQueueCreateInfo>;
+
+[[nodiscard]] auto
+get_queue(vk::Device const& logicalDevice, QueueLocation location)
+        -> vk::Queue;
+
+auto
+operator<<(std::ostream& stream, QueueTopology const& topology)
+        -> std::ostream&;
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_QUEUE_TOPOLOGY_HPP
@@ -0,0 +1,107 @@
+#ifndef VK_TUT_RANGE_ALLOCATOR_HPP
+#define VK_TUT_RANGE_ALLOCATOR_HPP
+
+#include "memoryAllocator.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <map>
+#include <optional>
+
+namespace vulkanUtils {
+
+[[nodiscard]] auto constexpr align_up(
+        vk::DeviceSize const value,
+        vk::DeviceSize const alignment) noexcept -> vk::DeviceSize
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// True if both bytes fall on the same bufferImageGranularity page.
+[[nodiscard]] auto constexpr same_page(
+        vk::DeviceSize const first,
+        vk::DeviceSize const second,
+        vk::DeviceSize const granularity) noexcept -> bool
+{
+    return first / granularity == second / granularity;
+}
+
+// Hands out aligned offsets into a memory block of the given size. Only the
+// bookkeeping, the memory itself is owned by the block.
+class RangeAllocator {
+public:
+    explicit RangeAllocator(
+            vk::DeviceSize size,
+            AllocationStrategy strategy,
+            vk::DeviceSize granularity);
+
+    [[nodiscard]] auto
+    size() const noexcept -> vk::DeviceSize;
+
+    [[nodiscard]] auto
+    used() const noexcept -> vk::DeviceSize;
+
+    [[nodiscard]] auto
+    allocationCount() const noexcept -> uint32_t;
+
+    [[nodiscard]] auto
+    strategy() const noexcept -> AllocationStrategy;
+
+    // Bumped by reset, frees of earlier generations are ignored.
+    [[nodiscard]] auto
+    generation() const noexcept -> uint64_t;
+
+    [[nodiscard]] auto
+    try_allocate(
+            vk::DeviceSize size,
+            vk::DeviceSize alignment,
+            ResourceKind kind) -> std::optional<vk::DeviceSize>;
+
+    auto
+    free(vk::DeviceSize offset, uint64_t generation) noexcept -> void;
+
+    auto
+    reset() noexcept -> void;
+
+private:
+    struct Range {
+        vk::DeviceSize size;
+        ResourceKind kind;
+    };
+
+    vk::DeviceSize const m_size;
+    AllocationStrategy const m_strategy;
+    vk::DeviceSize const m_granularity;
+
+    // Both keyed by offset. Every byte is in exactly one of them, and no two
+    // free ranges are adjacent.
+    std::map<vk::DeviceSize, vk::DeviceSize> m_free;
+    std::map<vk::DeviceSize, Range> m_allocated;
+
+    vk::DeviceSize m_used;
+    vk::DeviceSize m_head;
+    uint64_t m_generation;
+
+    [[nodiscard]] auto
+    after_neighbour(vk::DeviceSize offset, ResourceKind kind) const
+            -> vk::DeviceSize;
+
+    [[nodiscard]] auto
+    find_linear(
+            vk::DeviceSize size,
+            vk::DeviceSize alignment,
+            ResourceKind kind) -> std::optional<vk::DeviceSize>;
+
+    [[nodiscard]] auto
+    find_free(
+            vk::DeviceSize size,
+            vk::DeviceSize alignment,
+            ResourceKind kind) -> std::optional<vk::DeviceSize>;
+
+    auto
+    insert_free(vk::DeviceSize offset, vk::DeviceSize size) -> void;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_RANGE_ALLOCATOR_HPP
@@ -0,0 +1,60 @@
+#ifndef VK_TUT_RENDER_SETTINGS_HPP
+#define VK_TUT_RENDER_SETTINGS_HPP
+
+#include "presentPolicy.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <string_view>
+
+struct RenderSettings {
+    // Renders into device-owned images instead of a window's swapchain.
+    bool headless       = false;
+    vk::Extent2D extent = {800, 600};
+    // 0 renders until the window is closed, or a default number of frames
+    // when headless.
+    uint32_t frameCount = 0;
+
+    // Deeper rings trade latency for throughput.
+    uint32_t framesInFlight = 2;
+
+    vulkanUtils::PresentProfile presentProfile =
+            vulkanUtils::PresentProfile::Vsync;
+
+    // Triangles uploaded into the mesh, laid out in a grid.
+    uint32_t triangleCount = 1;
+
+    // Threads recording secondary command buffers, 0 records every draw on
+    // the main thread.
+    uint32_t recordThreads = 0;
+
+    // Sorts and packs the triangles into instanced indirect draws instead of
+    // drawing each one on its own.
+    bool batchDraws = false;
+
+    // Writes a new descriptor set for every frame's uniforms instead of
+    // binding one set with a dynamic offset.
+    bool rewriteDescriptors = false;
+
+    // Threads compiling pipelines in the background, 0 compiles them on the
+    // main thread before the first frame that needs them.
+    uint32_t compileThreads = 0;
+
+    // Reloads shaders and rebuilds their pipelines when their files change.
+    bool watchShaders = false;
+
+    // Picks the triangle shader variant specialized with the tint applied.
+    bool tint = true;
+
+    // Moves the triangles with a compute pass before each frame's render
+    // pass. Batched draws pack their own instances and stay still.
+    bool computeInstances = false;
+};
+
+// Applies a single command line argument to the settings, returning false if
+// the argument is not a render setting.
+[[nodiscard]] auto
+parse_render_setting(std::string_view argument, RenderSettings& settings)
+        -> bool;
+
+#endif    // VK_TUT_RENDER_SETTINGS_HPP
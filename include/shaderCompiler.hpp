@@ -0,0 +1,81 @@
+#ifndef VK_TUT_SHADER_COMPILER_HPP
+#define VK_TUT_SHADER_COMPILER_HPP
+
+#include "shaderUtility.hpp"
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace shaderUtils {
+
+// SPIR-V is emitted unoptimised, glslang is built without SPIRV-Tools and
+// leaves optimising to the driver.
+struct ShaderCompileOptions {
+    bool debugInfo = false;
+
+    // "NAME" or "NAME=VALUE", defined before the first line of the source.
+    std::vector<std::string> defines;
+};
+
+struct ShaderCompileStats {
+    uint32_t cacheHits;
+    uint32_t compiles;
+    std::chrono::nanoseconds compileTime;
+};
+
+auto
+operator<<(std::ostream& stream, ShaderCompileStats const& stats)
+        -> std::ostream&;
+
+// Compiles GLSL sources into SPIR-V in process. Every binary is stored under
+// a name made from a hash of its source and the compile options, so a source
+// that has not changed is never compiled again. Sources can't #include other
+// files, which keeps the source alone responsible for the output.
+class ShaderCompiler {
+public:
+    static auto constexpr defaultCachePath = "shaders/build/cache/";
+
+    explicit ShaderCompiler(
+            std::string cachePath = defaultCachePath,
+            ShaderCompileOptions options = {});
+
+    ShaderCompiler(ShaderCompiler&&)      = delete;
+    ShaderCompiler(ShaderCompiler const&) = delete;
+    auto
+    operator=(ShaderCompiler&&) = delete;
+    auto
+    operator=(ShaderCompiler const&) = delete;
+
+    ~ShaderCompiler();
+
+    // False when built without SHADER_COMPILER, in which case only binaries
+    // already in the cache can be found.
+    [[nodiscard]] static auto
+    available() noexcept -> bool;
+
+    [[nodiscard]] auto
+    cachePath() const noexcept -> std::string const&;
+
+    [[nodiscard]] auto
+    options() const noexcept -> ShaderCompileOptions const&;
+
+    [[nodiscard]] auto
+    stats() const noexcept -> ShaderCompileStats const&;
+
+    // Returns the path of the binary for the shader's current source,
+    // compiling it first on a cache miss. Throws with the compiler's log if
+    // the source does not compile.
+    [[nodiscard]] auto
+    binary_path(ShaderType type, std::string const& name) -> std::string;
+
+private:
+    std::string const m_cachePath;
+    ShaderCompileOptions const m_options;
+    ShaderCompileStats m_stats;
+};
+
+}    // namespace shaderUtils
+
+#endif    // VK_TUT_SHADER_COMPILER_HPP
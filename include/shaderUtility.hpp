@@ -1,25 +1,250 @@
 #ifndef VK_TUT_SHADER_UTILITY_HPP
 #define VK_TUT_SHADER_UTILITY_HPP
 
+#include "spirvReflection.hpp"
+
 #include <vulkan/vulkan.hpp>
+#include <gsl/gsl>
 
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 #include <string>
+#include <utility>
 
 namespace shaderUtils {
 
 enum class ShaderType : VkShaderStageFlags {
     Vertex   = VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT,
-    Fragment = VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT
+    Fragment = VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT,
+    Compute  = VkShaderStageFlagBits::VK_SHADER_STAGE_COMPUTE_BIT
+};
+
+// The source file extension, ".vert", ".frag" or ".comp".
+[[nodiscard]] auto
+shader_extension(ShaderType type) noexcept -> std::string_view;
+
+[[nodiscard]] auto
+shader_source_directory() -> std::string const&;
+
+[[nodiscard]] auto
+shader_binary_directory() -> std::string const&;
+
+[[nodiscard]] auto
+shader_binary_path(ShaderType type, std::string const& name) -> std::string;
+
+[[nodiscard]] auto
+shader_source_path(ShaderType type, std::string const& name) -> std::string;
+
+// Read-only view of a SPIR-V binary on disk. The file is memory mapped where
+// the platform allows it, which gives page alignment for free, and copied
+// into a word-aligned buffer otherwise.
+class SpirvBinary {
+public:
+    explicit SpirvBinary(std::string const& filePath);
+
+    SpirvBinary(SpirvBinary&&)      = delete;
+    SpirvBinary(SpirvBinary const&) = delete;
+    auto
+    operator=(SpirvBinary&&) = delete;
+    auto
+    operator=(SpirvBinary const&) = delete;
+
+    ~SpirvBinary();
+
+    [[nodiscard]] auto
+    words() const noexcept -> gsl::span<uint32_t const>;
+
+private:
+#ifdef _WIN32
+    std::vector<uint32_t> m_words;
+#else
+    void* m_mapping;
+    size_t m_mappingSize;
+#endif
 };
 
 [[nodiscard]] auto
 create_shader_module(
-        vk::UniqueDevice const& logicalDevice,
+        vk::Device const& logicalDevice,
+        gsl::span<uint32_t const> words) -> vk::UniqueShaderModule;
+
+[[nodiscard]] auto
+create_shader_module(
+        vk::Device const& logicalDevice,
+        std::string const& binaryPath) -> vk::UniqueShaderModule;
+
+[[nodiscard]] auto
+create_shader_module(
+        vk::Device const& logicalDevice,
         ShaderType type,
         std::string const& name) -> vk::UniqueShaderModule;
 
+using SharedShaderModule = std::shared_ptr<vk::UniqueShaderModule const>;
+using SharedReflection   = std::shared_ptr<ShaderReflection const>;
+
+struct LoadedShader {
+    SharedShaderModule module;
+    SharedReflection reflection;
+};
+
+class ShaderCompiler;
+
+// Owns every shader module created on a device, so that shaders sharing a
+// binary share one vk::ShaderModule and the file is only read once. With a
+// compiler the binaries come from its cache instead of shaders/build/. Each
+// module is reflected as it is loaded, while its words are still at hand.
+class ShaderModuleCache {
+public:
+    explicit ShaderModuleCache(
+            vk::Device const& logicalDevice,
+            ShaderCompiler* compiler = nullptr);
+
+    [[nodiscard]] auto
+    boundDevice() const noexcept -> vk::Device const&;
+
+    [[nodiscard]] auto
+    compiler() const noexcept -> ShaderCompiler*;
+
+    [[nodiscard]] auto
+    get(ShaderType type, std::string const& name) -> SharedShaderModule;
+
+    // Builds a module from the current binary, or source when there is a
+    // compiler. The cache keeps handing out the old one until the new one is
+    // committed, so a module the caller rejects is never shared.
+    [[nodiscard]] auto
+    reload(ShaderType type, std::string const& name) -> LoadedShader;
+
+    // Replaces the cached module, holders of the old one keep it.
+    auto
+    commit(ShaderType type, std::string const& name, LoadedShader const& loaded)
+            -> void;
+
+    // The interface of the module currently cached, the one last committed.
+    [[nodiscard]] auto
+    reflection(ShaderType type, std::string const& name) const
+            -> SharedReflection;
+
+    [[nodiscard]] auto
+    size() const noexcept -> size_t;
+
+private:
+    std::map<std::pair<std::string, ShaderType>, SharedShaderModule>
+            m_modules;
+    std::map<std::pair<std::string, ShaderType>, SharedReflection>
+            m_reflections;
+    ShaderCompiler* const m_compiler;
+
+    std::reference_wrapper<vk::Device const> const m_boundDevice;
+
+    [[nodiscard]] auto
+    load(ShaderType type, std::string const& name) -> LoadedShader;
+};
+
+// Values for a stage's specialization constants, held by value so that two
+// stages specialized alike compare equal. Empty leaves every constant at the
+// default the shader declares.
+struct SpecializationConstants {
+    std::vector<vk::SpecializationMapEntry> entries;
+    std::vector<std::byte> data;
+};
+
+[[nodiscard]] auto
+operator==(
+        SpecializationConstants const& lhs,
+        SpecializationConstants const& rhs) -> bool;
+
+[[nodiscard]] auto
+operator!=(
+        SpecializationConstants const& lhs,
+        SpecializationConstants const& rhs) -> bool;
+
+// Null when there are no constants, otherwise points into constants.
+[[nodiscard]] auto
+specialization_info(SpecializationConstants const& constants)
+        -> std::optional<vk::SpecializationInfo>;
+
+// A constant_id declared in GLSL and the type it is declared with. bool is
+// passed to Vulkan as a VkBool32.
+template<uint32_t ConstantId, typename Value>
+struct SpecializationConstant {
+    static_assert(
+            std::is_same_v<Value, bool> || std::is_same_v<Value, int32_t>
+                    || std::is_same_v<Value, uint32_t>
+                    || std::is_same_v<Value, float>
+                    || std::is_same_v<Value, double>,
+            "Specialization constants are bool, int, uint, float or double");
+
+    static uint32_t constexpr id = ConstantId;
+    using ValueType              = Value;
+    using StoredType =
+            std::conditional_t<std::is_same_v<Value, bool>, vk::Bool32, Value>;
+};
+
+template<typename... Constants>
+[[nodiscard]] auto constexpr unique_constant_ids() noexcept -> bool
+{
+    auto constexpr ids = std::array<uint32_t, sizeof...(Constants)>{
+            Constants::id...};
+
+    for(auto i = size_t{0}; i < ids.size(); ++i) {
+        for(auto j = i + 1; j < ids.size(); ++j) {
+            if(ids[i] == ids[j]) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// The constants a shader is specialized on, fixed at compile time so that a
+// variant can only be made from values of the declared types. Each distinct
+// pack of values is a distinct pipeline, compiled and cached like any other.
+template<typename... Constants>
+struct SpecializationPack {
+    static_assert(
+            unique_constant_ids<Constants...>(),
+            "Each constant_id can only be specialized once");
+
+    [[nodiscard]] static auto
+    values(typename Constants::ValueType... value) -> SpecializationConstants
+    {
+        auto constants = SpecializationConstants{};
+        constants.entries.reserve(sizeof...(Constants));
+
+        (append<Constants>(constants, value), ...);
+
+        return constants;
+    }
+
+private:
+    template<typename Constant>
+    static auto
+    append(SpecializationConstants& constants,
+           typename Constant::ValueType const value) -> void
+    {
+        auto const stored =
+                static_cast<typename Constant::StoredType>(value);
+        auto const bytes = gsl::as_bytes(gsl::make_span(&stored, 1));
+
+        constants.entries.emplace_back(
+                Constant::id,
+                static_cast<uint32_t>(constants.data.size()),
+                sizeof(stored));
+        constants.data.insert(
+                std::end(constants.data),
+                std::cbegin(bytes),
+                std::cend(bytes));
+    }
+};
+
 template<ShaderType _type>
 struct [[nodiscard]] Shader
 {
@@ -27,23 +252,55 @@ struct [[nodiscard]] Shader
     static vk::ShaderStageFlagBits constexpr vkType =
             static_cast<vk::ShaderStageFlagBits>(type);
 
-    Shader(vk::UniqueDevice const& logicalDevice, std::string shaderName) :
+    Shader(ShaderModuleCache& moduleCache,
+           std::string shaderName,
+           SpecializationConstants constants = {}) :
                 name{std::move(shaderName)},
-                module{create_shader_module(logicalDevice, type, name)}
+                module{moduleCache.get(type, name)},
+                reflection{moduleCache.reflection(type, name)},
+                specialization{std::move(constants)}
     {}
 
+    // A variant sharing this shader's module, which the driver compiles with
+    // the constants folded in. Reloading either leaves the other as it was.
+    [[nodiscard]] auto
+    specialized(SpecializationConstants constants) const -> Shader
+    {
+        auto variant           = *this;
+        variant.specialization = std::move(constants);
+
+        return variant;
+    }
+
+    // Swaps in a module built from the shader's current source and hands
+    // back the one it replaced. The new module is left for the caller to
+    // commit to the cache once it has been accepted.
+    [[nodiscard]] auto
+    reload(ShaderModuleCache& moduleCache) -> LoadedShader
+    {
+        auto loaded = moduleCache.reload(type, name);
+
+        return {std::exchange(module, std::move(loaded.module)),
+                std::exchange(reflection, std::move(loaded.reflection))};
+    }
+
     std::string const name;
-    vk::UniqueShaderModule const module;
+    SharedShaderModule module;
+    SharedReflection reflection;
+    SpecializationConstants specialization;
 };
 
 using VertexShader   = Shader<ShaderType::Vertex>;
 using FragmentShader = Shader<ShaderType::Fragment>;
+using ComputeShader  = Shader<ShaderType::Compute>;
 
 [[nodiscard]] auto
 shader_stage_creation_info(
         vk::UniqueShaderModule const& shaderModule,
         ShaderType shaderType,
-        std::string_view stageName) -> vk::PipelineShaderStageCreateInfo;
+        std::string_view stageName,
+        vk::SpecializationInfo const* specialization = nullptr)
+        -> vk::PipelineShaderStageCreateInfo;
 
 }    // namespace shaderUtils
 
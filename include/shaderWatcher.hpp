@@ -0,0 +1,56 @@
+#ifndef VK_TUT_SHADER_WATCHER_HPP
+#define VK_TUT_SHADER_WATCHER_HPP
+
+#include "shaderUtility.hpp"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace shaderUtils {
+
+struct ShaderChange {
+    ShaderType type;
+    std::string name;
+};
+
+[[nodiscard]] auto
+operator==(ShaderChange const& lhs, ShaderChange const& rhs) -> bool;
+
+// Accepts sources, "triangle.frag", and binaries, "triangle.frag.spv", of
+// every shader type.
+[[nodiscard]] auto
+parse_shader_file(std::string_view fileName) -> std::optional<ShaderChange>;
+
+// Watches a directory for shaders being written or moved into it. Only
+// available where inotify is, constructing it elsewhere throws.
+class ShaderWatcher {
+public:
+    explicit ShaderWatcher(std::string directory);
+
+    ShaderWatcher(ShaderWatcher&&)      = delete;
+    ShaderWatcher(ShaderWatcher const&) = delete;
+    auto
+    operator=(ShaderWatcher&&) = delete;
+    auto
+    operator=(ShaderWatcher const&) = delete;
+
+    ~ShaderWatcher();
+
+    [[nodiscard]] auto
+    directory() const noexcept -> std::string const&;
+
+    // Never blocks. Each shader is reported once, however many times it was
+    // written since the last poll.
+    [[nodiscard]] auto
+    poll() -> std::vector<ShaderChange>;
+
+private:
+    std::string const m_directory;
+    int m_fileDescriptor;
+};
+
+}    // namespace shaderUtils
+
+#endif    // VK_TUT_SHADER_WATCHER_HPP
@@ -0,0 +1,82 @@
+#ifndef VK_TUT_SPIRV_REFLECTION_HPP
+#define VK_TUT_SPIRV_REFLECTION_HPP
+
+#include <vulkan/vulkan.hpp>
+#include <gsl/gsl>
+
+#include <vector>
+
+namespace shaderUtils {
+
+struct ReflectedDescriptor {
+    uint32_t set;
+    uint32_t binding;
+    vk::DescriptorType type;
+    uint32_t count;
+};
+
+struct ReflectedInput {
+    uint32_t location;
+    vk::Format format;
+};
+
+// What a single entry point reads from outside the shader. Uniform and
+// storage buffers are reported as their plain descriptor types, whether one
+// is bound with a dynamic offset is up to the caller.
+struct ShaderReflection {
+    vk::ShaderStageFlagBits stage;
+    std::vector<ReflectedDescriptor> descriptors;
+    std::vector<vk::PushConstantRange> pushConstants;
+
+    // Vertex shaders only, sorted by location. Built-ins are left out.
+    std::vector<ReflectedInput> inputs;
+};
+
+// Walks the module's instructions once, without needing SPIRV-Cross. Throws
+// if the words are not a SPIR-V module.
+[[nodiscard]] auto
+reflect_spirv(gsl::span<uint32_t const> words, vk::ShaderStageFlagBits stage)
+        -> ShaderReflection;
+
+// Descriptor set layouts indexed by set number, sets no shader uses are left
+// empty so that set numbers are kept.
+struct PipelineLayoutDescription {
+    std::vector<std::vector<vk::DescriptorSetLayoutBinding>> sets;
+    std::vector<vk::PushConstantRange> pushConstants;
+};
+
+[[nodiscard]] auto
+operator==(
+        PipelineLayoutDescription const& lhs,
+        PipelineLayoutDescription const& rhs) -> bool;
+
+[[nodiscard]] auto
+operator!=(
+        PipelineLayoutDescription const& lhs,
+        PipelineLayoutDescription const& rhs) -> bool;
+
+// Unions the interfaces of every given shader into one layout. Pass the
+// shaders of several pipelines to give them a shared, compatible layout.
+// Throws if two shaders disagree on the type of a binding.
+[[nodiscard]] auto
+merge_reflections(std::vector<ShaderReflection const*> const& reflections)
+        -> PipelineLayoutDescription;
+
+// Turns a uniform or storage buffer binding into its dynamic variant.
+auto
+make_dynamic(
+        PipelineLayoutDescription& layout,
+        uint32_t set,
+        uint32_t binding) -> void;
+
+// Throws naming the first vertex shader input that the attributes leave
+// unfed, or feed with a different format.
+auto
+verify_vertex_input(
+        ShaderReflection const& reflection,
+        gsl::span<vk::VertexInputAttributeDescription const> attributes)
+        -> void;
+
+}    // namespace shaderUtils
+
+#endif    // VK_TUT_SPIRV_REFLECTION_HPP
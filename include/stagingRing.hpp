@@ -0,0 +1,56 @@
+#ifndef VK_TUT_STAGING_RING_HPP
+#define VK_TUT_STAGING_RING_HPP
+
+#include "memoryAllocator.hpp"
+
+#include <vulkan/vulkan.hpp>
+#include <gsl/gsl>
+
+#include <optional>
+#include <vector>
+
+namespace vulkanUtils {
+
+// A persistently mapped host visible buffer that is written front to back
+// and wraps around. Whatever a frame wrote is reclaimed as a whole once
+// that frame is known to be finished with it.
+class StagingRing {
+public:
+    explicit StagingRing(
+            MemoryAllocator& allocator,
+            vk::DeviceSize capacity,
+            uint32_t framesInFlight);
+
+    [[nodiscard]] auto
+    buffer() const noexcept -> vk::Buffer const&;
+
+    [[nodiscard]] auto
+    capacity() const noexcept -> vk::DeviceSize;
+
+    // Copies the data into the ring and returns its offset in the buffer, or
+    // nothing if the ring is too full until older frames are released.
+    [[nodiscard]] auto
+    write(gsl::span<std::byte const> data, vk::DeviceSize alignment)
+            -> std::optional<vk::DeviceSize>;
+
+    // Hands everything written since the previous call to the frame.
+    auto
+    end_frame(uint32_t frameIndex) noexcept -> void;
+
+    // Reclaims what the frame was handed, the GPU must be done reading it.
+    auto
+    release_frame(uint32_t frameIndex) noexcept -> void;
+
+private:
+    AllocatedBuffer const m_buffer;
+    vk::DeviceSize const m_capacity;
+
+    vk::DeviceSize m_head;
+    vk::DeviceSize m_used;
+    vk::DeviceSize m_pending;
+    std::vector<vk::DeviceSize> m_frameBytes;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_STAGING_RING_HPP
@@ -1,16 +1,28 @@
 #ifndef VK_TUT_SWAPCHAIN_HPP
 #define VK_TUT_SWAPCHAIN_HPP
 
+#include "frameRing.hpp"
+
 #include <vulkan/vulkan.hpp>
 
 #include <vector>
 
 namespace vulkanUtils {
-class Swapchain {
-    explicit Swapchain(
-            vk::Device const& logicalDevice,
-            vk::SurfaceKHR const& surface);
+
+// What is left of a swapchain after it was handed to its replacement as
+// oldSwapchain. Frames that were in flight at the time may still use any of
+// it, so it is kept alive until the frame ring has gone round once more.
+// The render pass and pipeline are only set when the surface format changed.
+struct RetiredSwapchain {
+    vk::UniqueSwapchainKHR swapchain;
+    std::vector<vk::UniqueImageView> imageViews;
+    vk::UniqueRenderPass renderPass;
+    std::vector<vk::UniquePipeline> pipelines;
+    std::vector<vk::UniqueFramebuffer> framebuffers;
+
+    uint64_t releaseFrame;
 };
+
 }    // namespace vulkanUtils
 
 #endif    // VK_TUT_SWAPCHAIN_HPP
@@ -0,0 +1,99 @@
+#ifndef VK_TUT_TRANSFER_BATCH_HPP
+#define VK_TUT_TRANSFER_BATCH_HPP
+
+#include "memoryAllocator.hpp"
+#include "queueTopology.hpp"
+#include "stagingRing.hpp"
+
+#include <vulkan/vulkan.hpp>
+#include <gsl/gsl>
+
+#include <functional>
+#include <vector>
+
+namespace vulkanUtils {
+
+struct TransferStats {
+    uint64_t bytesUploaded;
+    uint32_t copies;
+    uint32_t submissions;
+};
+
+// Everything a frame in flight owns for its transfer submission.
+struct TransferSlot {
+    vk::UniqueCommandPool commandPool;
+    vk::UniqueCommandBuffer commandBuffer;
+    vk::UniqueSemaphore uploaded;
+    vk::UniqueFence done;
+};
+
+// What a graphics submission has to do before reading uploaded buffers:
+// wait on the semaphore at the vertex input stage and record the barriers,
+// which also take ownership of the buffers from the transfer queue family.
+struct UploadAcquire {
+    vk::Semaphore semaphore;
+    std::vector<vk::BufferMemoryBarrier> barriers;
+};
+
+// Gathers buffer uploads through a staging ring and submits all of a frame's
+// copies to the transfer queue at once.
+class TransferBatch {
+public:
+    static auto constexpr defaultStagingCapacity =
+            vk::DeviceSize{64} * 1024 * 1024;
+
+    explicit TransferBatch(
+            vk::Device const& logicalDevice,
+            MemoryAllocator& allocator,
+            QueueTopology const& queues,
+            vk::Queue const& transferQueue,
+            uint32_t framesInFlight,
+            vk::DeviceSize stagingCapacity = defaultStagingCapacity);
+
+    [[nodiscard]] auto
+    boundDevice() const noexcept -> vk::Device const&;
+
+    [[nodiscard]] auto
+    stats() const noexcept -> TransferStats const&;
+
+    // Waits for the frame's previous transfer, normally long finished, and
+    // reclaims its staging memory and command buffer.
+    auto
+    begin_frame(uint32_t frameIndex) -> void;
+
+    auto
+    upload(
+            vk::Buffer const& destination,
+            vk::DeviceSize offset,
+            gsl::span<std::byte const> data) -> void;
+
+    // Returns an empty acquire if nothing was queued.
+    [[nodiscard]] auto
+    submit(uint32_t frameIndex) -> UploadAcquire;
+
+private:
+    struct PendingCopy {
+        vk::Buffer destination;
+        vk::BufferCopy region;
+    };
+
+    uint32_t const m_transferFamily;
+    uint32_t const m_graphicsFamily;
+    vk::Queue const m_transferQueue;
+
+    StagingRing m_staging;
+    std::vector<TransferSlot> const m_slots;
+
+    std::vector<PendingCopy> m_pending;
+    TransferStats m_stats;
+
+    std::reference_wrapper<vk::Device const> const m_boundDevice;
+
+    [[nodiscard]] auto
+    ownership_barriers(vk::AccessFlags srcAccess, vk::AccessFlags dstAccess)
+            const -> std::vector<vk::BufferMemoryBarrier>;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_TRANSFER_BATCH_HPP
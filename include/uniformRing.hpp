@@ -0,0 +1,55 @@
+#ifndef VK_TUT_UNIFORM_RING_HPP
+#define VK_TUT_UNIFORM_RING_HPP
+
+#include "memoryAllocator.hpp"
+
+#include <vulkan/vulkan.hpp>
+#include <gsl/gsl>
+
+namespace vulkanUtils {
+
+// A persistently mapped uniform buffer split into one region per frame in
+// flight. Data pushed during a frame is placed in that frame's region, and
+// the returned offset is meant to be passed as the dynamic offset of a
+// eUniformBufferDynamic descriptor that points at the start of the buffer.
+class UniformRing {
+public:
+    explicit UniformRing(
+            MemoryAllocator& allocator,
+            vk::PhysicalDeviceLimits const& limits,
+            vk::DeviceSize regionSize,
+            uint32_t framesInFlight);
+
+    [[nodiscard]] auto
+    buffer() const noexcept -> vk::Buffer const&;
+
+    [[nodiscard]] auto
+    regionSize() const noexcept -> vk::DeviceSize;
+
+    // The frame's previous use of its region must have retired.
+    auto
+    begin_frame(uint32_t frameIndex) noexcept -> void;
+
+    // Throws if the frame's region is full.
+    [[nodiscard]] auto
+    push(gsl::span<std::byte const> data) -> uint32_t;
+
+    template<typename Uniforms>
+    [[nodiscard]] auto
+    push(Uniforms const& uniforms) -> uint32_t
+    {
+        return push(gsl::as_bytes(gsl::make_span(&uniforms, 1)));
+    }
+
+private:
+    vk::DeviceSize const m_alignment;
+    vk::DeviceSize const m_regionSize;
+    AllocatedBuffer const m_buffer;
+
+    vk::DeviceSize m_regionStart;
+    vk::DeviceSize m_head;
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_UNIFORM_RING_HPP
@@ -0,0 +1,145 @@
+#ifndef VK_TUT_VERTEX_LAYOUT_HPP
+#define VK_TUT_VERTEX_LAYOUT_HPP
+
+#include <vulkan/vulkan.hpp>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace vulkanUtils {
+
+template<typename Attribute>
+struct AttributeFormat;
+
+template<>
+struct AttributeFormat<float> {
+    static auto constexpr format = vk::Format::eR32Sfloat;
+};
+
+template<>
+struct AttributeFormat<glm::vec2> {
+    static auto constexpr format = vk::Format::eR32G32Sfloat;
+};
+
+template<>
+struct AttributeFormat<glm::vec3> {
+    static auto constexpr format = vk::Format::eR32G32B32Sfloat;
+};
+
+template<>
+struct AttributeFormat<glm::vec4> {
+    static auto constexpr format = vk::Format::eR32G32B32A32Sfloat;
+};
+
+template<>
+struct AttributeFormat<uint32_t> {
+    static auto constexpr format = vk::Format::eR32Uint;
+};
+
+template<typename Attribute>
+[[nodiscard]] auto constexpr vertex_attribute(
+        uint32_t const location,
+        size_t const offset,
+        uint32_t const binding = 0) noexcept
+        -> vk::VertexInputAttributeDescription
+{
+    return vk::VertexInputAttributeDescription(
+            location,
+            binding,
+            AttributeFormat<Attribute>::format,
+            static_cast<uint32_t>(offset));
+}
+
+// Specialised for every vertex type with a constexpr array of its attributes,
+// built with vertex_attribute, e.g.
+//     static auto constexpr attributes = std::array{
+//             vertex_attribute<glm::vec2>(0, offsetof(Vertex, position))};
+template<typename Vertex>
+struct VertexLayout;
+
+template<typename Vertex>
+auto constexpr vertexBinding = vk::VertexInputBindingDescription(
+        0,
+        sizeof(Vertex),
+        vk::VertexInputRate::eVertex);
+
+template<typename Vertex>
+auto constexpr vertexInputState = vk::PipelineVertexInputStateCreateInfo(
+        {},
+        1,
+        &vertexBinding<Vertex>,
+        VertexLayout<Vertex>::attributes.size(),
+        VertexLayout<Vertex>::attributes.data());
+
+// Per-instance data is read from binding 1, its attributes have to be placed
+// after the vertex's locations.
+template<typename Instance>
+auto constexpr instanceBinding = vk::VertexInputBindingDescription(
+        1,
+        sizeof(Instance),
+        vk::VertexInputRate::eInstance);
+
+template<typename Vertex, typename Instance>
+auto constexpr instancedBindings =
+        std::array{vertexBinding<Vertex>, instanceBinding<Instance>};
+
+template<typename Vertex, typename Instance, size_t... V, size_t... I>
+[[nodiscard]] auto constexpr instanced_attributes(
+        std::index_sequence<V...> /*vertex*/,
+        std::index_sequence<I...> /*instance*/) noexcept
+{
+    return std::array{
+            VertexLayout<Vertex>::attributes[V]...,
+            VertexLayout<Instance>::attributes[I]...};
+}
+
+template<typename Vertex, typename Instance>
+auto constexpr instancedAttributes = instanced_attributes<Vertex, Instance>(
+        std::make_index_sequence<VertexLayout<Vertex>::attributes.size()>{},
+        std::make_index_sequence<VertexLayout<Instance>::attributes.size()>{});
+
+template<typename Vertex, typename Instance>
+auto constexpr instancedVertexInputState =
+        vk::PipelineVertexInputStateCreateInfo(
+                {},
+                instancedBindings<Vertex, Instance>.size(),
+                instancedBindings<Vertex, Instance>.data(),
+                instancedAttributes<Vertex, Instance>.size(),
+                instancedAttributes<Vertex, Instance>.data());
+
+struct ColouredVertex {
+    glm::vec2 position;
+    glm::vec3 colour;
+};
+
+template<>
+struct VertexLayout<ColouredVertex> {
+    static auto constexpr attributes = std::array{
+            vertex_attribute<glm::vec2>(0, offsetof(ColouredVertex, position)),
+            vertex_attribute<glm::vec3>(1, offsetof(ColouredVertex, colour))};
+};
+
+// Places a mesh in normalised device coordinates.
+struct InstanceTransform {
+    glm::vec2 offset;
+    glm::vec2 scale;
+};
+
+template<>
+struct VertexLayout<InstanceTransform> {
+    static auto constexpr attributes = std::array{
+            vertex_attribute<glm::vec2>(
+                    2,
+                    offsetof(InstanceTransform, offset),
+                    1),
+            vertex_attribute<glm::vec2>(
+                    3,
+                    offsetof(InstanceTransform, scale),
+                    1)};
+};
+
+}    // namespace vulkanUtils
+
+#endif    // VK_TUT_VERTEX_LAYOUT_HPP
@@ -3,6 +3,9 @@
 
 #include "glfwUtility.hpp"
 #include "shaderUtility.hpp"
+#include "pipelineCache.hpp"
+#include "physicalDevice.hpp"
+#include "queueTopology.hpp"
 
 #include <vulkan/vulkan.hpp>
 #include <GLFW/glfw3.h>
@@ -14,23 +17,13 @@ namespace vulkanUtils {
 auto constexpr vkFalse = VK_FALSE;
 auto constexpr vkTrue  = VK_TRUE;
 
-struct QueueFamilyAndPos {
-    vk::QueueFamilyProperties properties;
-    long position;
-};
+using QueueFamilyAndPos = QueueFamily;
 
 struct QueueFamilies {
     QueueFamilyAndPos graphics;
     QueueFamilyAndPos present;
 };
 
-[[nodiscard]] auto
-extensions_supported(std::vector<char const*> const& extensionNames) noexcept
-        -> bool;
-
-[[nodiscard]] auto
-layers_supported(std::vector<char const*> const& layerNames) noexcept -> bool;
-
 using UniqueDebugUtilsMessengerEXT =
         vk::UniqueHandle<vk::DebugUtilsMessengerEXT, vk::DispatchLoaderDynamic>;
 
@@ -40,22 +33,13 @@ create_debug_messenger(
         vk::DispatchLoaderDynamic const& dispatcher)
         -> UniqueDebugUtilsMessengerEXT;
 
-[[nodiscard]] auto
-get_graphics_queues(vk::PhysicalDevice const& device) -> QueueFamilyAndPos;
-
-[[nodiscard]] auto
-get_present_queues(
-        vk::PhysicalDevice const& device,
-        QueueFamilyAndPos firstGraphicsQueueFamily,
-        vk::SurfaceKHR const& surface) -> QueueFamilyAndPos;
-
 [[nodiscard]] auto
 create_logical_device(
         vk::PhysicalDevice const& physicalDevice,
-        QueueFamilyAndPos const& queue,
-        std::vector<float> const& queuePriorities,
+        QueueTopology const& queues,
         std::vector<char const*> const& validationLayers,
-        std::vector<char const*> const& extensions) -> vk::UniqueDevice;
+        std::vector<char const*> const& extensions,
+        vk::PhysicalDeviceFeatures const& features) -> vk::UniqueDevice;
 
 auto constexpr defaultSurfaceFormat = vk::SurfaceFormatKHR{
         vk::Format::eB8G8R8A8Srgb,
@@ -63,16 +47,32 @@ auto constexpr defaultSurfaceFormat = vk::SurfaceFormatKHR{
 
 auto constexpr defaultPresentationMode = vk::PresentModeKHR::eFifoRelaxed;
 
+[[nodiscard]] auto
+find_memory_type(
+        vk::PhysicalDeviceMemoryProperties const& memoryProperties,
+        uint32_t supportedTypeBits,
+        vk::MemoryPropertyFlags requiredProperties) -> uint32_t;
+
+// Throws if maxExtent is smaller than minExtent.
+[[nodiscard]] auto
+clamp_extent_dimensions(
+        vk::Extent2D minExtent,
+        vk::Extent2D maxExtent,
+        vk::Extent2D requestedExtent) -> vk::Extent2D;
+
+// The swapchain's images are requestedDimensions clamped to the surface's
+// limits, see clamp_extent_dimensions.
 [[nodiscard]] auto
 create_swap_chain(
         vk::SurfaceKHR const& surface,
         vk::SurfaceCapabilitiesKHR const& surfaceCaps,
         vk::SurfaceFormatKHR const& surfaceFormat,
         vk::PresentModeKHR const& presentationMode,
+        uint32_t imageCount,
         vk::UniqueDevice const& logicalDevice,
         vk::Extent2D requestedDimensions,
-        std::vector<uint32_t> const& queueFamilyIndicies)
-        -> vk::UniqueSwapchainKHR;
+        std::vector<uint32_t> const& queueFamilyIndicies,
+        vk::SwapchainKHR const& oldSwapchain = {}) -> vk::UniqueSwapchainKHR;
 
 [[nodiscard]] auto
 create_image_views(
@@ -132,8 +132,19 @@ auto constexpr defaultDynamicStateInfo = vk::PipelineDynamicStateCreateInfo(
         defaultDynamicStates.size(),
         defaultDynamicStates.data());
 
+auto constexpr viewportDynamicStates =
+        std::array{vk::DynamicState::eViewport, vk::DynamicState::eScissor};
+
+auto constexpr viewportDynamicStateInfo = vk::PipelineDynamicStateCreateInfo(
+        {},
+        viewportDynamicStates.size(),
+        viewportDynamicStates.data());
+
 [[nodiscard]] auto
-create_render_pass(vk::UniqueDevice const& logicalDevice, vk::Format format)
+create_render_pass(
+        vk::UniqueDevice const& logicalDevice,
+        vk::Format format,
+        vk::ImageLayout finalLayout = vk::ImageLayout::ePresentSrcKHR)
         -> vk::UniqueRenderPass;
 
 using ShaderStageInfoVec = std::vector<vk::PipelineShaderStageCreateInfo>;
@@ -148,33 +159,39 @@ using ColourBlendState   = vk::PipelineColorBlendStateCreateInfo;
 using DynamicState       = vk::PipelineDynamicStateCreateInfo;
 
 [[nodiscard]] auto
-graphics_pipeline_create_info(
-        vk::PipelineCreateFlags flags,
-        ShaderStageInfoVec const* shaderStages,
-        VertexInputState const* vertexInputState,
-        InputAssemblyState const* inputAssemblyState,
-        TessellationState const* tessellationState,
-        ViewportState const* viewportState,
-        RasterizationState const* rasterizationState,
-        MultisampleState const* multisampleState,
-        DepthStencilState const* depthStencilState,
-        ColourBlendState const* colourBlendState,
-        DynamicState const* dynamicState,
-        vk::UniquePipelineLayout const& layout,
-        vk::UniqueRenderPass const& renderPass,
-        uint32_t renderPassPosition) -> vk::GraphicsPipelineCreateInfo;
-
-[[nodiscard]] auto
-create_graphics_pipeline(
-        vk::UniqueDevice const& logicalDevice,
-        shaderUtils::VertexShader const& vertexShader,
-        shaderUtils::FragmentShader const& fragmentShader,
-        int width,
-        int height,
-        ColourBlendState const& colourBlendState,
-        DynamicState const* dynamicState,
-        vk::UniquePipelineLayout const& pipelineLayout,
-        vk::UniqueRenderPass const& renderPass) -> vk::UniquePipeline;
+create_pipeline_layout(
+        vk::Device const& logicalDevice,
+        std::vector<vk::DescriptorSetLayout> const& setLayouts,
+        std::vector<vk::PushConstantRange> const& pushConstantRanges)
+        -> vk::UniquePipelineLayout;
+
+// Points a dynamic uniform buffer binding at a range of the buffer, the
+// dynamic offset given when binding the set is added to the offset.
+auto
+write_dynamic_uniform(
+        vk::Device const& logicalDevice,
+        vk::DescriptorSet const& set,
+        uint32_t binding,
+        vk::Buffer const& buffer,
+        vk::DeviceSize offset,
+        vk::DeviceSize range) -> void;
+
+auto
+write_storage_buffer(
+        vk::Device const& logicalDevice,
+        vk::DescriptorSet const& set,
+        uint32_t binding,
+        vk::Buffer const& buffer,
+        vk::DeviceSize offset = 0,
+        vk::DeviceSize range  = VK_WHOLE_SIZE) -> void;
+
+// The view's image has to be in the general layout when the set is used.
+auto
+write_storage_image(
+        vk::Device const& logicalDevice,
+        vk::DescriptorSet const& set,
+        uint32_t binding,
+        vk::ImageView const& imageView) -> void;
 
 [[nodiscard]] auto
 create_framebuffers(
@@ -183,18 +200,6 @@ create_framebuffers(
         std::vector<vk::UniqueImageView> const& imageViews,
         vk::Extent2D imageDimensions) -> std::vector<vk::UniqueFramebuffer>;
 
-[[nodiscard]] auto
-create_command_pool(
-        vk::UniqueDevice const& logicalDevice,
-        QueueFamilyAndPos const& queueFamily) -> vk::UniqueCommandPool;
-
-[[nodiscard]] auto
-allocate_command_buffers(
-        vk::UniqueDevice const& logicalDevice,
-        vk::UniqueCommandPool const& commandPool,
-        vk::CommandBufferLevel commandLevel,
-        uint32_t nrBuffers) -> std::vector<vk::UniqueCommandBuffer>;
-
 }    // namespace vulkanUtils
 
 #endif    // VK_TUT_VULKAN_UTILITY
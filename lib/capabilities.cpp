@@ -0,0 +1,468 @@
+#include "capabilities.hpp"
+#include "hashUtility.hpp"
+
+#include <gsl/gsl>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+
+namespace {
+
+auto constexpr capabilityFileMagic   = uint32_t{0x43434b56};    // "VKCC"
+auto constexpr capabilityFileVersion = uint32_t{1};
+
+struct CapabilityFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint64_t dataSize;
+    uint64_t dataHash;
+};
+
+// Flags a family can be looked up by, every subset of them is precomputed.
+auto constexpr lookupFlags = std::array{
+        vk::QueueFlagBits::eGraphics,
+        vk::QueueFlagBits::eCompute,
+        vk::QueueFlagBits::eTransfer,
+        vk::QueueFlagBits::eSparseBinding};
+
+auto constexpr lookupMask = VkQueueFlags{
+        VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT
+        | VK_QUEUE_SPARSE_BINDING_BIT};
+
+// Vulkan-Hpp structs are laid out like their C counterparts but do not all
+// have trivial copies, so only the layout is checked.
+template<typename T>
+auto
+append_bytes(std::vector<char>& bytes, T const* const data, size_t const count)
+        -> void
+{
+    static_assert(std::is_standard_layout_v<T>);
+
+    auto const* const first = reinterpret_cast<char const*>(data);
+    bytes.insert(std::end(bytes), first, first + count * sizeof(T));
+}
+
+// Advances bytes past what was read, false if there wasn't enough left.
+template<typename T>
+[[nodiscard]] auto
+read_bytes(gsl::span<char const>& bytes, T* const data, size_t const count)
+        -> bool
+{
+    static_assert(std::is_standard_layout_v<T>);
+
+    auto const size = count * sizeof(T);
+    if(static_cast<size_t>(bytes.size()) < size) {
+        return false;
+    }
+
+    std::memcpy(static_cast<void*>(data), bytes.data(), size);
+    bytes = bytes.subspan(size);
+
+    return true;
+}
+
+template<typename Properties, typename Name>
+[[nodiscard]] auto
+name_set(std::vector<Properties> const& properties, Name Properties::*name)
+        -> std::unordered_set<std::string>
+{
+    auto names = std::unordered_set<std::string>{};
+    names.reserve(properties.size());
+
+    for(auto const& property : properties) {
+        names.emplace((property.*name).data());
+    }
+
+    return names;
+}
+
+[[nodiscard]] auto
+family_lookup(std::vector<vk::QueueFamilyProperties> const& families)
+        -> std::unordered_map<VkQueueFlags, std::vector<uint32_t>>
+{
+    auto lookup = std::unordered_map<VkQueueFlags, std::vector<uint32_t>>{};
+
+    for(auto subset = 0u; subset < (1u << lookupFlags.size()); ++subset) {
+        auto flags = VkQueueFlags{0};
+        for(auto bit = size_t{0}; bit < lookupFlags.size(); ++bit) {
+            if((subset & (1u << bit)) != 0) {
+                flags |= static_cast<VkQueueFlags>(lookupFlags[bit]);
+            }
+        }
+
+        auto& indices = lookup[flags];
+        for(auto i = uint32_t{0}; i < families.size(); ++i) {
+            auto const supported =
+                    static_cast<VkQueueFlags>(families[i].queueFlags);
+            if((supported & flags) == flags) {
+                indices.push_back(i);
+            }
+        }
+    }
+
+    return lookup;
+}
+
+}    // namespace
+
+namespace vulkanUtils {
+
+[[nodiscard]] auto
+query_device(vk::PhysicalDevice const& device) -> DeviceInfo
+{
+    return {device,
+            device.getProperties(),
+            device.getFeatures(),
+            device.getMemoryProperties(),
+            device.enumerateDeviceExtensionProperties(),
+            device.getQueueFamilyProperties()};
+}
+
+InstanceCapabilities::InstanceCapabilities() :
+            m_extensions{name_set(
+                    vk::enumerateInstanceExtensionProperties(),
+                    &vk::ExtensionProperties::extensionName)},
+            m_layers{name_set(
+                    vk::enumerateInstanceLayerProperties(),
+                    &vk::LayerProperties::layerName)}
+{}
+
+[[nodiscard]] auto
+InstanceCapabilities::has_extension(std::string const& name) const -> bool
+{
+    return m_extensions.count(name) != 0;
+}
+
+[[nodiscard]] auto
+InstanceCapabilities::has_layer(std::string const& name) const -> bool
+{
+    return m_layers.count(name) != 0;
+}
+
+[[nodiscard]] auto
+InstanceCapabilities::supports_extensions(
+        std::vector<char const*> const& names) const -> bool
+{
+    auto allSupported = true;
+    for(auto const* name : names) {
+        if(!has_extension(name)) {
+            std::cerr << "Extension " << name << " not supported!\n";
+            allSupported = false;
+        }
+    }
+
+    return allSupported;
+}
+
+[[nodiscard]] auto
+InstanceCapabilities::supports_layers(
+        std::vector<char const*> const& names) const -> bool
+{
+    auto allSupported = true;
+    for(auto const* name : names) {
+        if(!has_layer(name)) {
+            std::cerr << "Layer " << name << " not supported!\n";
+            allSupported = false;
+        }
+    }
+
+    return allSupported;
+}
+
+DeviceCapabilities::DeviceCapabilities(DeviceInfo info) :
+            m_info{std::move(info)},
+            m_extensions{name_set(
+                    m_info.extensions,
+                    &vk::ExtensionProperties::extensionName)},
+            m_queueFamilies{family_lookup(m_info.queueFamilies)}
+{}
+
+[[nodiscard]] auto
+DeviceCapabilities::info() const noexcept -> DeviceInfo const&
+{
+    return m_info;
+}
+
+[[nodiscard]] auto
+DeviceCapabilities::limits() const noexcept -> vk::PhysicalDeviceLimits const&
+{
+    return m_info.properties.limits;
+}
+
+[[nodiscard]] auto
+DeviceCapabilities::has_feature(
+        vk::Bool32 vk::PhysicalDeviceFeatures::*const feature) const noexcept
+        -> bool
+{
+    return m_info.features.*feature == VK_TRUE;
+}
+
+[[nodiscard]] auto
+DeviceCapabilities::has_extension(std::string const& name) const -> bool
+{
+    return m_extensions.count(name) != 0;
+}
+
+[[nodiscard]] auto
+DeviceCapabilities::supports_extensions(
+        std::vector<char const*> const& names) const -> bool
+{
+    for(auto const* name : names) {
+        if(!has_extension(name)) {
+            std::cerr << m_info.properties.deviceName.data() << ": " << name
+                      << " not supported.\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+[[nodiscard]] auto
+DeviceCapabilities::queue_families(vk::QueueFlags const flags) const
+        -> std::vector<uint32_t> const&
+{
+    return m_queueFamilies.at(static_cast<VkQueueFlags>(flags) & lookupMask);
+}
+
+[[nodiscard]] auto
+operator==(DeviceKey const& lhs, DeviceKey const& rhs) noexcept -> bool
+{
+    return lhs.vendorID == rhs.vendorID && lhs.deviceID == rhs.deviceID
+           && lhs.driverVersion == rhs.driverVersion
+           && lhs.apiVersion == rhs.apiVersion
+           && lhs.pipelineCacheUUID == rhs.pipelineCacheUUID;
+}
+
+[[nodiscard]] auto
+device_key(vk::PhysicalDeviceProperties const& properties) noexcept
+        -> DeviceKey
+{
+    auto key          = DeviceKey{};
+    key.vendorID      = properties.vendorID;
+    key.deviceID      = properties.deviceID;
+    key.driverVersion = properties.driverVersion;
+    key.apiVersion    = properties.apiVersion;
+
+    std::copy(
+            std::cbegin(properties.pipelineCacheUUID),
+            std::cend(properties.pipelineCacheUUID),
+            std::begin(key.pipelineCacheUUID));
+
+    return key;
+}
+
+[[nodiscard]] auto
+DeviceKeyHash::operator()(DeviceKey const& key) const noexcept -> size_t
+{
+    return static_cast<size_t>(fnv1a(&key, sizeof(key)));
+}
+
+auto
+operator<<(std::ostream& stream, CapabilityCacheStats const& stats)
+        -> std::ostream&
+{
+    return stream << "Capability cache: "
+                  << (stats.loadedFromDisk ? "warm" : "cold") << " start, "
+                  << stats.hits << " devices from disk, " << stats.misses
+                  << " queried\n";
+}
+
+CapabilityCache::CapabilityCache(std::string filePath) :
+            m_filePath{std::move(filePath)},
+            m_entries{},
+            m_stats{}
+{
+    load();
+}
+
+[[nodiscard]] auto
+CapabilityCache::filePath() const noexcept -> std::string const&
+{
+    return m_filePath;
+}
+
+[[nodiscard]] auto
+CapabilityCache::stats() const noexcept -> CapabilityCacheStats const&
+{
+    return m_stats;
+}
+
+[[nodiscard]] auto
+CapabilityCache::enumerate_devices(vk::Instance const& instance)
+        -> std::vector<DeviceInfo>
+{
+    auto devices = std::vector<DeviceInfo>{};
+    auto missed  = false;
+
+    for(auto const& device : instance.enumeratePhysicalDevices()) {
+        auto const properties = device.getProperties();
+        auto const key        = device_key(properties);
+
+        auto const cached = m_entries.find(key);
+        if(cached != std::cend(m_entries)) {
+            auto const& entry = cached->second;
+            devices.push_back(
+                    {device,
+                     properties,
+                     entry.features,
+                     entry.memoryProperties,
+                     entry.extensions,
+                     entry.queueFamilies});
+
+            ++m_stats.hits;
+            continue;
+        }
+
+        auto info = query_device(device);
+        m_entries.insert_or_assign(
+                key,
+                Entry{info.features,
+                      info.memoryProperties,
+                      info.extensions,
+                      info.queueFamilies});
+        devices.push_back(std::move(info));
+
+        ++m_stats.misses;
+        missed = true;
+    }
+
+    // Failing to persist only costs the next start its warm enumeration.
+    if(missed) {
+        try {
+            save();
+        }
+        catch(std::exception const& e) {
+            std::cerr << "Capability cache could not be saved: " << e.what()
+                      << '\n';
+        }
+    }
+
+    return devices;
+}
+
+auto
+CapabilityCache::save() const -> void
+{
+    auto data = std::vector<char>{};
+    for(auto const& [key, entry] : m_entries) {
+        auto const extensionCount =
+                static_cast<uint32_t>(entry.extensions.size());
+        auto const familyCount =
+                static_cast<uint32_t>(entry.queueFamilies.size());
+
+        append_bytes(data, &key, 1);
+        append_bytes(data, &entry.features, 1);
+        append_bytes(data, &entry.memoryProperties, 1);
+        append_bytes(data, &extensionCount, 1);
+        append_bytes(data, &familyCount, 1);
+        append_bytes(data, entry.extensions.data(), extensionCount);
+        append_bytes(data, entry.queueFamilies.data(), familyCount);
+    }
+
+    auto header       = CapabilityFileHeader{};
+    header.magic      = capabilityFileMagic;
+    header.version    = capabilityFileVersion;
+    header.entryCount = static_cast<uint32_t>(m_entries.size());
+    header.dataSize   = data.size();
+    header.dataHash   = fnv1a(data.data(), data.size());
+
+    auto const path = std::filesystem::path{m_filePath};
+    if(path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+
+    auto tempPath = path;
+    tempPath += ".tmp";
+
+    {
+        auto file = std::ofstream(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        file.write(data.data(), data.size());
+        file.flush();
+
+        if(!file) {
+            throw std::runtime_error("Could not write " + tempPath.string());
+        }
+    }
+
+    std::filesystem::rename(tempPath, path);
+}
+
+// Anything that doesn't check out leaves the cache empty, every device is
+// then queried as on a cold start.
+auto
+CapabilityCache::load() -> void
+{
+    auto file = std::ifstream(m_filePath, std::ios::binary);
+    if(!file.is_open()) {
+        return;
+    }
+
+    auto header = CapabilityFileHeader{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if(!file || header.magic != capabilityFileMagic
+       || header.version != capabilityFileVersion) {
+        std::cerr << "Capability cache " << m_filePath
+                  << " is stale, starting cold\n";
+        return;
+    }
+
+    // Sized by what is in the file, not by the header.
+    auto const data = std::vector<char>(
+            std::istreambuf_iterator<char>{file},
+            std::istreambuf_iterator<char>{});
+
+    if(data.size() != header.dataSize
+       || fnv1a(data.data(), data.size()) != header.dataHash) {
+        std::cerr << "Capability cache " << m_filePath
+                  << " is corrupt, starting cold\n";
+        return;
+    }
+
+    auto entries = decltype(m_entries){};
+    auto bytes   = gsl::span<char const>{data};
+    for(auto i = uint32_t{0}; i < header.entryCount; ++i) {
+        auto key            = DeviceKey{};
+        auto entry          = Entry{};
+        auto extensionCount = uint32_t{0};
+        auto familyCount    = uint32_t{0};
+
+        auto valid = read_bytes(bytes, &key, 1)
+                     && read_bytes(bytes, &entry.features, 1)
+                     && read_bytes(bytes, &entry.memoryProperties, 1)
+                     && read_bytes(bytes, &extensionCount, 1)
+                     && read_bytes(bytes, &familyCount, 1);
+
+        if(valid) {
+            entry.extensions.resize(extensionCount);
+            entry.queueFamilies.resize(familyCount);
+
+            valid = read_bytes(bytes, entry.extensions.data(), extensionCount)
+                    && read_bytes(
+                            bytes,
+                            entry.queueFamilies.data(),
+                            familyCount);
+        }
+
+        if(!valid) {
+            std::cerr << "Capability cache " << m_filePath
+                      << " is corrupt, starting cold\n";
+            return;
+        }
+
+        entries.insert_or_assign(key, std::move(entry));
+    }
+
+    m_entries              = std::move(entries);
+    m_stats.loadedFromDisk = true;
+}
+
+}    // namespace vulkanUtils
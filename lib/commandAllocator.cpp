@@ -0,0 +1,92 @@
+#include "commandAllocator.hpp"
+
+#include <stdexcept>
+
+[[nodiscard]] auto
+create_command_frames(
+        vk::Device const& logicalDevice,
+        uint32_t const queueFamily,
+        uint32_t const framesInFlight)
+        -> std::vector<vulkanUtils::CommandFrame>
+{
+    if(framesInFlight == 0) {
+        throw std::invalid_argument("At least one frame must be in flight");
+    }
+
+    auto frames = std::vector<vulkanUtils::CommandFrame>{};
+    frames.reserve(framesInFlight);
+
+    for(auto i = 0u; i < framesInFlight; ++i) {
+        frames.push_back(
+                {logicalDevice.createCommandPoolUnique(
+                         vk::CommandPoolCreateInfo(
+                                 vk::CommandPoolCreateFlagBits::eTransient,
+                                 queueFamily)),
+                 {},
+                 {},
+                 0,
+                 0});
+    }
+
+    return frames;
+}
+
+namespace vulkanUtils {
+
+CommandAllocator::CommandAllocator(
+        vk::Device const& logicalDevice,
+        uint32_t const queueFamily,
+        uint32_t const framesInFlight) :
+            m_frames{create_command_frames(
+                    logicalDevice,
+                    queueFamily,
+                    framesInFlight)},
+            m_allocationCount{0},
+            m_boundDevice{logicalDevice}
+{}
+
+[[nodiscard]] auto
+CommandAllocator::boundDevice() const noexcept -> vk::Device const&
+{
+    return m_boundDevice.get();
+}
+
+[[nodiscard]] auto
+CommandAllocator::allocationCount() const noexcept -> uint64_t
+{
+    return m_allocationCount;
+}
+
+auto
+CommandAllocator::reset(uint32_t const frameIndex) -> void
+{
+    auto& frame = m_frames.at(frameIndex);
+
+    m_boundDevice.get().resetCommandPool(*frame.commandPool, {});
+    frame.primariesUsed   = 0;
+    frame.secondariesUsed = 0;
+}
+
+[[nodiscard]] auto
+CommandAllocator::allocate(
+        uint32_t const frameIndex,
+        vk::CommandBufferLevel const level) -> vk::CommandBuffer
+{
+    auto& frame = m_frames.at(frameIndex);
+
+    auto const primary = level == vk::CommandBufferLevel::ePrimary;
+    auto& buffers      = primary ? frame.primaries : frame.secondaries;
+    auto& used         = primary ? frame.primariesUsed : frame.secondariesUsed;
+
+    if(used == buffers.size()) {
+        auto const allocated = m_boundDevice.get().allocateCommandBuffers(
+                vk::CommandBufferAllocateInfo(*frame.commandPool, level, 1));
+
+        buffers.push_back(allocated.front());
+        ++m_allocationCount;
+    }
+
+    return buffers[used++];
+}
+
+}    // namespace vulkanUtils
@@ -0,0 +1,120 @@
+#include "computePipeline.hpp"
+
+namespace vulkanUtils {
+
+[[nodiscard]] auto
+create_compute_pipeline(
+        PipelineCache& pipelineCache,
+        ShaderStageDescription const& stage,
+        vk::PipelineLayout const& layout) -> vk::UniquePipeline
+{
+    auto const specialization =
+            shaderUtils::specialization_info(stage.specialization);
+
+    return pipelineCache.create_compute_pipeline(vk::ComputePipelineCreateInfo(
+            {},
+            vk::PipelineShaderStageCreateInfo(
+                    {},
+                    stage.stage,
+                    stage.module,
+                    stage.entryPoint.c_str(),
+                    specialization ? &*specialization : nullptr),
+            layout));
+}
+
+auto
+memory_barrier(
+        vk::CommandBuffer const& commandBuffer,
+        vk::PipelineStageFlags const srcStages,
+        vk::AccessFlags const srcAccess,
+        vk::PipelineStageFlags const dstStages,
+        vk::AccessFlags const dstAccess) -> void
+{
+    commandBuffer.pipelineBarrier(
+            srcStages,
+            dstStages,
+            {},
+            vk::MemoryBarrier(srcAccess, dstAccess),
+            nullptr,
+            nullptr);
+}
+
+auto
+storage_image_barrier(
+        vk::CommandBuffer const& commandBuffer,
+        vk::Image const& image,
+        vk::ImageLayout const oldLayout,
+        vk::PipelineStageFlags const srcStages,
+        vk::AccessFlags const srcAccess) -> void
+{
+    auto const barrier = vk::ImageMemoryBarrier(
+            srcAccess,
+            vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite,
+            oldLayout,
+            vk::ImageLayout::eGeneral,
+            VK_QUEUE_FAMILY_IGNORED,
+            VK_QUEUE_FAMILY_IGNORED,
+            image,
+            vk::ImageSubresourceRange(
+                    vk::ImageAspectFlagBits::eColor,
+                    0,
+                    VK_REMAINING_MIP_LEVELS,
+                    0,
+                    VK_REMAINING_ARRAY_LAYERS));
+
+    commandBuffer.pipelineBarrier(
+            srcStages,
+            vk::PipelineStageFlagBits::eComputeShader,
+            {},
+            nullptr,
+            nullptr,
+            barrier);
+}
+
+auto
+record_dispatch(
+        vk::CommandBuffer const& commandBuffer,
+        ComputeDispatch const& dispatch,
+        DispatchDependencies const& dependencies) -> void
+{
+    auto constexpr shaderAccess =
+            vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
+
+    if(dependencies.producerStages) {
+        memory_barrier(
+                commandBuffer,
+                dependencies.producerStages,
+                dependencies.producerAccess,
+                vk::PipelineStageFlagBits::eComputeShader,
+                shaderAccess);
+    }
+
+    commandBuffer.bindPipeline(
+            vk::PipelineBindPoint::eCompute,
+            dispatch.pipeline);
+
+    if(!dispatch.sets.empty()) {
+        commandBuffer.bindDescriptorSets(
+                vk::PipelineBindPoint::eCompute,
+                dispatch.layout,
+                0,
+                dispatch.sets,
+                nullptr);
+    }
+
+    commandBuffer.dispatch(
+            dispatch.groups.width,
+            dispatch.groups.height,
+            dispatch.groups.depth);
+
+    if(dependencies.consumerStages) {
+        memory_barrier(
+                commandBuffer,
+                vk::PipelineStageFlagBits::eComputeShader,
+                vk::AccessFlagBits::eShaderWrite,
+                dependencies.consumerStages,
+                dependencies.consumerAccess);
+    }
+}
+
+}    // namespace vulkanUtils
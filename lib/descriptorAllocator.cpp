@@ -0,0 +1,237 @@
+#include "descriptorAllocator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+
+[[nodiscard]] auto
+create_descriptor_pool(
+        vk::Device const& logicalDevice,
+        uint32_t const setCount,
+        std::vector<vulkanUtils::DescriptorPoolRatio> const& ratios)
+        -> vk::UniqueDescriptorPool
+{
+    auto sizes = std::vector<vk::DescriptorPoolSize>{};
+    sizes.reserve(ratios.size());
+
+    for(auto const& ratio : ratios) {
+        auto const count = static_cast<uint32_t>(
+                std::ceil(ratio.perSet * static_cast<float>(setCount)));
+        sizes.emplace_back(ratio.type, std::max(count, 1u));
+    }
+
+    return logicalDevice.createDescriptorPoolUnique(
+            vk::DescriptorPoolCreateInfo(
+                    {},
+                    setCount,
+                    static_cast<uint32_t>(sizes.size()),
+                    sizes.data()));
+}
+
+// Returns nothing when the pool has run out, any other error is thrown.
+[[nodiscard]] auto
+try_allocate(
+        vk::Device const& logicalDevice,
+        vk::DescriptorPool const& pool,
+        vk::DescriptorSetLayout const& layout)
+        -> std::optional<vk::DescriptorSet>
+{
+    try {
+        return logicalDevice
+                .allocateDescriptorSets(
+                        vk::DescriptorSetAllocateInfo(pool, 1, &layout))
+                .front();
+    }
+    catch(vk::OutOfPoolMemoryError const&) {
+        return std::nullopt;
+    }
+    catch(vk::FragmentedPoolError const&) {
+        return std::nullopt;
+    }
+}
+
+namespace vulkanUtils {
+
+[[nodiscard]] auto
+default_pool_ratios() -> std::vector<DescriptorPoolRatio>
+{
+    return {{vk::DescriptorType::eSampler, 0.5f},
+            {vk::DescriptorType::eCombinedImageSampler, 2.0f},
+            {vk::DescriptorType::eSampledImage, 2.0f},
+            {vk::DescriptorType::eStorageImage, 1.0f},
+            {vk::DescriptorType::eUniformBuffer, 2.0f},
+            {vk::DescriptorType::eUniformBufferDynamic, 1.0f},
+            {vk::DescriptorType::eStorageBuffer, 2.0f},
+            {vk::DescriptorType::eStorageBufferDynamic, 1.0f}};
+}
+
+auto
+operator<<(std::ostream& stream, DescriptorStats const& stats)
+        -> std::ostream&
+{
+    return stream << stats.pools << " descriptor pools, "
+                  << stats.poolAllocations << " sets allocated from pools, "
+                  << stats.reusedSets << " reused, " << stats.poolResets
+                  << " pool resets\n";
+}
+
+DescriptorAllocator::DescriptorAllocator(
+        vk::Device const& logicalDevice,
+        uint32_t const setsPerPool,
+        std::vector<DescriptorPoolRatio> ratios) :
+            m_ratios{std::move(ratios)},
+            m_nextPoolSize{setsPerPool},
+            m_stats{},
+            m_boundDevice{logicalDevice}
+{
+    if(setsPerPool == 0) {
+        throw std::invalid_argument("Descriptor pools must hold a set");
+    }
+}
+
+[[nodiscard]] auto
+DescriptorAllocator::boundDevice() const noexcept -> vk::Device const&
+{
+    return m_boundDevice.get();
+}
+
+[[nodiscard]] auto
+DescriptorAllocator::stats() const -> DescriptorStats
+{
+    auto const lock = std::lock_guard{m_mutex};
+    return m_stats;
+}
+
+[[nodiscard]] auto
+DescriptorAllocator::allocate(vk::DescriptorSetLayout const& layout)
+        -> vk::DescriptorSet
+{
+    auto const lock = std::lock_guard{m_mutex};
+
+    auto& released = m_released[static_cast<VkDescriptorSetLayout>(layout)];
+    if(!released.empty()) {
+        auto const set = released.back();
+        released.pop_back();
+        ++m_stats.reusedSets;
+
+        return set;
+    }
+
+    if(!m_pools.empty()) {
+        auto const set =
+                try_allocate(m_boundDevice.get(), *m_pools.back(), layout);
+
+        if(set) {
+            ++m_stats.poolAllocations;
+            return *set;
+        }
+    }
+
+    m_pools.push_back(create_descriptor_pool(
+            m_boundDevice.get(),
+            m_nextPoolSize,
+            m_ratios));
+    m_nextPoolSize = std::min(m_nextPoolSize * 2, maxSetsPerPool);
+    ++m_stats.pools;
+
+    auto const set = try_allocate(m_boundDevice.get(), *m_pools.back(), layout);
+    if(!set) {
+        throw std::runtime_error(
+                "Descriptor set layout does not fit in an empty pool");
+    }
+
+    ++m_stats.poolAllocations;
+    return *set;
+}
+
+auto
+DescriptorAllocator::release(
+        vk::DescriptorSetLayout const& layout,
+        vk::DescriptorSet const set) -> void
+{
+    auto const lock = std::lock_guard{m_mutex};
+    m_released[static_cast<VkDescriptorSetLayout>(layout)].push_back(set);
+}
+
+FrameDescriptorAllocator::FrameDescriptorAllocator(
+        vk::Device const& logicalDevice,
+        uint32_t const framesInFlight,
+        uint32_t const setsPerPool,
+        std::vector<DescriptorPoolRatio> ratios) :
+            m_ratios{std::move(ratios)},
+            m_setsPerPool{setsPerPool},
+            m_frames(framesInFlight),
+            m_stats{},
+            m_boundDevice{logicalDevice}
+{
+    if(setsPerPool == 0) {
+        throw std::invalid_argument("Descriptor pools must hold a set");
+    }
+}
+
+[[nodiscard]] auto
+FrameDescriptorAllocator::boundDevice() const noexcept -> vk::Device const&
+{
+    return m_boundDevice.get();
+}
+
+[[nodiscard]] auto
+FrameDescriptorAllocator::stats() const noexcept -> DescriptorStats const&
+{
+    return m_stats;
+}
+
+auto
+FrameDescriptorAllocator::reset(uint32_t const frameIndex) -> void
+{
+    auto& frame = m_frames.at(frameIndex);
+
+    auto const used = std::min(frame.current + 1, frame.pools.size());
+    for(auto i = size_t{0}; i < used; ++i) {
+        m_boundDevice.get().resetDescriptorPool(*frame.pools[i]);
+        ++m_stats.poolResets;
+    }
+
+    frame.current = 0;
+}
+
+[[nodiscard]] auto
+FrameDescriptorAllocator::allocate(
+        uint32_t const frameIndex,
+        vk::DescriptorSetLayout const& layout) -> vk::DescriptorSet
+{
+    auto& frame = m_frames.at(frameIndex);
+
+    for(; frame.current < frame.pools.size(); ++frame.current) {
+        auto const set = try_allocate(
+                m_boundDevice.get(),
+                *frame.pools[frame.current],
+                layout);
+
+        if(set) {
+            ++m_stats.poolAllocations;
+            return *set;
+        }
+    }
+
+    frame.pools.push_back(create_descriptor_pool(
+            m_boundDevice.get(),
+            m_setsPerPool,
+            m_ratios));
+    ++m_stats.pools;
+
+    auto const set = try_allocate(
+            m_boundDevice.get(),
+            *frame.pools[frame.current],
+            layout);
+    if(!set) {
+        throw std::runtime_error(
+                "Descriptor set layout does not fit in an empty pool");
+    }
+
+    ++m_stats.poolAllocations;
+    return *set;
+}
+
+}    // namespace vulkanUtils
@@ -0,0 +1,96 @@
+#include "descriptorLayoutCache.hpp"
+#include "hashUtility.hpp"
+
+#include <algorithm>
+
+namespace vulkanUtils {
+
+[[nodiscard]] auto
+operator==(DescriptorLayoutKey const& lhs, DescriptorLayoutKey const& rhs)
+        -> bool
+{
+    return lhs.bindings == rhs.bindings;
+}
+
+[[nodiscard]] auto
+make_layout_key(std::vector<vk::DescriptorSetLayoutBinding> bindings)
+        -> DescriptorLayoutKey
+{
+    std::sort(
+            std::begin(bindings),
+            std::end(bindings),
+            [](vk::DescriptorSetLayoutBinding const& lhs,
+               vk::DescriptorSetLayoutBinding const& rhs) {
+                return lhs.binding < rhs.binding;
+            });
+
+    return {std::move(bindings)};
+}
+
+[[nodiscard]] auto
+DescriptorLayoutKeyHash::operator()(
+        DescriptorLayoutKey const& key) const noexcept -> size_t
+{
+    auto hash = key.bindings.size();
+    for(auto const& binding : key.bindings) {
+        hash = hash_combine(hash, binding.binding);
+        hash = hash_combine(
+                hash,
+                static_cast<size_t>(binding.descriptorType));
+        hash = hash_combine(hash, binding.descriptorCount);
+        hash = hash_combine(
+                hash,
+                static_cast<VkShaderStageFlags>(binding.stageFlags));
+        hash = hash_combine(
+                hash,
+                std::hash<vk::Sampler const*>{}(binding.pImmutableSamplers));
+    }
+
+    return hash;
+}
+
+DescriptorLayoutCache::DescriptorLayoutCache(
+        vk::Device const& logicalDevice) :
+            m_boundDevice{logicalDevice}
+{}
+
+[[nodiscard]] auto
+DescriptorLayoutCache::boundDevice() const noexcept -> vk::Device const&
+{
+    return m_boundDevice.get();
+}
+
+[[nodiscard]] auto
+DescriptorLayoutCache::size() const -> size_t
+{
+    auto const lock = std::lock_guard{m_mutex};
+    return m_layouts.size();
+}
+
+[[nodiscard]] auto
+DescriptorLayoutCache::get(
+        std::vector<vk::DescriptorSetLayoutBinding> bindings)
+        -> vk::DescriptorSetLayout
+{
+    auto key = make_layout_key(std::move(bindings));
+
+    auto const lock = std::lock_guard{m_mutex};
+
+    auto const cached = m_layouts.find(key);
+    if(cached != std::end(m_layouts)) {
+        return *cached->second;
+    }
+
+    auto layout = m_boundDevice.get().createDescriptorSetLayoutUnique(
+            vk::DescriptorSetLayoutCreateInfo(
+                    {},
+                    static_cast<uint32_t>(key.bindings.size()),
+                    key.bindings.data()));
+
+    auto const handle = *layout;
+    m_layouts.emplace(std::move(key), std::move(layout));
+
+    return handle;
+}
+
+}    // namespace vulkanUtils
@@ -0,0 +1,262 @@
+#include "drawBatcher.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+[[nodiscard]] auto
+create_batch_buffers(
+        vulkanUtils::MemoryAllocator& allocator,
+        uint32_t const framesInFlight,
+        uint32_t const maxDraws) -> std::vector<vulkanUtils::BatchBuffers>
+{
+    auto constexpr hostVisible = vk::MemoryPropertyFlagBits::eHostVisible
+                                 | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+    auto const instanceSize =
+            vk::DeviceSize{maxDraws} * sizeof(vulkanUtils::InstanceTransform);
+    auto const commandSize =
+            vk::DeviceSize{maxDraws} * sizeof(vk::DrawIndexedIndirectCommand);
+
+    auto frames = std::vector<vulkanUtils::BatchBuffers>{};
+    frames.reserve(framesInFlight);
+
+    for(auto i = 0u; i < framesInFlight; ++i) {
+        frames.push_back(
+                {allocator.create_buffer(
+                         vk::BufferCreateInfo(
+                                 {},
+                                 instanceSize,
+                                 vk::BufferUsageFlagBits::eVertexBuffer,
+                                 vk::SharingMode::eExclusive),
+                         hostVisible),
+                 allocator.create_buffer(
+                         vk::BufferCreateInfo(
+                                 {},
+                                 commandSize,
+                                 vk::BufferUsageFlagBits::eIndirectBuffer,
+                                 vk::SharingMode::eExclusive),
+                         hostVisible)});
+    }
+
+    return frames;
+}
+
+[[nodiscard]] auto
+same_geometry(
+        vulkanUtils::SubMesh const& lhs,
+        vulkanUtils::SubMesh const& rhs) noexcept -> bool
+{
+    return lhs.indexCount == rhs.indexCount && lhs.firstIndex == rhs.firstIndex
+           && lhs.vertexOffset == rhs.vertexOffset;
+}
+
+namespace vulkanUtils {
+
+auto
+build_batches(
+        std::vector<QueuedDraw>& draws,
+        std::vector<vk::DrawIndexedIndirectCommand>& commands,
+        std::vector<IndirectBatch>& batches) -> void
+{
+    std::sort(
+            std::begin(draws),
+            std::end(draws),
+            [](QueuedDraw const& lhs, QueuedDraw const& rhs) {
+                if(lhs.pipeline != rhs.pipeline) {
+                    return lhs.pipeline < rhs.pipeline;
+                }
+
+                if(lhs.mesh != rhs.mesh) {
+                    return std::less<>{}(lhs.mesh, rhs.mesh);
+                }
+
+                return std::tie(
+                               lhs.subMesh.firstIndex,
+                               lhs.subMesh.vertexOffset,
+                               lhs.subMesh.indexCount)
+                       < std::tie(
+                               rhs.subMesh.firstIndex,
+                               rhs.subMesh.vertexOffset,
+                               rhs.subMesh.indexCount);
+            });
+
+    commands.clear();
+    batches.clear();
+
+    for(auto i = 0u; i < draws.size(); ++i) {
+        auto const& draw = draws[i];
+
+        auto const newBatch = batches.empty()
+                              || batches.back().pipeline != draw.pipeline
+                              || batches.back().mesh != draw.mesh;
+
+        if(newBatch) {
+            batches.push_back(
+                    {draw.pipeline,
+                     draw.mesh,
+                     static_cast<uint32_t>(commands.size()),
+                     0});
+        }
+
+        if(newBatch || !same_geometry(draws[i - 1].subMesh, draw.subMesh)) {
+            commands.emplace_back(
+                    draw.subMesh.indexCount,
+                    0,
+                    draw.subMesh.firstIndex,
+                    draw.subMesh.vertexOffset,
+                    i);
+            ++batches.back().commandCount;
+        }
+
+        ++commands.back().instanceCount;
+    }
+}
+
+DrawBatcher::DrawBatcher(
+        vk::Device const& logicalDevice,
+        MemoryAllocator& allocator,
+        vk::PhysicalDeviceFeatures const& features,
+        uint32_t const framesInFlight,
+        uint32_t const maxDraws) :
+            m_maxDraws{maxDraws},
+            m_multiDrawIndirect{features.multiDrawIndirect == VK_TRUE},
+            m_indirectFirstInstance{
+                    features.drawIndirectFirstInstance == VK_TRUE},
+            m_frames{create_batch_buffers(allocator, framesInFlight, maxDraws)},
+            m_draws{},
+            m_commands{},
+            m_batches{},
+            m_stats{},
+            m_boundDevice{logicalDevice}
+{
+    m_draws.reserve(maxDraws);
+    m_commands.reserve(maxDraws);
+}
+
+[[nodiscard]] auto
+DrawBatcher::boundDevice() const noexcept -> vk::Device const&
+{
+    return m_boundDevice.get();
+}
+
+[[nodiscard]] auto
+DrawBatcher::stats() const noexcept -> DrawBatchStats const&
+{
+    return m_stats;
+}
+
+auto
+DrawBatcher::add(
+        vk::Pipeline const& pipeline,
+        MeshBuffer const& mesh,
+        SubMesh const& subMesh,
+        InstanceTransform const& instance) -> void
+{
+    if(m_draws.size() == m_maxDraws) {
+        throw std::runtime_error(
+                "Draw batcher is full at " + std::to_string(m_maxDraws)
+                + " draws");
+    }
+
+    m_draws.push_back({pipeline, &mesh, subMesh, instance});
+}
+
+auto
+DrawBatcher::record(
+        vk::CommandBuffer const& commandBuffer,
+        uint32_t const frameIndex) -> void
+{
+    auto const& frame = m_frames.at(frameIndex);
+
+    build_batches(m_draws, m_commands, m_batches);
+
+    auto* const instances = static_cast<InstanceTransform*>(
+            frame.instances.allocation.mapped());
+    for(auto i = size_t{0}; i < m_draws.size(); ++i) {
+        instances[i] = m_draws[i].instance;
+    }
+
+    auto* const commands = static_cast<vk::DrawIndexedIndirectCommand*>(
+            frame.commands.allocation.mapped());
+    for(auto i = size_t{0}; i < m_commands.size(); ++i) {
+        commands[i] = m_commands[i];
+
+        if(!m_indirectFirstInstance) {
+            commands[i].firstInstance = 0;
+        }
+    }
+
+    m_stats = {static_cast<uint32_t>(m_draws.size()),
+               static_cast<uint32_t>(m_commands.size()),
+               0};
+
+    auto constexpr instanceOffset = vk::DeviceSize{0};
+    commandBuffer.bindVertexBuffers(1, *frame.instances.buffer, instanceOffset);
+
+    auto boundPipeline = vk::Pipeline{};
+    for(auto const& batch : m_batches) {
+        if(batch.pipeline != boundPipeline) {
+            commandBuffer.bindPipeline(
+                    vk::PipelineBindPoint::eGraphics,
+                    batch.pipeline);
+            boundPipeline = batch.pipeline;
+        }
+
+        batch.mesh->bind(commandBuffer);
+        record_indirect(
+                commandBuffer,
+                frame,
+                batch.firstCommand,
+                batch.commandCount);
+    }
+
+    m_draws.clear();
+}
+
+// Without multiDrawIndirect every command needs its own call, and without
+// drawIndirectFirstInstance the instance buffer is rebound at each command's
+// first instance instead.
+auto
+DrawBatcher::record_indirect(
+        vk::CommandBuffer const& commandBuffer,
+        BatchBuffers const& frame,
+        uint32_t const firstCommand,
+        uint32_t const commandCount) -> void
+{
+    auto constexpr stride = uint32_t{sizeof(vk::DrawIndexedIndirectCommand)};
+
+    if(m_multiDrawIndirect && m_indirectFirstInstance) {
+        commandBuffer.drawIndexedIndirect(
+                *frame.commands.buffer,
+                vk::DeviceSize{firstCommand} * stride,
+                commandCount,
+                stride);
+        ++m_stats.indirectCalls;
+
+        return;
+    }
+
+    for(auto i = firstCommand; i < firstCommand + commandCount; ++i) {
+        if(!m_indirectFirstInstance) {
+            auto const instanceOffset =
+                    vk::DeviceSize{m_commands[i].firstInstance}
+                    * sizeof(InstanceTransform);
+            commandBuffer.bindVertexBuffers(
+                    1,
+                    *frame.instances.buffer,
+                    instanceOffset);
+        }
+
+        commandBuffer.drawIndexedIndirect(
+                *frame.commands.buffer,
+                vk::DeviceSize{i} * stride,
+                1,
+                stride);
+        ++m_stats.indirectCalls;
+    }
+}
+
+}    // namespace vulkanUtils
@@ -0,0 +1,118 @@
+#include "frameRing.hpp"
+
+#include <algorithm>
+#include <limits>
+
+[[nodiscard]] auto
+create_frame_contexts(
+        vk::Device const& logicalDevice,
+        uint32_t const depth) -> std::vector<vulkanUtils::FrameContext>
+{
+    if(depth == 0) {
+        throw std::invalid_argument("At least one frame must be in flight");
+    }
+
+    auto frames = std::vector<vulkanUtils::FrameContext>{};
+    frames.reserve(depth);
+
+    for(auto i = 0u; i < depth; ++i) {
+        frames.push_back(
+                {logicalDevice.createSemaphoreUnique({}),
+                 logicalDevice.createSemaphoreUnique({}),
+                 logicalDevice.createFenceUnique(
+                         {vk::FenceCreateFlagBits::eSignaled})});
+    }
+
+    return frames;
+}
+
+auto
+wait_for_fence(vk::Device const& logicalDevice, vk::Fence const& fence)
+        -> void
+{
+    auto const signaled = logicalDevice.waitForFences(
+            fence,
+            VK_TRUE,
+            std::numeric_limits<uint64_t>::max());
+
+    if(signaled != vk::Result::eSuccess) {
+        throw std::runtime_error("Fence could not be signaled\n");
+    }
+}
+
+namespace vulkanUtils {
+
+FrameRing::FrameRing(
+        vk::Device const& logicalDevice,
+        uint32_t const depth,
+        size_t const imageCount) :
+            m_frames{create_frame_contexts(logicalDevice, depth)},
+            m_imagesInFlight(imageCount),
+            m_current{0},
+            m_frameNumber{0},
+            m_boundDevice{logicalDevice}
+{}
+
+[[nodiscard]] auto
+FrameRing::boundDevice() const noexcept -> vk::Device const&
+{
+    return m_boundDevice.get();
+}
+
+[[nodiscard]] auto
+FrameRing::depth() const noexcept -> uint32_t
+{
+    return static_cast<uint32_t>(m_frames.size());
+}
+
+[[nodiscard]] auto
+FrameRing::currentIndex() const noexcept -> uint32_t
+{
+    return m_current;
+}
+
+[[nodiscard]] auto
+FrameRing::current() const noexcept -> FrameContext const&
+{
+    return m_frames[m_current];
+}
+
+[[nodiscard]] auto
+FrameRing::frameNumber() const noexcept -> uint64_t
+{
+    return m_frameNumber;
+}
+
+auto
+FrameRing::wait_for_current() const -> void
+{
+    wait_for_fence(m_boundDevice.get(), *current().inFlight);
+}
+
+auto
+FrameRing::claim_image(uint32_t const imageIndex) -> void
+{
+    auto& imageFence         = m_imagesInFlight.at(imageIndex);
+    auto const& currentFence = *current().inFlight;
+
+    if(imageFence && imageFence != currentFence) {
+        wait_for_fence(m_boundDevice.get(), imageFence);
+    }
+
+    imageFence = currentFence;
+}
+
+auto
+FrameRing::advance() noexcept -> void
+{
+    m_current = (m_current + 1) % depth();
+    ++m_frameNumber;
+}
+
+auto
+FrameRing::reset_images(size_t const imageCount) -> void
+{
+    m_imagesInFlight.assign(imageCount, vk::Fence{});
+}
+
+}    // namespace vulkanUtils
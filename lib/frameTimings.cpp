@@ -0,0 +1,97 @@
+#include "frameTimings.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+
+namespace vulkanUtils {
+
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+[[nodiscard]] auto
+nearest_rank(
+        std::vector<std::chrono::nanoseconds> const& sortedSamples,
+        double const percentile) -> double
+{
+    auto const rank = static_cast<size_t>(
+            std::ceil(percentile / 100.0 * sortedSamples.size()));
+
+    auto const index = std::clamp<size_t>(rank, 1, sortedSamples.size()) - 1;
+
+    return Milliseconds(sortedSamples[index]).count();
+}
+
+[[nodiscard]] auto
+percentiles(std::vector<std::chrono::nanoseconds> samples) -> TimingPercentiles
+{
+    if(samples.empty()) {
+        return {};
+    }
+
+    std::sort(std::begin(samples), std::end(samples));
+
+    auto const sum = std::accumulate(
+            std::cbegin(samples),
+            std::cend(samples),
+            std::chrono::nanoseconds{});
+
+    return {nearest_rank(samples, 50.0),
+            nearest_rank(samples, 95.0),
+            nearest_rank(samples, 99.0),
+            Milliseconds(sum).count() / samples.size(),
+            Milliseconds(samples.back()).count()};
+}
+
+[[nodiscard]] auto
+percentiles(
+        std::vector<FrameTimings> const& frames,
+        std::chrono::nanoseconds FrameTimings::*step) -> TimingPercentiles
+{
+    auto samples = std::vector<std::chrono::nanoseconds>(frames.size());
+    std::transform(
+            std::cbegin(frames),
+            std::cend(frames),
+            std::begin(samples),
+            [step](FrameTimings const& frame) { return frame.*step; });
+
+    return percentiles(std::move(samples));
+}
+
+auto
+write_json(std::ostream& stream, TimingPercentiles const& timings)
+        -> std::ostream&
+{
+    return stream << "{\"p50_ms\": " << timings.p50Ms
+                  << ", \"p95_ms\": " << timings.p95Ms
+                  << ", \"p99_ms\": " << timings.p99Ms
+                  << ", \"mean_ms\": " << timings.meanMs
+                  << ", \"max_ms\": " << timings.maxMs << "}";
+}
+
+auto
+write_json(std::ostream& stream, std::string_view const value)
+        -> std::ostream&
+{
+    stream << '"';
+
+    for(auto const c : value) {
+        if(c == '"' || c == '\\') {
+            stream << '\\' << c;
+        }
+        else if(static_cast<unsigned char>(c) < 0x20) {
+            auto const flags = stream.flags();
+            auto const fill  = stream.fill('0');
+            stream << "\\u" << std::hex << std::setw(4) << static_cast<int>(c);
+            stream.fill(fill);
+            stream.flags(flags);
+        }
+        else {
+            stream << c;
+        }
+    }
+
+    return stream << '"';
+}
+
+}    // namespace vulkanUtils
@@ -0,0 +1,226 @@
+#include "gpuTimer.hpp"
+
+#include <algorithm>
+
+[[nodiscard]] auto
+timestamp_mask(uint32_t const validBits) noexcept -> uint64_t
+{
+    return validBits >= 64u ? ~uint64_t{0} : (uint64_t{1} << validBits) - 1u;
+}
+
+[[nodiscard]] auto
+create_query_pools(
+        vk::Device const& logicalDevice,
+        uint32_t const poolCount,
+        uint32_t const queriesPerPool,
+        bool const timestampsSupported) -> std::vector<vk::UniqueQueryPool>
+{
+    if(!timestampsSupported) {
+        return {};
+    }
+
+    auto const creationInfo = vk::QueryPoolCreateInfo(
+            {},
+            vk::QueryType::eTimestamp,
+            queriesPerPool);
+
+    auto pools = std::vector<vk::UniqueQueryPool>(poolCount);
+    std::generate(std::begin(pools), std::end(pools), [&] {
+        return logicalDevice.createQueryPoolUnique(creationInfo);
+    });
+
+    return pools;
+}
+
+namespace vulkanUtils {
+
+DurationRing::DurationRing(size_t const capacity) :
+            m_samples(std::max<size_t>(capacity, 1)),
+            m_next{0},
+            m_size{0}
+{}
+
+auto
+DurationRing::push(std::chrono::nanoseconds const duration) -> void
+{
+    m_samples[m_next] = duration;
+    m_next            = (m_next + 1) % m_samples.size();
+    m_size            = std::min(m_size + 1, m_samples.size());
+}
+
+[[nodiscard]] auto
+DurationRing::latest() const noexcept -> std::chrono::nanoseconds
+{
+    if(m_size == 0) {
+        return {};
+    }
+
+    return m_samples[(m_next + m_samples.size() - 1) % m_samples.size()];
+}
+
+[[nodiscard]] auto
+DurationRing::samples() const -> std::vector<std::chrono::nanoseconds>
+{
+    auto const oldest = (m_next + m_samples.size() - m_size) % m_samples.size();
+
+    auto ordered = std::vector<std::chrono::nanoseconds>{};
+    ordered.reserve(m_size);
+
+    for(auto i = 0u; i < m_size; ++i) {
+        ordered.push_back(m_samples[(oldest + i) % m_samples.size()]);
+    }
+
+    return ordered;
+}
+
+[[nodiscard]] auto
+DurationRing::size() const noexcept -> size_t
+{
+    return m_size;
+}
+
+GpuTimer::Scope::Scope(
+        GpuTimer& timer,
+        vk::CommandBuffer const& commandBuffer,
+        uint32_t const query) noexcept :
+            m_timer{timer},
+            m_commandBuffer{commandBuffer},
+            m_query{query}
+{}
+
+GpuTimer::Scope::~Scope()
+{
+    if(m_query != noQuery) {
+        m_timer.get().write_timestamp(
+                m_commandBuffer,
+                vk::PipelineStageFlagBits::eBottomOfPipe,
+                m_query);
+    }
+}
+
+GpuTimer::GpuTimer(
+        vk::Device const& logicalDevice,
+        vk::PhysicalDeviceLimits const& limits,
+        vk::QueueFamilyProperties const& queueFamily,
+        uint32_t const framesInFlight,
+        uint32_t const maxScopes,
+        size_t const historyCapacity) :
+            m_timestampPeriod{static_cast<double>(limits.timestampPeriod)},
+            m_timestampMask{timestamp_mask(queueFamily.timestampValidBits)},
+            m_maxScopes{maxScopes},
+            m_historyCapacity{historyCapacity},
+            m_queryPools{create_query_pools(
+                    logicalDevice,
+                    framesInFlight,
+                    maxScopes * 2,
+                    queueFamily.timestampValidBits != 0)},
+            m_frameScopes(framesInFlight),
+            m_results(maxScopes * 2),
+            m_currentFrame{0},
+            m_history{},
+            m_boundDevice{logicalDevice}
+{}
+
+[[nodiscard]] auto
+GpuTimer::boundDevice() const noexcept -> vk::Device const&
+{
+    return m_boundDevice.get();
+}
+
+[[nodiscard]] auto
+GpuTimer::supported() const noexcept -> bool
+{
+    return !m_queryPools.empty();
+}
+
+auto
+GpuTimer::collect(uint32_t const frameIndex) -> void
+{
+    if(!supported()) {
+        return;
+    }
+
+    auto& scopes = m_frameScopes[frameIndex];
+    if(scopes.empty()) {
+        return;
+    }
+
+    auto const queryCount = static_cast<uint32_t>(scopes.size() * 2);
+    auto const result     = m_boundDevice.get().getQueryPoolResults(
+            *m_queryPools[frameIndex],
+            0,
+            queryCount,
+            queryCount * sizeof(uint64_t),
+            m_results.data(),
+            sizeof(uint64_t),
+            vk::QueryResultFlagBits::e64);
+
+    if(result == vk::Result::eSuccess) {
+        for(auto i = 0u; i < scopes.size(); ++i) {
+            auto const begin = m_results[2 * i] & m_timestampMask;
+            auto const end   = m_results[2 * i + 1] & m_timestampMask;
+            auto const ticks = (end - begin) & m_timestampMask;
+
+            auto const duration = std::chrono::nanoseconds{
+                    static_cast<int64_t>(ticks * m_timestampPeriod)};
+
+            m_history.try_emplace(scopes[i], m_historyCapacity)
+                    .first->second.push(duration);
+        }
+    }
+
+    scopes.clear();
+}
+
+auto
+GpuTimer::begin_frame(
+        vk::CommandBuffer const& commandBuffer,
+        uint32_t const frameIndex) -> void
+{
+    m_currentFrame = frameIndex;
+
+    if(!supported()) {
+        return;
+    }
+
+    m_frameScopes[frameIndex].clear();
+    commandBuffer.resetQueryPool(*m_queryPools[frameIndex], 0, m_maxScopes * 2);
+}
+
+[[nodiscard]] auto
+GpuTimer::scope(vk::CommandBuffer const& commandBuffer, std::string_view name)
+        -> Scope
+{
+    if(!supported() || m_frameScopes[m_currentFrame].size() >= m_maxScopes) {
+        return Scope{*this, commandBuffer, noQuery};
+    }
+
+    auto& scopes     = m_frameScopes[m_currentFrame];
+    auto const query = static_cast<uint32_t>(scopes.size() * 2);
+    scopes.emplace_back(name);
+
+    write_timestamp(
+            commandBuffer,
+            vk::PipelineStageFlagBits::eTopOfPipe,
+            query);
+
+    return Scope{*this, commandBuffer, query + 1};
+}
+
+[[nodiscard]] auto
+GpuTimer::history() const noexcept
+        -> std::map<std::string, DurationRing> const&
+{
+    return m_history;
+}
+
+auto
+GpuTimer::write_timestamp(
+        vk::CommandBuffer const& commandBuffer,
+        vk::PipelineStageFlagBits const stage,
+        uint32_t const query) -> void
+{
+    commandBuffer.writeTimestamp(stage, *m_queryPools[m_currentFrame], query);
+}
+
+}    // namespace vulkanUtils
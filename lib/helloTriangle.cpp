@@ -2,13 +2,35 @@
 
 #include "glfwUtility.hpp"
 #include "vulkanUtility.hpp"
+#include "computePipeline.hpp"
 
 #include <vulkan/vulkan.hpp>
 #include <GLFW/glfw3.h>
 #include <gsl/gsl>
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
 #include <string>
+#include <utility>
+
+using RecordFunction = std::function<RecordedFrame(uint32_t, uint32_t)>;
+
+auto constexpr defaultHeadlessFrames = uint32_t{300};
+
+// Without a window to close, a headless run asked for 0 frames would render
+// nothing at all.
+[[nodiscard]] auto
+resolve_settings(RenderSettings settings) noexcept -> RenderSettings
+{
+    if(settings.headless && settings.frameCount == 0) {
+        settings.frameCount = defaultHeadlessFrames;
+    }
+
+    return settings;
+}
 
 [[nodiscard]] auto
 create_index_list(
@@ -25,121 +47,935 @@ create_index_list(
             static_cast<unsigned int>(presentation.position)};
 }
 
-[[nodiscard]] auto
+// Recorded before the render pass when the triangles are animated.
+struct AnimationPass {
+    vulkanUtils::ComputeDispatch dispatch;
+    AnimationConstants constants;
+};
+
+// What every command buffer drawing the triangles binds before drawing.
+struct FrameBindings {
+    vk::PipelineLayout pipelineLayout;
+    vk::DescriptorSet frameSet;
+    uint32_t frameOffset;
+    DrawConstants constants;
+};
+
+auto
+bind_frame(
+        vk::CommandBuffer const& commandBuffer,
+        FrameBindings const& bindings) -> void
+{
+    commandBuffer.bindDescriptorSets(
+            vk::PipelineBindPoint::eGraphics,
+            bindings.pipelineLayout,
+            0,
+            bindings.frameSet,
+            bindings.frameOffset);
+
+    commandBuffer.pushConstants<DrawConstants>(
+            bindings.pipelineLayout,
+            vk::ShaderStageFlagBits::eVertex,
+            0,
+            bindings.constants);
+}
+
+// Also used for secondary command buffers, which inherit none of this state.
+auto
+record_draws(
+        vk::CommandBuffer const& commandBuffer,
+        vk::Pipeline const& pipeline,
+        FrameBindings const& bindings,
+        vk::Extent2D const dimensions,
+        vulkanUtils::MeshBuffer const& mesh,
+        vk::Buffer const& instances,
+        gsl::span<vk::DrawIndexedIndirectCommand const> const draws) -> void
+{
+    auto constexpr instanceOffset = vk::DeviceSize{0};
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+    bind_frame(commandBuffer, bindings);
+
+    commandBuffer.setViewport(
+            0,
+            vulkanUtils::create_viewport(dimensions.width, dimensions.height));
+    commandBuffer.setScissor(0, vk::Rect2D{{0, 0}, dimensions});
+
+    mesh.bind(commandBuffer);
+    commandBuffer.bindVertexBuffers(1, instances, instanceOffset);
+
+    for(auto const& draw : draws) {
+        commandBuffer.drawIndexed(
+                draw.indexCount,
+                draw.instanceCount,
+                draw.firstIndex,
+                draw.vertexOffset,
+                draw.firstInstance);
+    }
+}
+
+auto
 record_commands(
         vk::UniqueRenderPass const& renderPass,
         vk::UniqueFramebuffer const& framebuffer,
         vk::Extent2D dimensions,
-        vk::UniquePipeline const& pipeline,
-        vk::UniqueCommandBuffer& commandBuffer)
+        vk::Pipeline const& pipeline,
+        FrameBindings const& bindings,
+        vulkanUtils::MeshBuffer const& mesh,
+        vk::Buffer const& instances,
+        gsl::span<vk::DrawIndexedIndirectCommand const> const draws,
+        vulkanUtils::ParallelRecorder* const recorder,
+        vulkanUtils::DrawBatcher* const batcher,
+        std::vector<vk::BufferMemoryBarrier> const& uploadBarriers,
+        AnimationPass const* const animation,
+        vk::CommandBuffer const& commandBuffer,
+        vulkanUtils::GpuTimer& gpuTimer,
+        uint32_t const frameIndex) -> void
 {
-    auto constexpr beginInfo = vk::CommandBufferBeginInfo{};
+    auto constexpr beginInfo = vk::CommandBufferBeginInfo{
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit};
 
-    commandBuffer->begin(beginInfo);
+    commandBuffer.begin(beginInfo);
+    gpuTimer.begin_frame(commandBuffer, frameIndex);
 
-    auto const clearColour = vk::ClearValue{{{std::array{0.f, 0.f, 0.f, 1.f}}}};
+    // Chained to the upload semaphore, which is waited on at vertex input.
+    if(!uploadBarriers.empty()) {
+        commandBuffer.pipelineBarrier(
+                vk::PipelineStageFlagBits::eVertexInput,
+                vk::PipelineStageFlagBits::eVertexInput,
+                {},
+                nullptr,
+                uploadBarriers,
+                nullptr);
+    }
 
-    auto const renderPassBeginInfo = vk::RenderPassBeginInfo(
-            *renderPass,
-            *framebuffer,
-            vk::Rect2D{{0, 0}, dimensions},
-            1,
-            &clearColour);
+    if(animation != nullptr) {
+        auto const timedScope = gpuTimer.scope(commandBuffer, "compute");
+
+        commandBuffer.pushConstants<AnimationConstants>(
+                animation->dispatch.layout,
+                vk::ShaderStageFlagBits::eCompute,
+                0,
+                animation->constants);
+
+        // The previous frame's draws may still be reading the instances
+        // about to be overwritten.
+        vulkanUtils::record_dispatch(
+                commandBuffer,
+                animation->dispatch,
+                {vk::PipelineStageFlagBits::eVertexInput,
+                 {},
+                 vk::PipelineStageFlagBits::eVertexInput,
+                 vk::AccessFlagBits::eVertexAttributeRead});
+    }
 
-    commandBuffer->beginRenderPass(
-            renderPassBeginInfo,
-            vk::SubpassContents::eInline);
+    {
+        auto const timedScope = gpuTimer.scope(commandBuffer, "render_pass");
 
-    commandBuffer->bindPipeline(vk::PipelineBindPoint::eGraphics, *pipeline);
+        auto const clearColour =
+                vk::ClearValue{{{std::array{0.f, 0.f, 0.f, 1.f}}}};
 
-    commandBuffer->draw(3, 1, 0, 0);
+        auto const renderPassBeginInfo = vk::RenderPassBeginInfo(
+                *renderPass,
+                *framebuffer,
+                vk::Rect2D{{0, 0}, dimensions},
+                1,
+                &clearColour);
+
+        // Still compiling, the pass only clears the image.
+        if(!pipeline) {
+            commandBuffer.beginRenderPass(
+                    renderPassBeginInfo,
+                    vk::SubpassContents::eInline);
+        }
+        else if(batcher != nullptr) {
+            commandBuffer.beginRenderPass(
+                    renderPassBeginInfo,
+                    vk::SubpassContents::eInline);
+
+            commandBuffer.setViewport(
+                    0,
+                    vulkanUtils::create_viewport(
+                            dimensions.width,
+                            dimensions.height));
+            commandBuffer.setScissor(0, vk::Rect2D{{0, 0}, dimensions});
+
+            bind_frame(commandBuffer, bindings);
+            batcher->record(commandBuffer, frameIndex);
+        }
+        else if(recorder == nullptr) {
+            commandBuffer.beginRenderPass(
+                    renderPassBeginInfo,
+                    vk::SubpassContents::eInline);
 
-    commandBuffer->endRenderPass();
-    commandBuffer->end();
+            record_draws(
+                    commandBuffer,
+                    pipeline,
+                    bindings,
+                    dimensions,
+                    mesh,
+                    instances,
+                    draws);
+        }
+        else {
+            commandBuffer.beginRenderPass(
+                    renderPassBeginInfo,
+                    vk::SubpassContents::eSecondaryCommandBuffers);
+
+            auto const inheritance = vk::CommandBufferInheritanceInfo(
+                    *renderPass,
+                    0,
+                    *framebuffer);
+
+            auto const& secondaries = recorder->record(
+                    frameIndex,
+                    inheritance,
+                    static_cast<uint32_t>(draws.size()),
+                    [&](vk::CommandBuffer const& secondary,
+                        uint32_t const first,
+                        uint32_t const count) {
+                        record_draws(
+                                secondary,
+                                pipeline,
+                                bindings,
+                                dimensions,
+                                mesh,
+                                instances,
+                                draws.subspan(first, count));
+                    });
+
+            commandBuffer.executeCommands(secondaries);
+        }
+
+        commandBuffer.endRenderPass();
+    }
+
+    commandBuffer.end();
 }
 
+// Clamped the way create_swap_chain clamps it, so that framebuffers and
+// viewports match the images it creates.
 [[nodiscard]] auto
-record_commands_to_command_buffers(
-        vk::UniqueRenderPass const& renderPass,
-        std::vector<vk::UniqueFramebuffer> const& framebuffers,
-        vk::Extent2D dimensions,
-        vk::UniquePipeline const& pipeline,
-        std::vector<vk::UniqueCommandBuffer>&& commandBuffers)
-        -> std::vector<vk::UniqueCommandBuffer>
+swap_chain_extent(
+        vk::SurfaceCapabilitiesKHR const& surfaceCaps,
+        vk::Extent2D const requestedExtent) -> vk::Extent2D
+{
+    auto constexpr extentIsUndefined = std::numeric_limits<uint32_t>::max();
+
+    if(surfaceCaps.currentExtent.width != extentIsUndefined) {
+        return surfaceCaps.currentExtent;
+    }
+
+    return vulkanUtils::clamp_extent_dimensions(
+            surfaceCaps.minImageExtent,
+            surfaceCaps.maxImageExtent,
+            requestedExtent);
+}
+
+[[nodiscard]] auto
+instance_extensions(bool const headless) -> std::vector<char const*>
+{
+    auto extensions = headless ? std::vector<char const*>{}
+                               : glfwUtils::required_vk_extensions();
+    extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+
+    return extensions;
+}
+
+[[nodiscard]] auto
+required_device_features() noexcept -> vk::PhysicalDeviceFeatures
+{
+    auto features           = vk::PhysicalDeviceFeatures{};
+    features.geometryShader = VK_TRUE;
+
+    return features;
+}
+
+auto constexpr uniformRegionSize = vk::DeviceSize{64} * 1024;
+
+// constant_id 0 in triangle.vert, whether the draw constants' tint is
+// applied.
+using TriangleVariant = shaderUtils::SpecializationPack<
+        shaderUtils::SpecializationConstant<0, bool>>;
+
+auto constexpr drawConstantsRange = vk::PushConstantRange(
+        vk::ShaderStageFlagBits::eVertex,
+        0,
+        sizeof(DrawConstants));
+
+[[nodiscard]] auto
+frame_set_bindings() -> std::vector<vk::DescriptorSetLayoutBinding>
+{
+    return {{0,
+             vk::DescriptorType::eUniformBufferDynamic,
+             1,
+             vk::ShaderStageFlagBits::eVertex}};
+}
+
+// Points at the start of the uniform ring, each frame binds it with the
+// offset of its own uniforms.
+[[nodiscard]] auto
+create_frame_set(
+        vk::Device const& logicalDevice,
+        vulkanUtils::DescriptorAllocator& descriptors,
+        vk::DescriptorSetLayout const& layout,
+        vk::Buffer const& uniforms) -> vk::DescriptorSet
+{
+    auto const set = descriptors.allocate(layout);
+    vulkanUtils::write_dynamic_uniform(
+            logicalDevice,
+            set,
+            0,
+            uniforms,
+            0,
+            sizeof(FrameUniforms));
+
+    return set;
+}
+
+[[nodiscard]] auto
+triangle_pipeline_description(
+        shaderUtils::VertexShader const& vertexShader,
+        shaderUtils::FragmentShader const& fragmentShader,
+        vk::PipelineLayout const& layout,
+        vk::RenderPass const& renderPass)
+        -> vulkanUtils::GraphicsPipelineDescription
 {
-    if(framebuffers.size() != commandBuffers.size()) {
+    auto description = vulkanUtils::default_pipeline_description();
+
+    description.stages = {
+            vulkanUtils::shader_stage_description(vertexShader),
+            vulkanUtils::shader_stage_description(fragmentShader)};
+
+    vulkanUtils::set_vertex_input(
+            description,
+            vulkanUtils::instancedVertexInputState<
+                    vulkanUtils::ColouredVertex,
+                    vulkanUtils::InstanceTransform>);
+
+    description.layout     = layout;
+    description.renderPass = renderPass;
+
+    return description;
+}
+
+// Frames are recorded against the frame set and the draw constants, so the
+// layout the shaders reflect to has to be exactly that. Throws if it isn't,
+// or if the vertex shader reads an input the triangles don't provide.
+[[nodiscard]] auto
+triangle_layout_description(
+        shaderUtils::VertexShader const& vertexShader,
+        shaderUtils::FragmentShader const& fragmentShader)
+        -> shaderUtils::PipelineLayoutDescription
+{
+    auto layout = shaderUtils::merge_reflections(
+            {vertexShader.reflection.get(), fragmentShader.reflection.get()});
+    shaderUtils::make_dynamic(layout, 0, 0);
+
+    auto const recorded = shaderUtils::PipelineLayoutDescription{
+            {frame_set_bindings()},
+            {drawConstantsRange}};
+
+    if(layout != recorded) {
         throw std::runtime_error(
-                "Framebuffer and commandBuffer vectors are not the same size!");
+                "Shader interface does not match the frame set and draw "
+                "constants");
     }
 
-    for(auto i = 0u; i < framebuffers.size(); ++i) {
-        record_commands(
-                renderPass,
-                framebuffers[i],
-                dimensions,
-                pipeline,
-                commandBuffers[i]);
+    shaderUtils::verify_vertex_input(
+            *vertexShader.reflection,
+            vulkanUtils::instancedAttributes<
+                    vulkanUtils::ColouredVertex,
+                    vulkanUtils::InstanceTransform>);
+
+    return layout;
+}
+
+auto constexpr animationGroupSize = uint32_t{64};
+
+// constant_id 0 in instances.comp, its work group size.
+using AnimationVariant = shaderUtils::SpecializationPack<
+        shaderUtils::SpecializationConstant<0, uint32_t>>;
+
+// Throws unless the shader matches the buffers and constants recorded into
+// the animation pass.
+[[nodiscard]] auto
+animation_layout_description(shaderUtils::ComputeShader const& shader)
+        -> shaderUtils::PipelineLayoutDescription
+{
+    auto const layout =
+            shaderUtils::merge_reflections({shader.reflection.get()});
+
+    auto constexpr stage = vk::ShaderStageFlagBits::eCompute;
+    auto const recorded  = shaderUtils::PipelineLayoutDescription{
+            {{{0, vk::DescriptorType::eStorageBuffer, 1, stage},
+              {1, vk::DescriptorType::eStorageBuffer, 1, stage}}},
+            {vk::PushConstantRange(stage, 0, sizeof(AnimationConstants))}};
+
+    if(layout != recorded) {
+        throw std::runtime_error(
+                "instances.comp does not match the animation's buffers and "
+                "constants");
     }
 
-    return std::move(commandBuffers);
+    return layout;
 }
 
-HelloTriangle::HelloTriangle() :
-            m_window{glfwUtils::create_window(width, height, false, "test")},
-            m_extensions{[] {
-                auto glfwExtensions = glfwUtils::required_vk_extensions();
-                glfwExtensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
-                return glfwExtensions;
-            }()},
-            m_instance{m_validationLayers, m_extensions},
+// The instances are read from the uploaded buffer and written to a second
+// one of the same size, so the animation never drifts from the grid.
+[[nodiscard]] auto
+create_instance_animation(
+        vk::Device const& logicalDevice,
+        shaderUtils::ShaderModuleCache& modules,
+        vulkanUtils::MemoryAllocator& allocator,
+        vulkanUtils::DescriptorLayoutCache& descriptorLayouts,
+        vulkanUtils::PipelineLayoutCache& pipelineLayouts,
+        vulkanUtils::DescriptorAllocator& descriptors,
+        vulkanUtils::PipelineCache& pipelineCache,
+        vk::Buffer const& instances,
+        vk::DeviceSize const instancesSize) -> InstanceAnimation
+{
+    auto shader = shaderUtils::ComputeShader{
+            modules,
+            "instances",
+            AnimationVariant::values(animationGroupSize)};
+
+    auto const layout = animation_layout_description(shader);
+
+    auto animated = allocator.create_buffer(
+            vk::BufferCreateInfo(
+                    {},
+                    instancesSize,
+                    vk::BufferUsageFlagBits::eStorageBuffer
+                            | vk::BufferUsageFlagBits::eVertexBuffer,
+                    vk::SharingMode::eExclusive),
+            vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+    auto const set =
+            descriptors.allocate(descriptorLayouts.get(layout.sets[0]));
+    vulkanUtils::write_storage_buffer(logicalDevice, set, 0, instances);
+    vulkanUtils::write_storage_buffer(logicalDevice, set, 1, *animated.buffer);
+
+    auto const pipelineLayout = pipelineLayouts.get(layout);
+    auto pipeline             = vulkanUtils::create_compute_pipeline(
+            pipelineCache,
+            vulkanUtils::shader_stage_description(shader),
+            pipelineLayout);
+
+    return {std::move(shader),
+            std::move(animated),
+            pipelineLayout,
+            std::move(pipeline),
+            set};
+}
+
+// Returns false if the change is for another shader. Pipelines using the old
+// module are retired along with it. A source that fails to compile, or that
+// verify rejects once reloaded, throws and leaves the shader and the module
+// cache as they were.
+template<shaderUtils::ShaderType Type>
+auto
+reload_shader(
+        shaderUtils::Shader<Type>& shader,
+        shaderUtils::ShaderChange const& change,
+        shaderUtils::ShaderModuleCache& modules,
+        vulkanUtils::PipelineRegistry& pipelines,
+        vulkanUtils::RetiredPipelines& retired,
+        std::function<void()> const& verify) -> bool
+{
+    if(change.type != Type || change.name != shader.name) {
+        return false;
+    }
+
+    auto previous = shader.reload(modules);
+
+    try {
+        verify();
+    }
+    catch(...) {
+        shader.module     = std::move(previous.module);
+        shader.reflection = std::move(previous.reflection);
+        throw;
+    }
+
+    modules.commit(Type, shader.name, {shader.module, shader.reflection});
+
+    for(auto& pipeline : pipelines.release_shader_module(**previous.module)) {
+        retired.pipelines.push_back(std::move(pipeline));
+    }
+
+    retired.modules.push_back(std::move(previous.module));
+
+    return true;
+}
+
+// Lets the draw batcher issue a whole batch with one indirect call.
+[[nodiscard]] auto
+optional_device_features() noexcept -> vk::PhysicalDeviceFeatures
+{
+    auto features                      = vk::PhysicalDeviceFeatures{};
+    features.multiDrawIndirect         = VK_TRUE;
+    features.drawIndirectFirstInstance = VK_TRUE;
+
+    return features;
+}
+
+[[nodiscard]] auto
+triangle_mesh() -> vulkanUtils::MeshData<vulkanUtils::ColouredVertex>
+{
+    return {{{{0.0f, -0.5f}, {1.0f, 0.0f, 0.0f}},
+             {{0.5f, 0.5f}, {0.0f, 1.0f, 0.0f}},
+             {{-0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}}},
+            {0, 1, 2}};
+}
+
+// Lays the triangles out in a square grid, each scaled down into its own
+// cell. A single triangle is drawn at the original size.
+[[nodiscard]] auto
+triangle_grid(uint32_t const count)
+        -> std::vector<vulkanUtils::InstanceTransform>
+{
+    auto const columns = static_cast<uint32_t>(
+            std::ceil(std::sqrt(static_cast<float>(count))));
+    auto const cellSize = 2.0f / static_cast<float>(columns);
+    auto const scale    = glm::vec2{cellSize / 2.0f};
+
+    auto instances = std::vector<vulkanUtils::InstanceTransform>{};
+    instances.reserve(count);
+
+    for(auto i = 0u; i < count; ++i) {
+        auto const centre =
+                glm::vec2{
+                        static_cast<float>(i % columns) + 0.5f,
+                        static_cast<float>(i / columns) + 0.5f}
+                        * cellSize
+                - 1.0f;
+
+        instances.push_back({centre, scale});
+    }
+
+    return instances;
+}
+
+// One draw per triangle of triangle_grid, the naive way of drawing it and a
+// draw list long enough to be worth splitting over threads.
+[[nodiscard]] auto
+triangle_draws(uint32_t const count)
+        -> std::vector<vk::DrawIndexedIndirectCommand>
+{
+    auto draws = std::vector<vk::DrawIndexedIndirectCommand>{};
+    draws.reserve(count);
+
+    for(auto i = 0u; i < count; ++i) {
+        draws.emplace_back(3, 1, 0, 0, i);
+    }
+
+    return draws;
+}
+
+[[nodiscard]] auto
+device_extensions(bool const headless) -> std::vector<char const*>
+{
+    if(headless) {
+        return {};
+    }
+
+    return {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+}
+
+HelloTriangle::HelloTriangle(RenderSettings settings) :
+            m_settings{resolve_settings(settings)},
+            m_window{
+                    m_settings.headless
+                            ? glfwUtils::UniqueWindow{}
+                            : glfwUtils::create_window(
+                                    m_settings.extent.width,
+                                    m_settings.extent.height,
+                                    true,
+                                    "test")},
+            m_extensions{instance_extensions(m_settings.headless)},
+            m_instanceCapabilities{},
+            m_instance{
+                    m_instanceCapabilities,
+                    m_validationLayers,
+                    m_extensions},
             m_dynamicFuncDispatcher{*m_instance},
             m_debugMessenger{*m_instance, *m_dynamicFuncDispatcher},
-            m_physicalDevice{*m_instance, m_deviceExtensions},
-            m_surface{*m_instance, *m_physicalDevice, m_window.get()},
+            m_deviceExtensions{device_extensions(m_settings.headless)},
+            m_capabilityCache{capabilityCachePath},
+            m_physicalDevice{
+                    *m_instance,
+                    m_deviceExtensions,
+                    required_device_features(),
+                    optional_device_features(),
+                    &m_capabilityCache},
+            m_surface{[&]() -> std::optional<vulkanUtils::Surface> {
+                if(m_settings.headless) {
+                    return std::nullopt;
+                }
+
+                return std::optional<vulkanUtils::Surface>{
+                        std::in_place,
+                        *m_instance,
+                        *m_physicalDevice,
+                        m_window.get()};
+            }()},
             m_surfaceCaps{
-                    m_physicalDevice->getSurfaceCapabilitiesKHR(*m_surface)},
+                    m_surface ? m_surface->capabilities()
+                              : vk::SurfaceCapabilitiesKHR{}},
             m_surfaceFormats{
-                    m_physicalDevice->getSurfaceFormatsKHR(*m_surface)},
+                    m_surface ? m_surface->formats()
+                              : std::vector<vk::SurfaceFormatKHR>{}},
+            m_chosenSurfaceFormat{
+                    m_surface ? vulkanUtils::firstSupportedSurfaceFormat(
+                            m_surfaceFormats,
+                            m_requestedSurfaceFormats)
+                              : m_requestedSurfaceFormats.front()},
+            m_presentPolicy{
+                    vulkanUtils::present_policy(m_settings.presentProfile)},
+            m_presentConfig{
+                    m_surface ? vulkanUtils::choose_present_config(
+                            m_presentPolicy,
+                            m_surface->presentationModes(),
+                            m_surfaceCaps)
+                              : vulkanUtils::PresentConfig{}},
             m_graphicsQueues{m_physicalDevice.graphics_queue_family()},
-            m_presentationQueues{m_physicalDevice.present_queue_family(
-                    m_graphicsQueues,
-                    *m_surface)},
-            m_queuePriorities(m_graphicsQueues.properties.queueCount, 1.0f),
+            m_presentationQueues{
+                    m_surface ? m_physicalDevice.present_queue_family(
+                            m_graphicsQueues,
+                            **m_surface)
+                              : m_graphicsQueues},
+            m_queueTopology{vulkanUtils::create_queue_topology(
+                    m_physicalDevice.queueFamilies(),
+                    static_cast<uint32_t>(m_graphicsQueues.position),
+                    static_cast<uint32_t>(m_presentationQueues.position))},
             m_queueIndicies{
                     create_index_list(m_graphicsQueues, m_presentationQueues)},
             m_logicalDevice{vulkanUtils::create_logical_device(
                     *m_physicalDevice,
-                    m_graphicsQueues,
-                    m_queuePriorities,
+                    m_queueTopology,
                     m_validationLayers,
-                    m_deviceExtensions)},
-            m_graphicsQueue{
-                    m_logicalDevice->getQueue(m_graphicsQueues.position, 0)},
-            m_presentQueue{m_logicalDevice->getQueue(
-                    m_presentationQueues.position,
-                    0)},
-            m_vertShader{m_logicalDevice, "triangle"},
-            m_fragShader{m_logicalDevice, "triangle"},
-            m_colourBlendAttatchment{vulkanUtils::defaultBlendAttachment},
-            m_colourBlendState{vulkanUtils::defaultBlendState},
-            m_pipelineLayout{m_logicalDevice->createPipelineLayoutUnique(
-                    vk::PipelineLayoutCreateInfo{})},
-            m_commandPool{vulkanUtils::create_command_pool(
+                    m_deviceExtensions,
+                    m_physicalDevice.features())},
+            m_graphicsQueue{vulkanUtils::get_queue(
+                    *m_logicalDevice,
+                    m_queueTopology.graphics)},
+            m_presentQueue{vulkanUtils::get_queue(
+                    *m_logicalDevice,
+                    m_queueTopology.present)},
+            m_transferQueue{vulkanUtils::get_queue(
+                    *m_logicalDevice,
+                    m_queueTopology.transfer)},
+            m_computeQueue{vulkanUtils::get_queue(
+                    *m_logicalDevice,
+                    m_queueTopology.compute)},
+            m_pipelineCache{
+                    *m_logicalDevice,
+                    m_physicalDevice.properties(),
+                    pipelineCachePath},
+            m_allocator{
+                    *m_logicalDevice,
+                    m_physicalDevice.memoryProperties(),
+                    m_physicalDevice.properties().limits},
+            m_descriptorLayouts{*m_logicalDevice},
+            m_pipelineLayouts{*m_logicalDevice, m_descriptorLayouts},
+            m_descriptors{*m_logicalDevice},
+            m_frameDescriptors{*m_logicalDevice, m_settings.framesInFlight},
+            m_uniforms{
+                    m_allocator,
+                    m_physicalDevice.properties().limits,
+                    uniformRegionSize,
+                    m_settings.framesInFlight},
+            m_frameSetLayout{m_descriptorLayouts.get(frame_set_bindings())},
+            m_frameSet{create_frame_set(
+                    *m_logicalDevice,
+                    m_descriptors,
+                    m_frameSetLayout,
+                    m_uniforms.buffer())},
+            m_transfers{
+                    *m_logicalDevice,
+                    m_allocator,
+                    m_queueTopology,
+                    m_transferQueue,
+                    m_settings.framesInFlight},
+            m_triangleMesh{vulkanUtils::create_mesh(
+                    m_allocator,
+                    m_transfers,
+                    triangle_mesh())},
+            m_instances{triangle_grid(m_settings.triangleCount)},
+            m_instanceBuffer{vulkanUtils::upload_buffer(
+                    m_allocator,
+                    m_transfers,
+                    gsl::as_bytes(gsl::make_span(m_instances)),
+                    vk::BufferUsageFlagBits::eVertexBuffer
+                            | vk::BufferUsageFlagBits::eStorageBuffer)},
+            m_drawList{triangle_draws(m_settings.triangleCount)},
+            m_shaderCompiler{},
+            m_shaderModules{
+                    *m_logicalDevice,
+                    shaderUtils::ShaderCompiler::available()
+                            ? &m_shaderCompiler
+                            : nullptr},
+            m_vertShader{
+                    m_shaderModules,
+                    "triangle",
+                    TriangleVariant::values(m_settings.tint)},
+            m_fragShader{m_shaderModules, "triangle"},
+            m_shaderWatcher{[&]() -> std::optional<shaderUtils::ShaderWatcher> {
+                if(!m_settings.watchShaders) {
+                    return std::nullopt;
+                }
+
+                return std::optional<shaderUtils::ShaderWatcher>{
+                        std::in_place,
+                        m_shaderModules.compiler() != nullptr
+                                ? shaderUtils::shader_source_directory()
+                                : shaderUtils::shader_binary_directory()};
+            }()},
+            m_pipelineLayout{m_pipelineLayouts.get(
+                    triangle_layout_description(m_vertShader, m_fragShader))},
+            m_pipelines{m_pipelineCache, m_settings.compileThreads},
+            m_animation{[&]() -> std::optional<InstanceAnimation> {
+                if(!m_settings.computeInstances) {
+                    return std::nullopt;
+                }
+
+                return create_instance_animation(
+                        *m_logicalDevice,
+                        m_shaderModules,
+                        m_allocator,
+                        m_descriptorLayouts,
+                        m_pipelineLayouts,
+                        m_descriptors,
+                        m_pipelineCache,
+                        *m_instanceBuffer.buffer,
+                        m_instances.size()
+                                * sizeof(vulkanUtils::InstanceTransform));
+            }()},
+            m_commands{
+                    *m_logicalDevice,
+                    static_cast<uint32_t>(m_graphicsQueues.position),
+                    m_settings.framesInFlight},
+            m_offscreenTarget{
+                    [&]() -> std::optional<vulkanUtils::OffscreenTarget> {
+                        if(m_surface) {
+                            return std::nullopt;
+                        }
+
+                        return std::optional<vulkanUtils::OffscreenTarget>{
+                                std::in_place,
+                                m_allocator,
+                                m_chosenSurfaceFormat.format,
+                                m_settings.extent,
+                                m_settings.framesInFlight};
+                    }()},
+            m_swapChainExtent{
+                    m_surface ? swap_chain_extent(
+                            m_surfaceCaps,
+                            m_settings.extent)
+                              : m_settings.extent},
+            m_swapChain{
+                    m_surface ? vulkanUtils::create_swap_chain(
+                            **m_surface,
+                            m_surfaceCaps,
+                            m_chosenSurfaceFormat,
+                            m_presentConfig.presentationMode,
+                            m_presentConfig.imageCount,
+                            m_logicalDevice,
+                            m_swapChainExtent,
+                            m_queueIndicies)
+                              : vk::UniqueSwapchainKHR{}},
+            m_swapChainImages{
+                    m_surface ? m_logicalDevice->getSwapchainImagesKHR(
+                            *m_swapChain)
+                              : m_offscreenTarget->images()},
+            m_imageViews{vulkanUtils::create_image_views(
+                    m_logicalDevice,
+                    m_swapChainImages,
+                    m_chosenSurfaceFormat.format)},
+            m_renderPass{vulkanUtils::create_render_pass(
+                    m_logicalDevice,
+                    m_chosenSurfaceFormat.format,
+                    m_surface ? vk::ImageLayout::ePresentSrcKHR
+                              : vk::ImageLayout::eTransferSrcOptimal)},
+            m_graphicsPipeline{m_pipelines.request(
+                    triangle_pipeline_description(
+                            m_vertShader,
+                            m_fragShader,
+                            m_pipelineLayout,
+                            *m_renderPass))},
+            m_framebuffers{vulkanUtils::create_framebuffers(
                     m_logicalDevice,
-                    m_graphicsQueues)},
-            m_imageAvailableSignals{
-                    m_logicalDevice->createSemaphoreUnique({}),
-                    m_logicalDevice->createSemaphoreUnique({})},
-            m_renderFinishedSignals{
-                    m_logicalDevice->createSemaphoreUnique({}),
-                    m_logicalDevice->createSemaphoreUnique({})},
-            m_memoryFences{
-                    m_logicalDevice->createFenceUnique(
-                            {vk::FenceCreateFlagBits::eSignaled}),
-                    m_logicalDevice->createFenceUnique(
-                            {vk::FenceCreateFlagBits::eSignaled})}
+                    m_renderPass,
+                    m_imageViews,
+                    m_swapChainExtent)},
+            m_swapchainStale{false},
+            m_frames{
+                    *m_logicalDevice,
+                    m_settings.framesInFlight,
+                    m_swapChainImages.size()},
+            m_recorder{[&]() -> std::optional<vulkanUtils::ParallelRecorder> {
+                if(m_settings.recordThreads == 0) {
+                    return std::nullopt;
+                }
+
+                return std::optional<vulkanUtils::ParallelRecorder>{
+                        std::in_place,
+                        *m_logicalDevice,
+                        static_cast<uint32_t>(m_graphicsQueues.position),
+                        m_settings.recordThreads,
+                        m_settings.framesInFlight};
+            }()},
+            m_batcher{[&]() -> std::optional<vulkanUtils::DrawBatcher> {
+                if(!m_settings.batchDraws) {
+                    return std::nullopt;
+                }
+
+                return std::optional<vulkanUtils::DrawBatcher>{
+                        std::in_place,
+                        *m_logicalDevice,
+                        m_allocator,
+                        m_physicalDevice.features(),
+                        m_settings.framesInFlight,
+                        m_settings.triangleCount};
+            }()},
+            m_gpuTimer{
+                    *m_logicalDevice,
+                    m_physicalDevice.properties().limits,
+                    m_graphicsQueues.properties,
+                    m_settings.framesInFlight},
+            m_pipelineWaitFrames{0}
+{
+    m_frameTimings.reserve(m_settings.frameCount);
+
+    if(m_window) {
+        glfwSetWindowUserPointer(m_window.get(), this);
+        glfwSetFramebufferSizeCallback(
+                m_window.get(),
+                [](GLFWwindow* window, int, int) {
+                    static_cast<HelloTriangle*>(
+                            glfwGetWindowUserPointer(window))
+                            ->m_swapchainStale = true;
+                });
+    }
+
+    std::cerr << deviceName() << '\n' << m_queueTopology;
+
+    if(m_surface) {
+        std::cerr << m_presentConfig;
+    }
+}
+
+// Pipelines still compiling refer to the render pass and shaders, which are
+// destroyed before the registry.
+HelloTriangle::~HelloTriangle()
+{
+    m_pipelines.wait_idle();
+}
+
+[[nodiscard]] auto
+HelloTriangle::settings() const noexcept -> RenderSettings const&
+{
+    return m_settings;
+}
+
+[[nodiscard]] auto
+HelloTriangle::deviceName() const -> std::string
+{
+    return m_physicalDevice.properties().deviceName.data();
+}
+
+[[nodiscard]] auto
+HelloTriangle::gpuTimer() const noexcept -> vulkanUtils::GpuTimer const&
+{
+    return m_gpuTimer;
+}
+
+[[nodiscard]] auto
+HelloTriangle::frameTimings() const noexcept
+        -> std::vector<vulkanUtils::FrameTimings> const&
+{
+    return m_frameTimings;
+}
+
+[[nodiscard]] auto
+HelloTriangle::queueTopology() const noexcept
+        -> vulkanUtils::QueueTopology const&
+{
+    return m_queueTopology;
+}
+
+[[nodiscard]] auto
+HelloTriangle::transferQueue() const noexcept -> vk::Queue const&
+{
+    return m_transferQueue;
+}
+
+[[nodiscard]] auto
+HelloTriangle::computeQueue() const noexcept -> vk::Queue const&
+{
+    return m_computeQueue;
+}
+
+[[nodiscard]] auto
+HelloTriangle::transferStats() const noexcept
+        -> vulkanUtils::TransferStats const&
+{
+    return m_transfers.stats();
+}
+
+[[nodiscard]] auto
+HelloTriangle::commandBufferAllocations() const -> uint64_t
+{
+    return m_commands.allocationCount()
+           + (m_recorder ? m_recorder->allocationCount() : 0u);
+}
+
+[[nodiscard]] auto
+HelloTriangle::pipelineRegistryStats() const
+        -> vulkanUtils::PipelineRegistryStats
+{
+    return m_pipelines.stats();
+}
+
+[[nodiscard]] auto
+HelloTriangle::shaderCompileStats() const noexcept
+        -> shaderUtils::ShaderCompileStats const&
+{
+    return m_shaderCompiler.stats();
+}
+
+[[nodiscard]] auto
+HelloTriangle::capabilityCacheStats() const noexcept
+        -> vulkanUtils::CapabilityCacheStats const&
 {
-    std::cerr << m_physicalDevice->getProperties().deviceName.data() << '\n';
+    return m_capabilityCache.stats();
+}
+
+[[nodiscard]] auto
+HelloTriangle::pipelineWaitFrames() const noexcept -> uint32_t
+{
+    return m_pipelineWaitFrames;
+}
+
+[[nodiscard]] auto
+HelloTriangle::drawBatchStats() const noexcept -> vulkanUtils::DrawBatchStats
+{
+    return m_batcher ? m_batcher->stats() : vulkanUtils::DrawBatchStats{};
+}
+
+[[nodiscard]] auto
+HelloTriangle::presentConfig() const noexcept
+        -> vulkanUtils::PresentConfig const&
+{
+    return m_presentConfig;
+}
+
+[[nodiscard]] auto
+HelloTriangle::resizeHitches() const noexcept
+        -> std::vector<std::chrono::nanoseconds> const&
+{
+    return m_resizeHitches;
 }
 
 [[nodiscard]] auto
@@ -150,126 +986,619 @@ surfaceSize(
     return physicalDevice.getSurfaceCapabilitiesKHR(surface).currentExtent;
 }
 
+using Clock = std::chrono::steady_clock;
+
+// Returns the time since the previous lap, or since construction.
+class LapTimer {
+public:
+    LapTimer() : m_start{Clock::now()}, m_lapStart{m_start}
+    {}
+
+    [[nodiscard]] auto
+    lap() -> std::chrono::nanoseconds
+    {
+        auto const now     = Clock::now();
+        auto const elapsed = now - m_lapStart;
+        m_lapStart         = now;
+
+        return elapsed;
+    }
+
+    [[nodiscard]] auto
+    total() const -> std::chrono::nanoseconds
+    {
+        return Clock::now() - m_start;
+    }
+
+private:
+    Clock::time_point const m_start;
+    Clock::time_point m_lapStart;
+};
+
+struct PresentedFrame {
+    vulkanUtils::FrameTimings timings;
+    bool presented;
+    bool swapchainStale;
+};
+
 auto
 draw_frame(
         vk::Device const& logicalDevice,
-        vk::Semaphore const& imageAvailableSignal,
-        vk::Semaphore const& renderFinishedSignal,
-        vk::Fence const& memFence,
+        vulkanUtils::FrameRing& frames,
         vk::Queue const& graphicsQueue,
         vk::Queue const& presentQueue,
         vk::SwapchainKHR const& swapChain,
-        std::vector<vk::UniqueCommandBuffer> const& commandBuffers) -> void
+        RecordFunction const& record)
+        -> PresentedFrame
 {
-    auto const signaled = logicalDevice.waitForFences(
-            memFence,
-            VK_TRUE,
-            std::numeric_limits<uint64_t>::max());
+    auto timer   = LapTimer{};
+    auto timings = vulkanUtils::FrameTimings{};
+    auto presented = false;
+    auto stale     = false;
 
-    if(signaled != vk::Result::eSuccess) {
-        throw std::runtime_error("Fence could not be signaled\n");
-    }
+    auto const& frame = frames.current();
+
+    frames.wait_for_current();
+    timings.fenceWait = timer.lap();
 
     try {
-        auto const nextImageIndex =
-                logicalDevice
-                        .acquireNextImageKHR(
-                                swapChain,
-                                std::numeric_limits<uint64_t>::max(),
-                                imageAvailableSignal,
-                                nullptr)
-                        .value;
-
-        auto constexpr pipelineStage = std::array{
+        auto const acquired = logicalDevice.acquireNextImageKHR(
+                swapChain,
+                std::numeric_limits<uint64_t>::max(),
+                *frame.imageAvailable,
+                nullptr);
+
+        auto const nextImageIndex = acquired.value;
+        stale = acquired.result == vk::Result::eSuboptimalKHR;
+
+        timings.acquire = timer.lap();
+
+        frames.claim_image(nextImageIndex);
+        timings.imageWait = timer.lap();
+
+        auto const recorded = record(frames.currentIndex(), nextImageIndex);
+        auto const uploaded = recorded.uploaded;
+        timings.record      = timer.lap();
+
+        auto const waitSemaphores = std::array{*frame.imageAvailable, uploaded};
+
+        auto constexpr pipelineStages = std::array{
+                (vk::PipelineStageFlags)
+                        vk::PipelineStageFlagBits::eColorAttachmentOutput,
                 (vk::PipelineStageFlags)
-                        vk::PipelineStageFlagBits::eColorAttachmentOutput};
+                        vk::PipelineStageFlagBits::eVertexInput};
         auto const submitInfo = vk::SubmitInfo(
+                uploaded ? 2 : 1,
+                waitSemaphores.data(),
+                pipelineStages.data(),
                 1,
-                &imageAvailableSignal,
-                pipelineStage.data(),
+                &recorded.commandBuffer,
                 1,
-                &commandBuffers[nextImageIndex].get(),
-                1,
-                &renderFinishedSignal);
+                &frame.renderFinished.get());
+
+        logicalDevice.resetFences(*frame.inFlight);
+        graphicsQueue.submit(submitInfo, *frame.inFlight);
 
-        logicalDevice.resetFences(memFence);
-        graphicsQueue.submit(submitInfo, memFence);
+        timings.submit = timer.lap();
 
         auto const presentInfo = vk::PresentInfoKHR(
                 1,
-                &renderFinishedSignal,
+                &frame.renderFinished.get(),
                 1,
                 &swapChain,
                 &nextImageIndex,
                 nullptr);
 
-        if(presentQueue.presentKHR(presentInfo) != vk::Result::eSuccess) {
-            std::cerr << "Frame could not be presented!\n";
-        }
+        auto const presentResult = presentQueue.presentKHR(presentInfo);
+
+        presented = true;
+        stale     = stale || presentResult == vk::Result::eSuboptimalKHR;
+
+        timings.present = timer.lap();
     }
     catch(vk::OutOfDateKHRError const&) {
-        // recreate_swap_chain(
-        // surfaceSize(physicalDevice, surface),
-        // physicalDevice,
-        // logicalDevice,
-        // surface,
-        // queueIndicies,
-        // fragShader,
-        // vertShader,
-        // colourBlendState,
-        // pipelineLayout,
-        // commandPool,
-        // swapChain,
-        // swapChainImages,
-        // imageViews,
-        // renderPass,
-        // graphicsPipeline,
-        // framebuffers,
-        // commandBuffers);
+        stale = true;
     }
+
+    frames.advance();
+
+    timings.stall = timings.fenceWait + timings.imageWait;
+    timings.total = timer.total();
+
+    return {timings, presented, stale};
 }
 
 auto
-draw_frames(
+draw_offscreen_frame(
         vk::Device const& logicalDevice,
-        SemaphoreArray const& imageAvailableSignals,
-        SemaphoreArray const& renderFinishedSignals,
-        MemoryFenceArray const& memFences,
+        vulkanUtils::FrameRing& frames,
         vk::Queue const& graphicsQueue,
-        vk::Queue const& presentQueue,
-        vk::SwapchainKHR const& swapChain,
-        std::vector<vk::UniqueCommandBuffer> const& commandBuffers) -> void
-{
-    for(auto i = 0u; i < maxFramesInFlight; ++i) {
-        draw_frame(
-                logicalDevice,
-                imageAvailableSignals[i].get(),
-                renderFinishedSignals[i].get(),
-                memFences[i].get(),
-                graphicsQueue,
-                presentQueue,
-                swapChain,
-                commandBuffers);
+        uint32_t const imageIndex,
+        RecordFunction const& record)
+        -> vulkanUtils::FrameTimings
+{
+    auto timer   = LapTimer{};
+    auto timings = vulkanUtils::FrameTimings{};
+
+    auto const& frame = frames.current();
+
+    frames.wait_for_current();
+    timings.fenceWait = timer.lap();
+
+    frames.claim_image(imageIndex);
+    timings.imageWait = timer.lap();
+
+    auto const recorded = record(frames.currentIndex(), imageIndex);
+    timings.record      = timer.lap();
+
+    auto constexpr pipelineStage = vk::PipelineStageFlags{
+            vk::PipelineStageFlagBits::eVertexInput};
+    auto const submitInfo = vk::SubmitInfo(
+            recorded.uploaded ? 1 : 0,
+            &recorded.uploaded,
+            &pipelineStage,
+            1,
+            &recorded.commandBuffer,
+            0,
+            nullptr);
+
+    logicalDevice.resetFences(*frame.inFlight);
+    graphicsQueue.submit(submitInfo, *frame.inFlight);
+
+    timings.submit = timer.lap();
+
+    frames.advance();
+
+    timings.stall = timings.fenceWait + timings.imageWait;
+    timings.total = timer.total();
+
+    return timings;
+}
+
+// Hands the current swapchain over as oldSwapchain and rebuilds only what
+// refers to its images. The replaced objects are retired instead of being
+// destroyed, so recreation never waits on the frames still in flight.
+// Returns false while the surface has no area, e.g. when minimised.
+auto
+HelloTriangle::recreate_swapchain() -> bool
+{
+    auto const start = Clock::now();
+
+    auto width  = 0;
+    auto height = 0;
+    glfwGetFramebufferSize(m_window.get(), &width, &height);
+
+    auto const surfaceCaps =
+            m_physicalDevice->getSurfaceCapabilitiesKHR(**m_surface);
+    auto const extent = swap_chain_extent(
+            surfaceCaps,
+            {static_cast<uint32_t>(width), static_cast<uint32_t>(height)});
+
+    if(extent.width == 0 || extent.height == 0) {
+        return false;
     }
+
+    auto const surfaceFormats =
+            m_physicalDevice->getSurfaceFormatsKHR(**m_surface);
+    auto const surfaceFormat =
+            vulkanUtils::surfaceFormatSupported(
+                    surfaceFormats,
+                    m_chosenSurfaceFormat)
+                    ? m_chosenSurfaceFormat
+                    : surfaceFormats.front();
+
+    m_presentConfig = vulkanUtils::choose_present_config(
+            m_presentPolicy,
+            m_surface->presentationModes(),
+            surfaceCaps);
+
+    auto swapChain = vulkanUtils::create_swap_chain(
+            **m_surface,
+            surfaceCaps,
+            surfaceFormat,
+            m_presentConfig.presentationMode,
+            m_presentConfig.imageCount,
+            m_logicalDevice,
+            extent,
+            m_queueIndicies,
+            *m_swapChain);
+
+    auto retired         = vulkanUtils::RetiredSwapchain{};
+    retired.swapchain    = std::move(m_swapChain);
+    retired.imageViews   = std::move(m_imageViews);
+    retired.framebuffers = std::move(m_framebuffers);
+    retired.releaseFrame = m_frames.frameNumber() + m_frames.depth();
+
+    if(surfaceFormat != m_chosenSurfaceFormat) {
+        m_chosenSurfaceFormat = surfaceFormat;
+
+        retired.pipelines  = m_pipelines.release_render_pass(*m_renderPass);
+        retired.renderPass = std::move(m_renderPass);
+
+        m_renderPass = vulkanUtils::create_render_pass(
+                m_logicalDevice,
+                m_chosenSurfaceFormat.format);
+        // The old pipeline can't draw into the new render pass, so there is
+        // nothing to fall back on while this one compiles.
+        m_graphicsPipeline = vulkanUtils::PendingPipeline{
+                m_pipelines.request(triangle_pipeline_description(
+                        m_vertShader,
+                        m_fragShader,
+                        m_pipelineLayout,
+                        *m_renderPass))};
+    }
+
+    m_retiredSwapchains.push_back(std::move(retired));
+
+    m_swapChain       = std::move(swapChain);
+    m_swapChainExtent = extent;
+    m_swapChainImages = m_logicalDevice->getSwapchainImagesKHR(*m_swapChain);
+    m_imageViews      = vulkanUtils::create_image_views(
+            m_logicalDevice,
+            m_swapChainImages,
+            m_chosenSurfaceFormat.format);
+    m_framebuffers = vulkanUtils::create_framebuffers(
+            m_logicalDevice,
+            m_renderPass,
+            m_imageViews,
+            m_swapChainExtent);
+
+    m_frames.reset_images(m_swapChainImages.size());
+    m_swapchainStale = false;
+
+    m_resizeHitches.push_back(Clock::now() - start);
+
+    return true;
+}
+
+// Runs between frames. The new pipeline is compiled like any other, the old
+// one is drawn with until it is ready and only released once the frames
+// recorded with it have retired. If it fails to compile the old one is kept
+// until a later reload succeeds. The compute pipeline is rebuilt at once.
+auto
+HelloTriangle::hot_reload() -> void
+{
+    if(auto const error = m_graphicsPipeline.error()) {
+        try {
+            std::rethrow_exception(error);
+        }
+        catch(std::exception const& e) {
+            std::cerr << "Keeping the previous pipeline: " << e.what()
+                      << '\n';
+        }
+
+        m_graphicsPipeline = vulkanUtils::PendingPipeline{
+                {},
+                m_graphicsPipeline.current()};
+    }
+    else if(m_graphicsPipeline.ready()) {
+        for(auto& retired : m_retiredPipelines) {
+            if(retired.releaseFrame
+               == vulkanUtils::RetiredPipelines::unscheduled) {
+                retired.releaseFrame =
+                        m_frames.frameNumber() + m_frames.depth();
+            }
+        }
+    }
+
+    vulkanUtils::release_retired(m_retiredPipelines, m_frames.frameNumber());
+
+    auto retired         = vulkanUtils::RetiredPipelines{};
+    retired.releaseFrame = vulkanUtils::RetiredPipelines::unscheduled;
+
+    // The animation pipeline is swapped out at once and stops being recorded
+    // on the next frame, so what it replaces needn't wait for the graphics
+    // pipeline.
+    auto retiredAnimation         = vulkanUtils::RetiredPipelines{};
+    retiredAnimation.releaseFrame = m_frames.frameNumber() + m_frames.depth();
+
+    auto const verify = [this]() {
+        static_cast<void>(
+                triangle_layout_description(m_vertShader, m_fragShader));
+    };
+
+    // The compute pipeline is built as part of verifying, so a shader it
+    // can't be built from is rolled back like any other rejected one.
+    auto animationPipeline = vk::UniquePipeline{};
+    auto const verifyAnimation = [&]() {
+        static_cast<void>(animation_layout_description(m_animation->shader));
+        animationPipeline = vulkanUtils::create_compute_pipeline(
+                m_pipelineCache,
+                vulkanUtils::shader_stage_description(m_animation->shader),
+                m_animation->layout);
+    };
+
+    auto reloaded = false;
+    for(auto const& change : m_shaderWatcher->poll()) {
+        try {
+            if(m_animation
+               && reload_shader(
+                       m_animation->shader,
+                       change,
+                       m_shaderModules,
+                       m_pipelines,
+                       retiredAnimation,
+                       verifyAnimation)) {
+                retiredAnimation.pipelines.push_back(
+                        std::exchange(
+                                m_animation->pipeline,
+                                std::move(animationPipeline)));
+                continue;
+            }
+
+            reloaded = reload_shader(
+                               m_vertShader,
+                               change,
+                               m_shaderModules,
+                               m_pipelines,
+                               retired,
+                               verify)
+                       || reload_shader(
+                               m_fragShader,
+                               change,
+                               m_shaderModules,
+                               m_pipelines,
+                               retired,
+                               verify)
+                       || reloaded;
+        }
+        catch(std::exception const& e) {
+            std::cerr << "Keeping the previous " << change.name
+                      << " shader: " << e.what() << '\n';
+        }
+    }
+
+    if(!retiredAnimation.modules.empty()) {
+        m_retiredPipelines.push_back(std::move(retiredAnimation));
+    }
+
+    if(!reloaded) {
+        if(!retired.pipelines.empty()) {
+            m_retiredPipelines.push_back(std::move(retired));
+        }
+
+        return;
+    }
+
+    m_graphicsPipeline = vulkanUtils::PendingPipeline{
+            m_pipelines.request(triangle_pipeline_description(
+                    m_vertShader,
+                    m_fragShader,
+                    m_pipelineLayout,
+                    *m_renderPass)),
+            m_graphicsPipeline.current()};
+
+    m_retiredPipelines.push_back(std::move(retired));
+}
+
+// Only called once the frame's fence has signalled, so both its command
+// pool and its timestamp queries are free to be reused. Uploads queued
+// since the previous frame are submitted to the transfer queue first.
+[[nodiscard]] auto
+HelloTriangle::record_frame(
+        uint32_t const frameIndex,
+        uint32_t const imageIndex) -> RecordedFrame
+{
+    m_gpuTimer.collect(frameIndex);
+
+    m_transfers.begin_frame(frameIndex);
+    auto const uploads = m_transfers.submit(frameIndex);
+
+    auto const pipeline = m_graphicsPipeline.current();
+    if(!pipeline) {
+        ++m_pipelineWaitFrames;
+    }
+
+    if(m_batcher && pipeline) {
+        auto const subMesh =
+                vulkanUtils::SubMesh{m_triangleMesh.indexCount(), 0, 0};
+
+        for(auto const& instance : m_instances) {
+            m_batcher->add(
+                    pipeline,
+                    m_triangleMesh,
+                    subMesh,
+                    instance);
+        }
+    }
+
+    m_frameDescriptors.reset(frameIndex);
+    m_uniforms.begin_frame(frameIndex);
+
+    auto const frameOffset =
+            m_uniforms.push(FrameUniforms{glm::vec2{1.0f}, glm::vec2{0.0f}});
+
+    auto bindings = FrameBindings{
+            m_pipelineLayout,
+            m_frameSet,
+            frameOffset,
+            DrawConstants{glm::vec4{1.0f}}};
+
+    // The slow path the dynamic offset avoids: a fresh set per frame, written
+    // to point at the frame's uniforms.
+    if(m_settings.rewriteDescriptors) {
+        bindings.frameSet =
+                m_frameDescriptors.allocate(frameIndex, m_frameSetLayout);
+        bindings.frameOffset = 0;
+
+        vulkanUtils::write_dynamic_uniform(
+                *m_logicalDevice,
+                bindings.frameSet,
+                0,
+                m_uniforms.buffer(),
+                frameOffset,
+                sizeof(FrameUniforms));
+    }
+
+    // Uploads are only acquired at vertex input, so the animation starts on
+    // the frame after them and that frame draws the grid as uploaded.
+    auto animation = std::optional<AnimationPass>{};
+    if(m_animation && !uploads.semaphore) {
+        auto const count = static_cast<uint32_t>(m_instances.size());
+
+        animation = AnimationPass{
+                {*m_animation->pipeline,
+                 m_animation->layout,
+                 {m_animation->set},
+                 {vulkanUtils::group_count(count, animationGroupSize), 1, 1}},
+                {static_cast<float>(m_frames.frameNumber()) / 60.0f, count}};
+    }
+
+    m_commands.reset(frameIndex);
+    auto const commandBuffer =
+            m_commands.allocate(frameIndex, vk::CommandBufferLevel::ePrimary);
+
+    record_commands(
+            m_renderPass,
+            m_framebuffers[imageIndex],
+            m_swapChainExtent,
+            pipeline,
+            bindings,
+            m_triangleMesh,
+            animation ? *m_animation->animated.buffer
+                      : *m_instanceBuffer.buffer,
+            m_drawList,
+            m_recorder ? &*m_recorder : nullptr,
+            m_batcher ? &*m_batcher : nullptr,
+            uploads.barriers,
+            animation ? &*animation : nullptr,
+            commandBuffer,
+            m_gpuTimer,
+            frameIndex);
+
+    return {commandBuffer, uploads.semaphore};
 }
 
 auto
 HelloTriangle::main_loop() -> void
 {
-    while(glfwWindowShouldClose(m_window.get()) == 0) {
+    if(m_settings.headless) {
+        offscreen_loop();
+    }
+    else {
+        window_loop();
+    }
+
+    m_logicalDevice->waitIdle();
+
+    auto const& transfers = m_transfers.stats();
+
+    if(m_shaderModules.compiler() != nullptr) {
+        std::cerr << m_shaderCompiler.stats();
+    }
+
+    std::cerr << m_capabilityCache.stats() << m_pipelineCache.stats()
+              << m_pipelines.stats()
+              << m_allocator.stats()
+              << "Transfers: " << transfers.bytesUploaded << " bytes in "
+              << transfers.copies << " copies, " << transfers.submissions
+              << " submissions\n"
+              << m_descriptorLayouts.size() << " descriptor set layouts, "
+              << m_pipelineLayouts.size() << " pipeline layouts\n"
+              << "Long lived: " << m_descriptors.stats()
+              << "Per frame: " << m_frameDescriptors.stats();
+
+    if(!m_resizeHitches.empty()) {
+        auto const hitch = vulkanUtils::percentiles(m_resizeHitches);
+        std::cerr << m_resizeHitches.size() << " swapchain recreations: "
+                  << hitch.p50Ms << "ms p50, " << hitch.maxMs << "ms max\n";
+    }
+
+    for(auto const& [name, durations] : m_gpuTimer.history()) {
+        auto const gpuTime = vulkanUtils::percentiles(durations.samples());
+        std::cerr << "GPU " << name << ": " << gpuTime.p50Ms << "ms p50, "
+                  << gpuTime.p99Ms << "ms p99\n";
+    }
+}
+
+auto
+HelloTriangle::window_loop() -> void
+{
+    auto const record = [this](uint32_t frameIndex, uint32_t imageIndex) {
+        return record_frame(frameIndex, imageIndex);
+    };
+
+    auto const frameLimitReached = [this](uint32_t framesDrawn) {
+        return m_settings.frameCount != 0
+               && framesDrawn >= m_settings.frameCount;
+    };
+
+    auto framesDrawn = 0u;
+    auto lastPresent = std::optional<Clock::time_point>{};
+    while(glfwWindowShouldClose(m_window.get()) == 0
+          && !frameLimitReached(framesDrawn)) {
         glfwPollEvents();
-        draw_frames(
+
+        vulkanUtils::release_retired(
+                m_retiredSwapchains,
+                m_frames.frameNumber());
+
+        if(m_swapchainStale && !recreate_swapchain()) {
+            glfwWaitEvents();
+            continue;
+        }
+
+        if(m_shaderWatcher) {
+            hot_reload();
+        }
+
+        auto frame = draw_frame(
                 m_logicalDevice.get(),
-                m_imageAvailableSignals,
-                m_renderFinishedSignals,
-                m_memoryFences,
+                m_frames,
                 m_graphicsQueue,
                 m_presentQueue,
                 m_swapChain.get(),
-                m_commandBuffers);
+                record);
+
+        if(frame.presented) {
+            auto const now = Clock::now();
+            if(lastPresent) {
+                frame.timings.presentInterval = now - *lastPresent;
+            }
+
+            lastPresent = now;
+        }
+
+        m_swapchainStale = m_swapchainStale || frame.swapchainStale;
+        m_frameTimings.push_back(frame.timings);
+
+        ++framesDrawn;
+    }
+}
+
+auto
+HelloTriangle::offscreen_loop() -> void
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    auto const start   = Clock::now();
+
+    auto const record = [this](uint32_t frameIndex, uint32_t imageIndex) {
+        return record_frame(frameIndex, imageIndex);
+    };
+
+    for(auto frame = 0u; frame < m_settings.frameCount; ++frame) {
+        if(m_shaderWatcher) {
+            hot_reload();
+        }
+
+        auto const imageIndex =
+                static_cast<uint32_t>(frame % m_swapChainImages.size());
+
+        m_frameTimings.push_back(draw_offscreen_frame(
+                m_logicalDevice.get(),
+                m_frames,
+                m_graphicsQueue,
+                imageIndex,
+                record));
     }
 
     m_logicalDevice->waitIdle();
+
+    auto const elapsed = Milliseconds(Clock::now() - start);
+    std::cerr << m_settings.frameCount << " offscreen frames in "
+              << elapsed.count() << "ms ("
+              << m_settings.frameCount / (elapsed.count() / 1000.0)
+              << " fps)\n";
 }
 
 auto
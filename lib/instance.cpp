@@ -1,11 +1,24 @@
 #include "instance.hpp"
 
+#include <stdexcept>
+
 namespace vulkanUtils {
 auto
 create_instance(
+        InstanceCapabilities const& capabilities,
         std::vector<char const*> const& validationLayers,
         std::vector<char const*> const& extensions)
 {
+    auto const layersSupported = capabilities.supports_layers(validationLayers);
+    auto const extensionsSupported =
+            capabilities.supports_extensions(extensions);
+
+    if(!layersSupported || !extensionsSupported) {
+        throw std::runtime_error(
+                "The instance does not support the requested layers and "
+                "extensions!");
+    }
+
     auto constexpr applicationInfo = vk::ApplicationInfo{
             "VkTut",
             VK_MAKE_VERSION(1, 0, 0),
@@ -25,11 +38,15 @@ create_instance(
 }
 
 Instance::Instance(
+        InstanceCapabilities const& capabilities,
         std::vector<char const*> validationLayers,
         std::vector<char const*> extensions) :
             m_extensions{std::move(extensions)},
             m_validationLayers{std::move(validationLayers)},
-            m_instance{create_instance(m_validationLayers, m_extensions)}
+            m_instance{create_instance(
+                    capabilities,
+                    m_validationLayers,
+                    m_extensions)}
 {}
 
 [[nodiscard]] auto
@@ -0,0 +1,390 @@
+#include "memoryAllocator.hpp"
+#include "rangeAllocator.hpp"
+#include "vulkanUtility.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace vulkanUtils {
+
+class MemoryBlock {
+public:
+    explicit MemoryBlock(
+            vk::Device const& logicalDevice,
+            uint32_t const memoryType,
+            vk::DeviceSize const size,
+            bool const hostVisible,
+            AllocationStrategy const strategy,
+            vk::DeviceSize const granularity) :
+                m_memory{logicalDevice.allocateMemoryUnique(
+                        vk::MemoryAllocateInfo(size, memoryType))},
+                m_mapped{
+                        hostVisible ? logicalDevice.mapMemory(
+                                *m_memory,
+                                0,
+                                VK_WHOLE_SIZE)
+                                    : nullptr},
+                m_memoryType{memoryType},
+                m_ranges{size, strategy, granularity}
+    {}
+
+    [[nodiscard]] auto
+    memory() const noexcept -> vk::DeviceMemory
+    {
+        return *m_memory;
+    }
+
+    [[nodiscard]] auto
+    mapped() const noexcept -> void*
+    {
+        return m_mapped;
+    }
+
+    [[nodiscard]] auto
+    memoryType() const noexcept -> uint32_t
+    {
+        return m_memoryType;
+    }
+
+    [[nodiscard]] auto
+    ranges() noexcept -> RangeAllocator&
+    {
+        return m_ranges;
+    }
+
+    [[nodiscard]] auto
+    ranges() const noexcept -> RangeAllocator const&
+    {
+        return m_ranges;
+    }
+
+private:
+    vk::UniqueDeviceMemory const m_memory;
+    void* const m_mapped;
+    uint32_t const m_memoryType;
+    RangeAllocator m_ranges;
+};
+
+Allocation::Allocation(
+        MemoryAllocator* allocator,
+        MemoryBlock* block,
+        vk::DeviceSize const offset,
+        vk::DeviceSize const size,
+        uint64_t const generation) noexcept :
+            m_allocator{allocator},
+            m_block{block},
+            m_offset{offset},
+            m_size{size},
+            m_generation{generation}
+{}
+
+Allocation::Allocation(Allocation&& other) noexcept :
+            m_allocator{std::exchange(other.m_allocator, nullptr)},
+            m_block{std::exchange(other.m_block, nullptr)},
+            m_offset{other.m_offset},
+            m_size{other.m_size},
+            m_generation{other.m_generation}
+{}
+
+auto
+Allocation::operator=(Allocation&& other) noexcept -> Allocation&
+{
+    if(this != &other) {
+        release();
+
+        m_allocator  = std::exchange(other.m_allocator, nullptr);
+        m_block      = std::exchange(other.m_block, nullptr);
+        m_offset     = other.m_offset;
+        m_size       = other.m_size;
+        m_generation = other.m_generation;
+    }
+
+    return *this;
+}
+
+Allocation::~Allocation()
+{
+    release();
+}
+
+auto
+Allocation::release() noexcept -> void
+{
+    if(m_allocator != nullptr) {
+        m_allocator->free(*m_block, m_offset, m_generation);
+        m_allocator = nullptr;
+    }
+}
+
+[[nodiscard]] auto
+Allocation::memory() const noexcept -> vk::DeviceMemory
+{
+    return m_block != nullptr ? m_block->memory() : vk::DeviceMemory{};
+}
+
+[[nodiscard]] auto
+Allocation::offset() const noexcept -> vk::DeviceSize
+{
+    return m_offset;
+}
+
+[[nodiscard]] auto
+Allocation::size() const noexcept -> vk::DeviceSize
+{
+    return m_size;
+}
+
+[[nodiscard]] auto
+Allocation::mapped() const noexcept -> void*
+{
+    if(m_block == nullptr || m_block->mapped() == nullptr) {
+        return nullptr;
+    }
+
+    return static_cast<char*>(m_block->mapped()) + m_offset;
+}
+
+auto
+operator<<(std::ostream& stream, MemoryStats const& stats) -> std::ostream&
+{
+    auto constexpr mebibyte = 1024.0 * 1024.0;
+
+    stream << "Device memory:\n";
+    for(auto heap = 0u; heap < stats.heaps.size(); ++heap) {
+        auto const& heapStats = stats.heaps[heap];
+        if(heapStats.blockCount == 0) {
+            continue;
+        }
+
+        stream << "  heap " << heap << ": "
+               << heapStats.usedBytes / mebibyte << " of "
+               << heapStats.reservedBytes / mebibyte << "MiB used in "
+               << heapStats.blockCount << " blocks, "
+               << heapStats.allocationCount << " allocations, heap size "
+               << heapStats.heapSize / mebibyte << "MiB\n";
+    }
+
+    return stream;
+}
+
+MemoryAllocator::MemoryAllocator(
+        vk::Device const& logicalDevice,
+        vk::PhysicalDeviceMemoryProperties const& memoryProperties,
+        vk::PhysicalDeviceLimits const& limits,
+        vk::DeviceSize const blockSize) :
+            m_memoryProperties{memoryProperties},
+            m_bufferImageGranularity{std::max(
+                    limits.bufferImageGranularity,
+                    vk::DeviceSize{1})},
+            m_blockSize{blockSize},
+            m_blocks(m_memoryProperties.memoryTypeCount),
+            m_boundDevice{logicalDevice}
+{}
+
+MemoryAllocator::~MemoryAllocator() = default;
+
+[[nodiscard]] auto
+MemoryAllocator::boundDevice() const noexcept -> vk::Device const&
+{
+    return m_boundDevice.get();
+}
+
+// Small heaps, such as the host visible window into device local memory,
+// get proportionally smaller blocks so that one block cannot exhaust them.
+[[nodiscard]] auto
+MemoryAllocator::block_size(uint32_t const memoryType) const noexcept
+        -> vk::DeviceSize
+{
+    auto const heapIndex = m_memoryProperties.memoryTypes[memoryType].heapIndex;
+    auto const heapSize  = m_memoryProperties.memoryHeaps[heapIndex].size;
+
+    return std::min(m_blockSize, heapSize / 8);
+}
+
+[[nodiscard]] auto
+MemoryAllocator::allocate(
+        vk::MemoryRequirements const& requirements,
+        vk::MemoryPropertyFlags const properties,
+        ResourceKind const kind,
+        AllocationStrategy const strategy) -> Allocation
+{
+    auto const memoryType = find_memory_type(
+            m_memoryProperties,
+            requirements.memoryTypeBits,
+            properties);
+
+    auto const lock = std::lock_guard{m_mutex};
+    auto& blocks    = m_blocks[memoryType];
+
+    for(auto const& block : blocks) {
+        if(block->ranges().strategy() != strategy) {
+            continue;
+        }
+
+        auto const offset = block->ranges().try_allocate(
+                requirements.size,
+                requirements.alignment,
+                kind);
+        if(offset) {
+            return Allocation{
+                    this,
+                    block.get(),
+                    *offset,
+                    requirements.size,
+                    block->ranges().generation()};
+        }
+    }
+
+    auto const hostVisible =
+            static_cast<bool>(
+                    m_memoryProperties.memoryTypes[memoryType].propertyFlags
+                    & vk::MemoryPropertyFlagBits::eHostVisible);
+
+    auto& block = blocks.emplace_back(std::make_unique<MemoryBlock>(
+            m_boundDevice.get(),
+            memoryType,
+            std::max(block_size(memoryType), requirements.size),
+            hostVisible,
+            strategy,
+            m_bufferImageGranularity));
+
+    auto const offset = block->ranges().try_allocate(
+            requirements.size,
+            requirements.alignment,
+            kind);
+
+    return Allocation{
+            this,
+            block.get(),
+            offset.value(),
+            requirements.size,
+            block->ranges().generation()};
+}
+
+[[nodiscard]] auto
+MemoryAllocator::create_buffer(
+        vk::BufferCreateInfo const& createInfo,
+        vk::MemoryPropertyFlags const properties,
+        AllocationStrategy const strategy) -> AllocatedBuffer
+{
+    auto const& logicalDevice = m_boundDevice.get();
+
+    auto buffer     = logicalDevice.createBufferUnique(createInfo);
+    auto allocation = allocate(
+            logicalDevice.getBufferMemoryRequirements(*buffer),
+            properties,
+            ResourceKind::Linear,
+            strategy);
+
+    logicalDevice.bindBufferMemory(
+            *buffer,
+            allocation.memory(),
+            allocation.offset());
+
+    return {std::move(allocation), std::move(buffer)};
+}
+
+[[nodiscard]] auto
+MemoryAllocator::create_image(
+        vk::ImageCreateInfo const& createInfo,
+        vk::MemoryPropertyFlags const properties) -> AllocatedImage
+{
+    auto const& logicalDevice = m_boundDevice.get();
+
+    auto const kind = createInfo.tiling == vk::ImageTiling::eOptimal
+                              ? ResourceKind::Optimal
+                              : ResourceKind::Linear;
+
+    auto image      = logicalDevice.createImageUnique(createInfo);
+    auto allocation = allocate(
+            logicalDevice.getImageMemoryRequirements(*image),
+            properties,
+            kind);
+
+    logicalDevice.bindImageMemory(
+            *image,
+            allocation.memory(),
+            allocation.offset());
+
+    return {std::move(allocation), std::move(image)};
+}
+
+auto
+MemoryAllocator::reset_linear() -> void
+{
+    auto const lock = std::lock_guard{m_mutex};
+
+    for(auto& blocks : m_blocks) {
+        for(auto& block : blocks) {
+            if(block->ranges().strategy() == AllocationStrategy::Linear) {
+                block->ranges().reset();
+            }
+        }
+    }
+}
+
+// Empty free list blocks are returned to the driver, except for the last
+// one of their memory type, which is kept around to avoid churn.
+auto
+MemoryAllocator::free(
+        MemoryBlock& block,
+        vk::DeviceSize const offset,
+        uint64_t const generation) -> void
+{
+    auto const lock = std::lock_guard{m_mutex};
+
+    block.ranges().free(offset, generation);
+
+    if(block.ranges().strategy() != AllocationStrategy::FreeList
+       || block.ranges().allocationCount() != 0) {
+        return;
+    }
+
+    auto& blocks = m_blocks[block.memoryType()];
+
+    auto const freeListBlocks = std::count_if(
+            std::cbegin(blocks),
+            std::cend(blocks),
+            [](std::unique_ptr<MemoryBlock> const& candidate) {
+                return candidate->ranges().strategy()
+                       == AllocationStrategy::FreeList;
+            });
+
+    if(freeListBlocks > 1) {
+        blocks.erase(std::find_if(
+                std::begin(blocks),
+                std::end(blocks),
+                [&block](std::unique_ptr<MemoryBlock> const& candidate) {
+                    return candidate.get() == &block;
+                }));
+    }
+}
+
+[[nodiscard]] auto
+MemoryAllocator::stats() const -> MemoryStats
+{
+    auto stats = MemoryStats{};
+    stats.heaps.resize(m_memoryProperties.memoryHeapCount);
+
+    for(auto heap = 0u; heap < m_memoryProperties.memoryHeapCount; ++heap) {
+        stats.heaps[heap].heapSize = m_memoryProperties.memoryHeaps[heap].size;
+    }
+
+    auto const lock = std::lock_guard{m_mutex};
+
+    for(auto type = 0u; type < m_blocks.size(); ++type) {
+        auto& heapStats =
+                stats.heaps[m_memoryProperties.memoryTypes[type].heapIndex];
+
+        for(auto const& block : m_blocks[type]) {
+            heapStats.reservedBytes += block->ranges().size();
+            heapStats.usedBytes += block->ranges().used();
+            heapStats.allocationCount += block->ranges().allocationCount();
+            ++heapStats.blockCount;
+        }
+    }
+
+    return stats;
+}
+
+}    // namespace vulkanUtils
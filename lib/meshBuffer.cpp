@@ -0,0 +1,82 @@
+#include "meshBuffer.hpp"
+
+#include <stdexcept>
+
+namespace vulkanUtils {
+
+[[nodiscard]] auto
+upload_buffer(
+        MemoryAllocator& allocator,
+        TransferBatch& transfers,
+        gsl::span<std::byte const> const data,
+        vk::BufferUsageFlags const usage) -> AllocatedBuffer
+{
+    if(data.empty()) {
+        throw std::invalid_argument("Uploaded buffers cannot be empty");
+    }
+
+    auto buffer = allocator.create_buffer(
+            vk::BufferCreateInfo(
+                    {},
+                    data.size(),
+                    usage | vk::BufferUsageFlagBits::eTransferDst,
+                    vk::SharingMode::eExclusive),
+            vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+    transfers.upload(*buffer.buffer, 0, data);
+
+    return buffer;
+}
+
+MeshBuffer::MeshBuffer(
+        MemoryAllocator& allocator,
+        TransferBatch& transfers,
+        gsl::span<std::byte const> const vertexData,
+        gsl::span<uint32_t const> const indices) :
+            m_vertices{upload_buffer(
+                    allocator,
+                    transfers,
+                    vertexData,
+                    vk::BufferUsageFlagBits::eVertexBuffer)},
+            m_indices{upload_buffer(
+                    allocator,
+                    transfers,
+                    gsl::as_bytes(indices),
+                    vk::BufferUsageFlagBits::eIndexBuffer)},
+            m_indexCount{static_cast<uint32_t>(indices.size())}
+{}
+
+[[nodiscard]] auto
+MeshBuffer::vertexBuffer() const noexcept -> vk::Buffer const&
+{
+    return *m_vertices.buffer;
+}
+
+[[nodiscard]] auto
+MeshBuffer::indexBuffer() const noexcept -> vk::Buffer const&
+{
+    return *m_indices.buffer;
+}
+
+[[nodiscard]] auto
+MeshBuffer::indexCount() const noexcept -> uint32_t
+{
+    return m_indexCount;
+}
+
+auto
+MeshBuffer::bind(vk::CommandBuffer const& commandBuffer) const -> void
+{
+    auto constexpr offset = vk::DeviceSize{0};
+
+    commandBuffer.bindVertexBuffers(0, *m_vertices.buffer, offset);
+    commandBuffer.bindIndexBuffer(*m_indices.buffer, 0, vk::IndexType::eUint32);
+}
+
+auto
+MeshBuffer::draw(vk::CommandBuffer const& commandBuffer) const -> void
+{
+    commandBuffer.drawIndexed(m_indexCount, 1, 0, 0, 0);
+}
+
+}    // namespace vulkanUtils
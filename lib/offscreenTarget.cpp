@@ -0,0 +1,98 @@
+#include "offscreenTarget.hpp"
+
+#include <algorithm>
+
+[[nodiscard]] auto
+create_offscreen_images(
+        vulkanUtils::MemoryAllocator& allocator,
+        vk::Format const format,
+        vk::Extent2D const extent,
+        uint32_t const imageCount) -> std::vector<vulkanUtils::AllocatedImage>
+{
+    auto const creationInfo = vk::ImageCreateInfo(
+            {},
+            vk::ImageType::e2D,
+            format,
+            vk::Extent3D{extent.width, extent.height, 1},
+            1,
+            1,
+            vk::SampleCountFlagBits::e1,
+            vk::ImageTiling::eOptimal,
+            vk::ImageUsageFlagBits::eColorAttachment
+                    | vk::ImageUsageFlagBits::eTransferSrc,
+            vk::SharingMode::eExclusive,
+            0,
+            nullptr,
+            vk::ImageLayout::eUndefined);
+
+    auto images = std::vector<vulkanUtils::AllocatedImage>{};
+    images.reserve(imageCount);
+
+    for(auto i = 0u; i < imageCount; ++i) {
+        images.push_back(allocator.create_image(
+                creationInfo,
+                vk::MemoryPropertyFlagBits::eDeviceLocal));
+    }
+
+    return images;
+}
+
+[[nodiscard]] auto
+image_handles(std::vector<vulkanUtils::AllocatedImage> const& images)
+        -> std::vector<vk::Image>
+{
+    auto handles = std::vector<vk::Image>(images.size());
+    std::transform(
+            std::cbegin(images),
+            std::cend(images),
+            std::begin(handles),
+            [](vulkanUtils::AllocatedImage const& image) {
+                return *image.image;
+            });
+
+    return handles;
+}
+
+namespace vulkanUtils {
+
+OffscreenTarget::OffscreenTarget(
+        MemoryAllocator& allocator,
+        vk::Format const format,
+        vk::Extent2D const extent,
+        uint32_t const imageCount) :
+            m_format{format},
+            m_extent{extent},
+            m_images{create_offscreen_images(
+                    allocator,
+                    format,
+                    extent,
+                    imageCount)},
+            m_imageHandles{image_handles(m_images)},
+            m_boundDevice{allocator.boundDevice()}
+{}
+
+[[nodiscard]] auto
+OffscreenTarget::boundDevice() const noexcept -> vk::Device const&
+{
+    return m_boundDevice.get();
+}
+
+[[nodiscard]] auto
+OffscreenTarget::format() const noexcept -> vk::Format
+{
+    return m_format;
+}
+
+[[nodiscard]] auto
+OffscreenTarget::extent() const noexcept -> vk::Extent2D
+{
+    return m_extent;
+}
+
+[[nodiscard]] auto
+OffscreenTarget::images() const noexcept -> std::vector<vk::Image> const&
+{
+    return m_imageHandles;
+}
+
+}    // namespace vulkanUtils
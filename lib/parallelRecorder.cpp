@@ -0,0 +1,202 @@
+#include "parallelRecorder.hpp"
+
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+[[nodiscard]] auto
+create_worker_allocators(
+        vk::Device const& logicalDevice,
+        uint32_t const queueFamily,
+        uint32_t const threadCount,
+        uint32_t const framesInFlight)
+        -> std::vector<vulkanUtils::CommandAllocator>
+{
+    if(threadCount == 0) {
+        throw std::invalid_argument("A parallel recorder needs a thread");
+    }
+
+    auto allocators = std::vector<vulkanUtils::CommandAllocator>{};
+    allocators.reserve(threadCount);
+
+    for(auto i = 0u; i < threadCount; ++i) {
+        allocators.emplace_back(logicalDevice, queueFamily, framesInFlight);
+    }
+
+    return allocators;
+}
+
+namespace vulkanUtils {
+
+ParallelRecorder::ParallelRecorder(
+        vk::Device const& logicalDevice,
+        uint32_t const queueFamily,
+        uint32_t const threadCount,
+        uint32_t const framesInFlight) :
+            m_allocators{create_worker_allocators(
+                    logicalDevice,
+                    queueFamily,
+                    threadCount,
+                    framesInFlight)},
+            m_recorded(threadCount),
+            m_job{},
+            m_generation{0},
+            m_remaining{0},
+            m_stopping{false},
+            m_errors(threadCount),
+            m_boundDevice{logicalDevice}
+{
+    m_threads.reserve(threadCount);
+
+    // A thread that fails to start must not leave the started ones joinable.
+    try {
+        for(auto worker = 0u; worker < threadCount; ++worker) {
+            m_threads.emplace_back([this, worker] { work(worker); });
+        }
+    }
+    catch(...) {
+        stop();
+        throw;
+    }
+}
+
+ParallelRecorder::~ParallelRecorder()
+{
+    stop();
+}
+
+auto
+ParallelRecorder::stop() -> void
+{
+    {
+        auto const lock = std::lock_guard{m_mutex};
+        m_stopping      = true;
+    }
+
+    m_jobReady.notify_all();
+
+    for(auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+[[nodiscard]] auto
+ParallelRecorder::boundDevice() const noexcept -> vk::Device const&
+{
+    return m_boundDevice.get();
+}
+
+[[nodiscard]] auto
+ParallelRecorder::threadCount() const noexcept -> uint32_t
+{
+    return static_cast<uint32_t>(m_recorded.size());
+}
+
+// Only read between frames, while no worker is recording.
+[[nodiscard]] auto
+ParallelRecorder::allocationCount() const -> uint64_t
+{
+    auto const lock = std::lock_guard{m_mutex};
+
+    return std::accumulate(
+            std::cbegin(m_allocators),
+            std::cend(m_allocators),
+            uint64_t{0},
+            [](uint64_t const sum, CommandAllocator const& allocator) {
+                return sum + allocator.allocationCount();
+            });
+}
+
+[[nodiscard]] auto
+ParallelRecorder::record(
+        uint32_t const frameIndex,
+        vk::CommandBufferInheritanceInfo const& inheritance,
+        uint32_t const drawCount,
+        RecordSlice const& recordSlice) -> std::vector<vk::CommandBuffer> const&
+{
+    auto lock = std::unique_lock{m_mutex};
+
+    m_job       = {frameIndex, &inheritance, drawCount, &recordSlice};
+    m_remaining = threadCount();
+    ++m_generation;
+
+    lock.unlock();
+    m_jobReady.notify_all();
+    lock.lock();
+
+    m_jobDone.wait(lock, [this] { return m_remaining == 0; });
+
+    for(auto& error : m_errors) {
+        if(error) {
+            std::rethrow_exception(std::exchange(error, nullptr));
+        }
+    }
+
+    return m_recorded;
+}
+
+auto
+ParallelRecorder::work(uint32_t const worker) -> void
+{
+    auto generation = uint64_t{0};
+
+    while(true) {
+        auto lock = std::unique_lock{m_mutex};
+        m_jobReady.wait(lock, [&] {
+            return m_stopping || m_generation != generation;
+        });
+
+        if(m_stopping) {
+            return;
+        }
+
+        generation     = m_generation;
+        auto const job = m_job;
+        lock.unlock();
+
+        auto error = std::exception_ptr{};
+        try {
+            record_slice(worker, job);
+        }
+        catch(...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        m_errors[worker] = error;
+
+        if(--m_remaining == 0) {
+            m_jobDone.notify_one();
+        }
+    }
+}
+
+auto
+ParallelRecorder::record_slice(uint32_t const worker, Job const& job) -> void
+{
+    auto& allocator = m_allocators[worker];
+
+    auto const workers = uint64_t{threadCount()};
+    auto const first =
+            static_cast<uint32_t>(job.drawCount * uint64_t{worker} / workers);
+    auto const last = static_cast<uint32_t>(
+            job.drawCount * (uint64_t{worker} + 1) / workers);
+
+    allocator.reset(job.frameIndex);
+    auto const commandBuffer = allocator.allocate(
+            job.frameIndex,
+            vk::CommandBufferLevel::eSecondary);
+
+    commandBuffer.begin(vk::CommandBufferBeginInfo(
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit
+                    | vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+            job.inheritance));
+
+    (*job.recordSlice)(commandBuffer, first, last - first);
+
+    commandBuffer.end();
+
+    m_recorded[worker] = commandBuffer;
+}
+
+}    // namespace vulkanUtils
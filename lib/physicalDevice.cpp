@@ -4,80 +4,235 @@
 #include <numeric>
 #include <algorithm>
 #include <functional>
-#include <cstring>
 #include <tuple>
+#include <cctype>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
 
+#include <gsl/gsl>
+
+// vk::PhysicalDeviceFeatures is nothing but a list of VkBool32 flags.
 [[nodiscard]] auto
-get_next_graphics_queue_family(
-        vk::PhysicalDevice const& device,
-        long startIndex) -> vulkanUtils::QueueFamily
+feature_flags(vk::PhysicalDeviceFeatures const& features) noexcept
+        -> gsl::span<VkBool32 const>
 {
-    auto constexpr isGraphicsQueue = [](vk::QueueFamilyProperties const& prop) {
-        return (prop.queueFlags & vk::QueueFlagBits::eGraphics)
-               == vk::QueueFlagBits::eGraphics;
-    };
+    return {reinterpret_cast<VkBool32 const*>(&features),
+            sizeof(features) / sizeof(VkBool32)};
+}
 
-    auto const queueProperties = device.getQueueFamilyProperties();
-    auto const queueIterator   = std::find_if(
-            std::cbegin(queueProperties) + startIndex,
-            std::cend(queueProperties),
-            isGraphicsQueue);
+[[nodiscard]] auto
+supports_features(
+        vk::PhysicalDeviceFeatures const& supported,
+        vk::PhysicalDeviceFeatures const& required) noexcept -> bool
+{
+    auto const supportedFlags = feature_flags(supported);
+    auto const requiredFlags  = feature_flags(required);
 
-    if(queueIterator == std::cend(queueProperties)) {
-        throw std::runtime_error{"Physical device has no next graphics queue!"};
-    }
+    return std::equal(
+            std::cbegin(requiredFlags),
+            std::cend(requiredFlags),
+            std::cbegin(supportedFlags),
+            [](VkBool32 isRequired, VkBool32 isSupported) {
+                return isRequired != VK_TRUE || isSupported == VK_TRUE;
+            });
+}
+
+[[nodiscard]] auto
+count_features(
+        vk::PhysicalDeviceFeatures const& supported,
+        vk::PhysicalDeviceFeatures const& wanted) noexcept -> uint32_t
+{
+    auto const supportedFlags = feature_flags(supported);
+    auto const wantedFlags    = feature_flags(wanted);
 
-    return {*queueIterator, queueIterator - std::cbegin(queueProperties)};
+    return std::inner_product(
+            std::cbegin(wantedFlags),
+            std::cend(wantedFlags),
+            std::cbegin(supportedFlags),
+            0u,
+            std::plus<>{},
+            [](VkBool32 isWanted, VkBool32 isSupported) {
+                return isWanted == VK_TRUE && isSupported == VK_TRUE ? 1u
+                                                                     : 0u;
+            });
 }
 
 [[nodiscard]] auto
-supports_extensions(
-        vk::PhysicalDevice const& device,
-        std::vector<char const*> const& requiredExtensions) noexcept -> bool
+type_rank(vk::PhysicalDeviceType const type) noexcept -> uint32_t
 {
-    auto const supportedExtensions =
-            device.enumerateDeviceExtensionProperties();
+    switch(type) {
+    case vk::PhysicalDeviceType::eDiscreteGpu:
+        return 4;
+    case vk::PhysicalDeviceType::eIntegratedGpu:
+        return 3;
+    case vk::PhysicalDeviceType::eVirtualGpu:
+        return 2;
+    case vk::PhysicalDeviceType::eCpu:
+        return 1;
+    default:
+        return 0;
+    }
+}
 
-    for(auto const& requiredExtension : requiredExtensions) {
-        bool supportsExtension = false;
-        for(auto const& supportedExtension : supportedExtensions) {
-            if(strcmp(supportedExtension.extensionName, requiredExtension)
-               != 0) {
-                supportsExtension = true;
-            }
+[[nodiscard]] auto
+device_local_memory(
+        vk::PhysicalDeviceMemoryProperties const& memoryProperties) noexcept
+        -> vk::DeviceSize
+{
+    auto size = vk::DeviceSize{};
+    for(auto i = 0u; i < memoryProperties.memoryHeapCount; ++i) {
+        auto const& heap = memoryProperties.memoryHeaps[i];
+        if(heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal) {
+            size += heap.size;
         }
+    }
+
+    return size;
+}
+
+// Accepts either an index into the enumerated devices or a part of a
+// device's name.
+[[nodiscard]] auto
+device_override(std::vector<vulkanUtils::DeviceCapabilities> const& devices)
+        -> std::optional<size_t>
+{
+    auto const* value =
+            std::getenv(vulkanUtils::PhysicalDevice::overrideVariable);
+    if(value == nullptr || *value == '\0') {
+        return std::nullopt;
+    }
+
+    auto const requested = std::string_view{value};
+    auto const isIndex   = std::all_of(
+            std::cbegin(requested),
+            std::cend(requested),
+            [](unsigned char c) { return std::isdigit(c) != 0; });
 
-        if(!supportsExtension) {
-            std::cerr << requiredExtension << " not supported.\n";
-            return false;
+    for(auto i = size_t{0}; i < devices.size(); ++i) {
+        auto const name = std::string_view{
+                devices[i].info().properties.deviceName.data()};
+        auto const matches = isIndex ? std::to_string(i) == requested
+                                     : name.find(requested) != name.npos;
+        if(matches) {
+            return i;
         }
     }
 
-    return true;
+    std::cerr << vulkanUtils::PhysicalDevice::overrideVariable << "="
+              << requested << " matches no device, ignoring it\n";
+
+    return std::nullopt;
 }
 
 [[nodiscard]] auto
-get_compatible_device(
+select_device(
         vk::Instance const& instance,
-        std::vector<char const*> const& requiredExtensions) noexcept
-        -> vk::PhysicalDevice
-{
-    auto const physicalDevices = instance.enumeratePhysicalDevices();
-    return *std::find_if(
-            physicalDevices.cbegin(),
-            physicalDevices.cend(),
-            [&](auto&& device) {
-                return supports_extensions(device, requiredExtensions)
-                       && device.getFeatures().geometryShader;
-            });
+        std::vector<char const*> const& requiredExtensions,
+        vk::PhysicalDeviceFeatures const& requiredFeatures,
+        vk::PhysicalDeviceFeatures const& optionalFeatures,
+        vulkanUtils::CapabilityCache* const capabilityCache)
+        -> vulkanUtils::DeviceCapabilities
+{
+    auto infos = capabilityCache != nullptr
+                         ? capabilityCache->enumerate_devices(instance)
+                         : vulkanUtils::enumerate_devices(instance);
+
+    auto devices = std::vector<vulkanUtils::DeviceCapabilities>{};
+    devices.reserve(infos.size());
+    for(auto& info : infos) {
+        devices.emplace_back(std::move(info));
+    }
+
+    auto const suitable = [&](vulkanUtils::DeviceCapabilities const& device) {
+        return device.supports_extensions(requiredExtensions)
+               && supports_features(device.info().features, requiredFeatures);
+    };
+
+    if(auto const index = device_override(devices)) {
+        if(suitable(devices[*index])) {
+            return std::move(devices[*index]);
+        }
+
+        std::cerr << devices[*index].info().properties.deviceName.data()
+                  << " does not meet the requirements, ignoring "
+                  << vulkanUtils::PhysicalDevice::overrideVariable << '\n';
+    }
+
+    auto best      = std::end(devices);
+    auto bestScore = vulkanUtils::DeviceScore{};
+    for(auto device = std::begin(devices); device != std::end(devices);
+        ++device) {
+        if(!suitable(*device)) {
+            continue;
+        }
+
+        auto const score =
+                vulkanUtils::score_device(device->info(), optionalFeatures);
+        if(best == std::end(devices) || bestScore < score) {
+            best      = device;
+            bestScore = score;
+        }
+    }
+
+    if(best == std::end(devices)) {
+        throw std::runtime_error(
+                "No physical device supports the required extensions and "
+                "features!");
+    }
+
+    return std::move(*best);
 }
 
 namespace vulkanUtils {
+
+[[nodiscard]] auto
+operator<(DeviceScore const& lhs, DeviceScore const& rhs) noexcept -> bool
+{
+    return std::tie(lhs.typeRank, lhs.deviceLocalMemory, lhs.optionalFeatures)
+           < std::tie(
+                   rhs.typeRank,
+                   rhs.deviceLocalMemory,
+                   rhs.optionalFeatures);
+}
+
+[[nodiscard]] auto
+enumerate_devices(vk::Instance const& instance) -> std::vector<DeviceInfo>
+{
+    auto devices = std::vector<DeviceInfo>{};
+
+    for(auto const& device : instance.enumeratePhysicalDevices()) {
+        devices.push_back(query_device(device));
+    }
+
+    return devices;
+}
+
+[[nodiscard]] auto
+score_device(
+        DeviceInfo const& device,
+        vk::PhysicalDeviceFeatures const& optionalFeatures) noexcept
+        -> DeviceScore
+{
+    return {type_rank(device.properties.deviceType),
+            device_local_memory(device.memoryProperties),
+            count_features(device.features, optionalFeatures)};
+}
+
 PhysicalDevice::PhysicalDevice(
         vk::Instance const& instance,
-        std::vector<char const*> extensions) :
-            m_physicalDevice{get_compatible_device(instance, extensions)},
+        std::vector<char const*> extensions,
+        vk::PhysicalDeviceFeatures const& requiredFeatures,
+        vk::PhysicalDeviceFeatures const& optionalFeatures,
+        CapabilityCache* const capabilityCache) :
             m_extensions{std::move(extensions)},
+            m_capabilities{select_device(
+                    instance,
+                    m_extensions,
+                    requiredFeatures,
+                    optionalFeatures,
+                    capabilityCache)},
             m_boundInstance{instance}
 {}
 
@@ -93,49 +248,91 @@ PhysicalDevice::extensions() const noexcept -> std::vector<char const*> const&
     return m_extensions;
 }
 
+[[nodiscard]] auto
+PhysicalDevice::capabilities() const noexcept -> DeviceCapabilities const&
+{
+    return m_capabilities;
+}
+
+[[nodiscard]] auto
+PhysicalDevice::properties() const noexcept
+        -> vk::PhysicalDeviceProperties const&
+{
+    return m_capabilities.info().properties;
+}
+
+[[nodiscard]] auto
+PhysicalDevice::features() const noexcept -> vk::PhysicalDeviceFeatures const&
+{
+    return m_capabilities.info().features;
+}
+
+[[nodiscard]] auto
+PhysicalDevice::memoryProperties() const noexcept
+        -> vk::PhysicalDeviceMemoryProperties const&
+{
+    return m_capabilities.info().memoryProperties;
+}
+
 [[nodiscard]] auto
 PhysicalDevice::operator*() const noexcept -> vk::PhysicalDevice const&
 {
-    return m_physicalDevice;
+    return m_capabilities.info().device;
 }
 
 [[nodiscard]] auto
 PhysicalDevice::operator->() const noexcept -> vk::PhysicalDevice const*
 {
-    return &m_physicalDevice;
+    return &m_capabilities.info().device;
+}
+
+[[nodiscard]] auto
+PhysicalDevice::queueFamilies() const noexcept
+        -> std::vector<vk::QueueFamilyProperties> const&
+{
+    return m_capabilities.info().queueFamilies;
 }
 
 [[nodiscard]] auto
 PhysicalDevice::graphics_queue_family() const -> QueueFamily
 {
-    return get_next_graphics_queue_family(m_physicalDevice, 0);
+    auto const& families =
+            m_capabilities.queue_families(vk::QueueFlagBits::eGraphics);
+    if(families.empty()) {
+        throw std::runtime_error{"Physical device has no graphics queue!"};
+    }
+
+    auto const index = families.front();
+    return {m_capabilities.info().queueFamilies[index],
+            static_cast<long>(index)};
 }
 
+// Tries the graphics families from the given one onwards, so that graphics
+// and presentation share a family whenever they can.
 [[nodiscard]] auto
 PhysicalDevice::present_queue_family(
         QueueFamily firstGraphicsQueueFamily,
         vk::SurfaceKHR const& surface) const -> QueueFamily
 {
-    auto presentationFamily = firstGraphicsQueueFamily;
+    auto const& info = m_capabilities.info();
+    auto const& families =
+            m_capabilities.queue_families(vk::QueueFlagBits::eGraphics);
 
-    try {
-        while(m_physicalDevice.getSurfaceSupportKHR(
-                      presentationFamily.position,
-                      surface)
-              == 0u) {
-            presentationFamily = get_next_graphics_queue_family(
-                    m_physicalDevice,
-                    presentationFamily.position + 1);
-        }
-    }
-    catch(std::exception const& e) {
-        using namespace std::string_literals;
-        throw std::runtime_error(
-                "Could not find a presentationQueueFamily because:\n"s
-                + e.what());
+    auto const family = std::find_if(
+            std::cbegin(families),
+            std::cend(families),
+            [&](uint32_t const index) {
+                return static_cast<long>(index)
+                               >= firstGraphicsQueueFamily.position
+                       && info.device.getSurfaceSupportKHR(index, surface)
+                                  != 0u;
+            });
+
+    if(family == std::cend(families)) {
+        throw std::runtime_error("Could not find a presentationQueueFamily!");
     }
 
-    return presentationFamily;
+    return {info.queueFamilies[*family], static_cast<long>(*family)};
 }
 
 }    // namespace vulkanUtils
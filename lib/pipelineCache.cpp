@@ -0,0 +1,345 @@
+#include "pipelineCache.hpp"
+#include "hashUtility.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+auto constexpr cacheFileMagic   = uint32_t{0x43544b56};    // "VKTC"
+auto constexpr cacheFileVersion = uint32_t{1};
+
+struct CacheFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    std::array<uint8_t, VK_UUID_SIZE> pipelineCacheUUID;
+    uint64_t dataSize;
+    uint64_t dataHash;
+};
+
+[[nodiscard]] auto
+expected_header(vk::PhysicalDeviceProperties const& properties) noexcept
+        -> CacheFileHeader
+{
+    auto header          = CacheFileHeader{};
+    header.magic         = cacheFileMagic;
+    header.version       = cacheFileVersion;
+    header.vendorID      = properties.vendorID;
+    header.deviceID      = properties.deviceID;
+    header.driverVersion = properties.driverVersion;
+
+    std::copy(
+            std::cbegin(properties.pipelineCacheUUID),
+            std::cend(properties.pipelineCacheUUID),
+            std::begin(header.pipelineCacheUUID));
+
+    return header;
+}
+
+[[nodiscard]] auto
+header_matches(
+        CacheFileHeader const& stored,
+        CacheFileHeader const& expected) noexcept -> bool
+{
+    return stored.magic == expected.magic && stored.version == expected.version
+           && stored.vendorID == expected.vendorID
+           && stored.deviceID == expected.deviceID
+           && stored.driverVersion == expected.driverVersion
+           && stored.pipelineCacheUUID == expected.pipelineCacheUUID;
+}
+
+// The blob is only handed to the driver if both our own header and the
+// VkPipelineCacheHeaderVersionOne at the start of the data agree with the
+// device, otherwise an empty cache is created.
+[[nodiscard]] auto
+read_cache_blob(
+        std::string const& filePath,
+        vk::PhysicalDeviceProperties const& properties) -> std::vector<uint8_t>
+{
+    auto file = std::ifstream(filePath, std::ios::binary);
+    if(!file.is_open()) {
+        return {};
+    }
+
+    auto stored = CacheFileHeader{};
+    file.read(reinterpret_cast<char*>(&stored), sizeof(stored));
+
+    auto const expected = expected_header(properties);
+    if(!file || !header_matches(stored, expected)) {
+        std::cerr << "Pipeline cache " << filePath
+                  << " is stale, starting cold\n";
+        return {};
+    }
+
+    // Read to the end rather than sized by the header, a corrupt size must
+    // not decide how much is allocated.
+    auto data = std::vector<uint8_t>(
+            std::istreambuf_iterator<char>{file},
+            std::istreambuf_iterator<char>{});
+
+    auto constexpr vkHeaderSize = 16u + VK_UUID_SIZE;
+    auto const dataHash = vulkanUtils::fnv1a(data.data(), data.size());
+    if(data.size() != stored.dataSize || data.size() < vkHeaderSize
+       || dataHash != stored.dataHash
+       || std::memcmp(
+                  data.data() + 16u,
+                  expected.pipelineCacheUUID.data(),
+                  VK_UUID_SIZE)
+                  != 0) {
+        std::cerr << "Pipeline cache " << filePath
+                  << " is corrupt, starting cold\n";
+        return {};
+    }
+
+    return data;
+}
+
+[[nodiscard]] auto
+load_pipeline_cache(
+        vk::Device const& logicalDevice,
+        vk::PhysicalDeviceProperties const& properties,
+        std::string const& filePath,
+        vulkanUtils::PipelineCacheStats& stats) -> vk::UniquePipelineCache
+{
+    auto const start = Clock::now();
+    auto const blob  = read_cache_blob(filePath, properties);
+
+    auto cache = logicalDevice.createPipelineCacheUnique(
+            vk::PipelineCacheCreateInfo({}, blob.size(), blob.data()));
+
+    stats.loadedFromDisk = !blob.empty();
+    stats.loadTime       = Clock::now() - start;
+
+    return cache;
+}
+
+}    // namespace
+
+namespace vulkanUtils {
+
+auto
+operator<<(std::ostream& stream, PipelineCacheStats const& stats)
+        -> std::ostream&
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    auto const averageMs = [](std::chrono::nanoseconds total, uint32_t count) {
+        return count == 0 ? 0.0 : Milliseconds(total).count() / count;
+    };
+
+    return stream << "Pipeline cache: "
+                  << (stats.loadedFromDisk ? "warm" : "cold") << " start, "
+                  << "loaded in " << Milliseconds(stats.loadTime).count()
+                  << "ms\n"
+                  << "  hits:   " << stats.hits << " ("
+                  << averageMs(stats.hitTime, stats.hits) << "ms avg)\n"
+                  << "  misses: " << stats.misses << " ("
+                  << averageMs(stats.missTime, stats.misses) << "ms avg)\n"
+                  << "  overlapped: " << stats.overlapped << " ("
+                  << averageMs(stats.overlappedTime, stats.overlapped)
+                  << "ms avg), grew the cache by " << stats.overlappedGrowth
+                  << " bytes\n";
+}
+
+PipelineCache::PipelineCache(
+        vk::Device const& logicalDevice,
+        vk::PhysicalDeviceProperties const& deviceProperties,
+        std::string filePath) :
+            m_deviceProperties{deviceProperties},
+            m_filePath{std::move(filePath)},
+            m_stats{},
+            m_activeCreations{0},
+            m_startedCreations{0},
+            m_pipelineCache{load_pipeline_cache(
+                    logicalDevice,
+                    m_deviceProperties,
+                    m_filePath,
+                    m_stats)},
+            m_boundDevice{logicalDevice}
+{}
+
+PipelineCache::~PipelineCache()
+{
+    try {
+        save();
+    }
+    catch(std::exception const& e) {
+        std::cerr << "Pipeline cache could not be saved: " << e.what() << '\n';
+    }
+}
+
+[[nodiscard]] auto
+PipelineCache::boundDevice() const noexcept -> vk::Device const&
+{
+    return m_boundDevice.get();
+}
+
+[[nodiscard]] auto
+PipelineCache::filePath() const noexcept -> std::string const&
+{
+    return m_filePath;
+}
+
+[[nodiscard]] auto
+PipelineCache::stats() const -> PipelineCacheStats
+{
+    auto const lock = std::lock_guard{m_statsMutex};
+    return m_stats;
+}
+
+[[nodiscard]] auto
+PipelineCache::cache_size() const -> size_t
+{
+    auto size = size_t{};
+    auto const result = m_boundDevice.get().getPipelineCacheData(
+            *m_pipelineCache,
+            &size,
+            nullptr);
+
+    return result == vk::Result::eSuccess ? size : 0u;
+}
+
+[[nodiscard]] auto
+PipelineCache::start_creation() -> Creation
+{
+    auto const lock = std::lock_guard{m_statsMutex};
+
+    ++m_activeCreations;
+    return {++m_startedCreations, m_activeCreations == 1};
+}
+
+// Another creation's insertions land between the two size reads, so unless
+// this one ran alone the growth is only added to the overlapped total.
+auto
+PipelineCache::finish_creation(
+        Creation const& creation,
+        std::chrono::nanoseconds const duration,
+        size_t const growth) -> void
+{
+    auto const lock = std::lock_guard{m_statsMutex};
+    --m_activeCreations;
+
+    auto const ranAlone = creation.startedAlone
+                          && m_startedCreations == creation.number;
+    if(!ranAlone) {
+        ++m_stats.overlapped;
+        m_stats.overlappedTime += duration;
+        m_stats.overlappedGrowth += growth;
+    }
+    else if(growth == 0) {
+        ++m_stats.hits;
+        m_stats.hitTime += duration;
+    }
+    else {
+        ++m_stats.misses;
+        m_stats.missTime += duration;
+    }
+}
+
+template<typename Create>
+[[nodiscard]] auto
+PipelineCache::timed_creation(Create const& create) -> vk::UniquePipeline
+{
+    auto const creation = start_creation();
+
+    auto const sizeBefore = cache_size();
+    auto const start      = Clock::now();
+
+    auto pipeline = vk::UniquePipeline{};
+    try {
+        pipeline = create(m_boundDevice.get(), *m_pipelineCache);
+    }
+    catch(...) {
+        auto const lock = std::lock_guard{m_statsMutex};
+        --m_activeCreations;
+        throw;
+    }
+
+    auto const duration  = Clock::now() - start;
+    auto const sizeAfter = cache_size();
+    finish_creation(
+            creation,
+            duration,
+            sizeAfter > sizeBefore ? sizeAfter - sizeBefore : 0);
+
+    return pipeline;
+}
+
+[[nodiscard]] auto
+PipelineCache::create_graphics_pipeline(
+        vk::GraphicsPipelineCreateInfo const& createInfo) -> vk::UniquePipeline
+{
+    return timed_creation(
+            [&](vk::Device const& device, vk::PipelineCache const& cache) {
+                return device.createGraphicsPipelineUnique(cache, createInfo)
+                        .value;
+            });
+}
+
+[[nodiscard]] auto
+PipelineCache::create_compute_pipeline(
+        vk::ComputePipelineCreateInfo const& createInfo) -> vk::UniquePipeline
+{
+    return timed_creation(
+            [&](vk::Device const& device, vk::PipelineCache const& cache) {
+                return device.createComputePipelineUnique(cache, createInfo)
+                        .value;
+            });
+}
+
+auto
+PipelineCache::save() const -> void
+{
+    auto const data =
+            m_boundDevice.get().getPipelineCacheData(*m_pipelineCache);
+
+    auto header     = expected_header(m_deviceProperties);
+    header.dataSize = data.size();
+    header.dataHash = fnv1a(data.data(), data.size());
+
+    auto const path = std::filesystem::path{m_filePath};
+    if(path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+
+    auto tempPath = path;
+    tempPath += ".tmp";
+
+    {
+        auto file = std::ofstream(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        file.write(reinterpret_cast<char const*>(data.data()), data.size());
+        file.flush();
+
+        if(!file) {
+            throw std::runtime_error("Could not write " + tempPath.string());
+        }
+    }
+
+    std::filesystem::rename(tempPath, path);
+}
+
+[[nodiscard]] auto
+PipelineCache::operator*() const noexcept -> vk::PipelineCache const&
+{
+    return *m_pipelineCache;
+}
+
+[[nodiscard]] auto
+PipelineCache::operator->() const noexcept -> vk::PipelineCache const*
+{
+    return &m_pipelineCache.get();
+}
+
+}    // namespace vulkanUtils
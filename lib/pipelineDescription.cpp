@@ -0,0 +1,296 @@
+#include "pipelineDescription.hpp"
+#include "hashUtility.hpp"
+#include "vulkanUtility.hpp"
+
+#include <algorithm>
+
+[[nodiscard]] auto
+hash_blend_attachment(
+        size_t const seed,
+        vk::PipelineColorBlendAttachmentState const& attachment) noexcept
+        -> size_t
+{
+    return vulkanUtils::hash_values(
+            seed,
+            attachment.blendEnable,
+            attachment.srcColorBlendFactor,
+            attachment.dstColorBlendFactor,
+            attachment.colorBlendOp,
+            attachment.srcAlphaBlendFactor,
+            attachment.dstAlphaBlendFactor,
+            attachment.alphaBlendOp,
+            static_cast<VkColorComponentFlags>(attachment.colorWriteMask));
+}
+
+// The data is hashed as bytes, a float constant's value has no std::hash that
+// agrees with comparing its bytes.
+[[nodiscard]] auto
+hash_specialization(
+        size_t const seed,
+        shaderUtils::SpecializationConstants const& constants) noexcept
+        -> size_t
+{
+    auto hash = seed;
+    for(auto const& entry : constants.entries) {
+        hash = vulkanUtils::hash_values(
+                hash,
+                entry.constantID,
+                entry.offset,
+                entry.size);
+    }
+
+    return vulkanUtils::hash_combine(
+            hash,
+            static_cast<size_t>(vulkanUtils::fnv1a(
+                    constants.data.data(),
+                    constants.data.size())));
+}
+
+[[nodiscard]] auto
+has_dynamic_viewport(
+        vulkanUtils::GraphicsPipelineDescription const& description) -> bool
+{
+    auto const& states = description.dynamicStates;
+
+    return std::find(
+                   std::cbegin(states),
+                   std::cend(states),
+                   vk::DynamicState::eViewport)
+                   != std::cend(states)
+           && std::find(
+                      std::cbegin(states),
+                      std::cend(states),
+                      vk::DynamicState::eScissor)
+                      != std::cend(states);
+}
+
+namespace vulkanUtils {
+
+[[nodiscard]] auto
+operator==(ShaderStageDescription const& lhs, ShaderStageDescription const& rhs)
+        -> bool
+{
+    return lhs.stage == rhs.stage && lhs.module == rhs.module
+           && lhs.entryPoint == rhs.entryPoint
+           && lhs.specialization == rhs.specialization;
+}
+
+[[nodiscard]] auto
+operator==(
+        GraphicsPipelineDescription const& lhs,
+        GraphicsPipelineDescription const& rhs) -> bool
+{
+    return lhs.stages == rhs.stages && lhs.vertexBindings == rhs.vertexBindings
+           && lhs.vertexAttributes == rhs.vertexAttributes
+           && lhs.topology == rhs.topology && lhs.polygonMode == rhs.polygonMode
+           && lhs.cullMode == rhs.cullMode && lhs.frontFace == rhs.frontFace
+           && lhs.blendAttachments == rhs.blendAttachments
+           && lhs.blendConstants == rhs.blendConstants
+           && lhs.dynamicStates == rhs.dynamicStates
+           && lhs.extent == rhs.extent && lhs.layout == rhs.layout
+           && lhs.renderPass == rhs.renderPass && lhs.subpass == rhs.subpass;
+}
+
+[[nodiscard]] auto
+operator!=(
+        GraphicsPipelineDescription const& lhs,
+        GraphicsPipelineDescription const& rhs) -> bool
+{
+    return !(lhs == rhs);
+}
+
+[[nodiscard]] auto
+GraphicsPipelineDescriptionHash::operator()(
+        GraphicsPipelineDescription const& description) const noexcept
+        -> size_t
+{
+    auto hash = description.stages.size();
+    for(auto const& stage : description.stages) {
+        hash = hash_values(
+                hash,
+                stage.stage,
+                static_cast<VkShaderModule>(stage.module),
+                stage.entryPoint);
+        hash = hash_specialization(hash, stage.specialization);
+    }
+
+    for(auto const& binding : description.vertexBindings) {
+        hash = hash_values(
+                hash,
+                binding.binding,
+                binding.stride,
+                binding.inputRate);
+    }
+
+    for(auto const& attribute : description.vertexAttributes) {
+        hash = hash_values(
+                hash,
+                attribute.location,
+                attribute.binding,
+                attribute.format,
+                attribute.offset);
+    }
+
+    hash = hash_values(
+            hash,
+            description.topology,
+            description.polygonMode,
+            static_cast<VkCullModeFlags>(description.cullMode),
+            description.frontFace);
+
+    for(auto const& attachment : description.blendAttachments) {
+        hash = hash_blend_attachment(hash, attachment);
+    }
+
+    for(auto const constant : description.blendConstants) {
+        hash = hash_values(hash, constant);
+    }
+
+    for(auto const state : description.dynamicStates) {
+        hash = hash_values(hash, state);
+    }
+
+    return hash_values(
+            hash,
+            description.extent.width,
+            description.extent.height,
+            static_cast<VkPipelineLayout>(description.layout),
+            static_cast<VkRenderPass>(description.renderPass),
+            description.subpass);
+}
+
+[[nodiscard]] auto
+default_pipeline_description() -> GraphicsPipelineDescription
+{
+    auto description = GraphicsPipelineDescription{};
+
+    description.topology    = vk::PrimitiveTopology::eTriangleList;
+    description.polygonMode = vk::PolygonMode::eFill;
+    description.cullMode    = vk::CullModeFlagBits::eBack;
+    description.frontFace   = vk::FrontFace::eClockwise;
+
+    description.blendAttachments = {defaultBlendAttachment};
+    description.blendConstants   = defaultBlendConstants;
+
+    description.dynamicStates = {
+            std::cbegin(viewportDynamicStates),
+            std::cend(viewportDynamicStates)};
+
+    return description;
+}
+
+auto
+set_vertex_input(
+        GraphicsPipelineDescription& description,
+        vk::PipelineVertexInputStateCreateInfo const& vertexInput) -> void
+{
+    description.vertexBindings.assign(
+            vertexInput.pVertexBindingDescriptions,
+            vertexInput.pVertexBindingDescriptions
+                    + vertexInput.vertexBindingDescriptionCount);
+
+    description.vertexAttributes.assign(
+            vertexInput.pVertexAttributeDescriptions,
+            vertexInput.pVertexAttributeDescriptions
+                    + vertexInput.vertexAttributeDescriptionCount);
+}
+
+[[nodiscard]] auto
+create_graphics_pipeline(
+        PipelineCache& pipelineCache,
+        GraphicsPipelineDescription const& description) -> vk::UniquePipeline
+{
+    // Reserved up front, the stages point into it.
+    auto specialization = std::vector<vk::SpecializationInfo>{};
+    specialization.reserve(description.stages.size());
+
+    auto shaderStages = ShaderStageInfoVec{};
+    shaderStages.reserve(description.stages.size());
+    for(auto const& stage : description.stages) {
+        auto const info =
+                shaderUtils::specialization_info(stage.specialization);
+        if(info) {
+            specialization.push_back(*info);
+        }
+
+        shaderStages.emplace_back(
+                vk::PipelineShaderStageCreateFlags{},
+                stage.stage,
+                stage.module,
+                stage.entryPoint.c_str(),
+                info ? &specialization.back() : nullptr);
+    }
+
+    auto const vertexInput = VertexInputState(
+            {},
+            static_cast<uint32_t>(description.vertexBindings.size()),
+            description.vertexBindings.data(),
+            static_cast<uint32_t>(description.vertexAttributes.size()),
+            description.vertexAttributes.data());
+
+    auto const inputAssembly =
+            InputAssemblyState({}, description.topology, vkFalse);
+
+    auto const width    = static_cast<int>(description.extent.width);
+    auto const height   = static_cast<int>(description.extent.height);
+    auto const viewport = create_viewport(width, height);
+    auto const scissor  = create_scissor(width, height);
+
+    // Viewport and scissor counts still have to be given when both are
+    // dynamic, their values are ignored.
+    auto const viewportState =
+            has_dynamic_viewport(description)
+                    ? ViewportState({}, 1, nullptr, 1, nullptr)
+                    : create_viewport_state(viewport, scissor);
+
+    auto const rasterisationState = RasterizationState{
+            {},
+            vkFalse,
+            vkFalse,
+            description.polygonMode,
+            description.cullMode,
+            description.frontFace,
+            vkFalse,
+            0.0f,
+            0.0f,
+            0.0f,
+            1.0f};
+
+    auto constexpr multisampleState  = MultisampleState{};
+    auto constexpr depthStencilState = DepthStencilState{};
+
+    auto const colourBlendState = ColourBlendState(
+            {},
+            vkFalse,
+            {},
+            static_cast<uint32_t>(description.blendAttachments.size()),
+            description.blendAttachments.data(),
+            description.blendConstants);
+
+    auto const dynamicState = DynamicState(
+            {},
+            static_cast<uint32_t>(description.dynamicStates.size()),
+            description.dynamicStates.data());
+
+    return pipelineCache.create_graphics_pipeline(
+            vk::GraphicsPipelineCreateInfo(
+                    {},
+                    static_cast<uint32_t>(shaderStages.size()),
+                    shaderStages.data(),
+                    &vertexInput,
+                    &inputAssembly,
+                    nullptr,
+                    &viewportState,
+                    &rasterisationState,
+                    &multisampleState,
+                    &depthStencilState,
+                    &colourBlendState,
+                    description.dynamicStates.empty() ? nullptr : &dynamicState,
+                    description.layout,
+                    description.renderPass,
+                    description.subpass,
+                    nullptr,
+                    -1));
+}
+
+}    // namespace vulkanUtils
@@ -0,0 +1,89 @@
+#include "pipelineLayoutCache.hpp"
+#include "hashUtility.hpp"
+
+namespace vulkanUtils {
+
+[[nodiscard]] auto
+operator==(PipelineLayoutKey const& lhs, PipelineLayoutKey const& rhs)
+        -> bool
+{
+    return lhs.setLayouts == rhs.setLayouts
+           && lhs.pushConstants == rhs.pushConstants;
+}
+
+[[nodiscard]] auto
+PipelineLayoutKeyHash::operator()(PipelineLayoutKey const& key) const noexcept
+        -> size_t
+{
+    auto hash = key.setLayouts.size();
+    for(auto const& setLayout : key.setLayouts) {
+        hash = hash_values(hash, static_cast<VkDescriptorSetLayout>(setLayout));
+    }
+
+    for(auto const& range : key.pushConstants) {
+        hash = hash_values(
+                hash,
+                static_cast<VkShaderStageFlags>(range.stageFlags),
+                range.offset,
+                range.size);
+    }
+
+    return hash;
+}
+
+PipelineLayoutCache::PipelineLayoutCache(
+        vk::Device const& logicalDevice,
+        DescriptorLayoutCache& descriptorLayouts) :
+            m_descriptorLayouts{descriptorLayouts},
+            m_boundDevice{logicalDevice}
+{}
+
+[[nodiscard]] auto
+PipelineLayoutCache::boundDevice() const noexcept -> vk::Device const&
+{
+    return m_boundDevice.get();
+}
+
+[[nodiscard]] auto
+PipelineLayoutCache::size() const -> size_t
+{
+    auto const lock = std::lock_guard{m_mutex};
+    return m_layouts.size();
+}
+
+[[nodiscard]] auto
+PipelineLayoutCache::get(
+        shaderUtils::PipelineLayoutDescription const& description)
+        -> vk::PipelineLayout
+{
+    auto key = PipelineLayoutKey{{}, description.pushConstants};
+    key.setLayouts.reserve(description.sets.size());
+
+    // Sets no shader uses still need a layout to keep the numbering, the
+    // empty one is shared like any other.
+    for(auto const& bindings : description.sets) {
+        key.setLayouts.push_back(m_descriptorLayouts.get().get(bindings));
+    }
+
+    auto const lock = std::lock_guard{m_mutex};
+
+    auto const cached = m_layouts.find(key);
+    if(cached != std::end(m_layouts)) {
+        return *cached->second;
+    }
+
+    auto layout = m_boundDevice.get().createPipelineLayoutUnique(
+            vk::PipelineLayoutCreateInfo(
+                    {},
+                    static_cast<uint32_t>(key.setLayouts.size()),
+                    key.setLayouts.data(),
+                    static_cast<uint32_t>(key.pushConstants.size()),
+                    key.pushConstants.data()));
+
+    auto const handle = *layout;
+    m_layouts.emplace(std::move(key), std::move(layout));
+
+    return handle;
+}
+
+}    // namespace vulkanUtils
@@ -0,0 +1,302 @@
+#include "pipelineRegistry.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace vulkanUtils {
+
+auto
+operator<<(std::ostream& stream, PipelineRegistryStats const& stats)
+        -> std::ostream&
+{
+    return stream << "Pipeline registry: " << stats.compiles
+                  << " pipelines compiled for " << stats.lookups
+                  << " lookups\n";
+}
+
+PendingPipeline::PendingPipeline(
+        std::shared_future<vk::Pipeline> compiled,
+        vk::Pipeline const fallback) :
+            m_compiled{std::move(compiled)},
+            m_fallback{fallback}
+{}
+
+[[nodiscard]] auto
+PendingPipeline::ready() const -> bool
+{
+    return m_compiled.valid()
+           && m_compiled.wait_for(std::chrono::seconds{0})
+                      == std::future_status::ready;
+}
+
+[[nodiscard]] auto
+PendingPipeline::current() const -> vk::Pipeline
+{
+    return ready() && !error() ? m_compiled.get() : m_fallback;
+}
+
+[[nodiscard]] auto
+PendingPipeline::error() const -> std::exception_ptr
+{
+    if(!ready()) {
+        return nullptr;
+    }
+
+    try {
+        static_cast<void>(m_compiled.get());
+    }
+    catch(...) {
+        return std::current_exception();
+    }
+
+    return nullptr;
+}
+
+PipelineRegistry::PipelineRegistry(
+        PipelineCache& pipelineCache,
+        uint32_t const compileThreads) :
+            m_stats{},
+            m_stopping{false},
+            m_pipelineCache{pipelineCache}
+{
+    m_threads.reserve(compileThreads);
+
+    // A thread that fails to start must not leave the started ones joinable.
+    try {
+        for(auto i = 0u; i < compileThreads; ++i) {
+            m_threads.emplace_back([this] { work(); });
+        }
+    }
+    catch(...) {
+        stop();
+        throw;
+    }
+}
+
+PipelineRegistry::~PipelineRegistry()
+{
+    stop();
+}
+
+auto
+PipelineRegistry::stop() -> void
+{
+    {
+        auto const lock = std::lock_guard{m_mutex};
+        m_stopping      = true;
+    }
+
+    m_jobReady.notify_all();
+
+    for(auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+[[nodiscard]] auto
+PipelineRegistry::compileThreads() const noexcept -> uint32_t
+{
+    return static_cast<uint32_t>(m_threads.size());
+}
+
+[[nodiscard]] auto
+PipelineRegistry::size() const -> size_t
+{
+    auto const lock = std::lock_guard{m_mutex};
+    return m_pipelines.size();
+}
+
+[[nodiscard]] auto
+PipelineRegistry::stats() const -> PipelineRegistryStats
+{
+    auto const lock = std::lock_guard{m_mutex};
+    return m_stats;
+}
+
+// The entry is added before compiling starts, so a second request for the
+// same description waits on the first compile instead of starting its own.
+[[nodiscard]] auto
+PipelineRegistry::request(GraphicsPipelineDescription const& description)
+        -> std::shared_future<vk::Pipeline>
+{
+    auto lock = std::unique_lock{m_mutex};
+    ++m_stats.lookups;
+
+    auto const cached = m_pipelines.find(description);
+    if(cached != std::end(m_pipelines)) {
+        return cached->second.compiled;
+    }
+
+    auto job      = CompileJob{description, {}};
+    auto compiled = job.promise.get_future().share();
+    m_pipelines.emplace(description, Entry{compiled, {}});
+
+    if(m_threads.empty()) {
+        compile(job, lock);
+        return compiled;
+    }
+
+    m_queue.push_back(std::move(job));
+    lock.unlock();
+    m_jobReady.notify_one();
+
+    return compiled;
+}
+
+[[nodiscard]] auto
+PipelineRegistry::get(GraphicsPipelineDescription const& description)
+        -> vk::Pipeline
+{
+    return request(description).get();
+}
+
+[[nodiscard]] auto
+PipelineRegistry::release_render_pass(vk::RenderPass const renderPass)
+        -> std::vector<vk::UniquePipeline>
+{
+    return release([renderPass](GraphicsPipelineDescription const& described) {
+        return described.renderPass == renderPass;
+    });
+}
+
+[[nodiscard]] auto
+PipelineRegistry::release_shader_module(vk::ShaderModule const module)
+        -> std::vector<vk::UniquePipeline>
+{
+    return release([module](GraphicsPipelineDescription const& described) {
+        return std::any_of(
+                std::cbegin(described.stages),
+                std::cend(described.stages),
+                [module](ShaderStageDescription const& stage) {
+                    return stage.module == module;
+                });
+    });
+}
+
+auto
+PipelineRegistry::wait_idle() -> void
+{
+    auto lock = std::unique_lock{m_mutex};
+
+    auto const everything = [](GraphicsPipelineDescription const&) {
+        return true;
+    };
+
+    drop_queued(everything);
+    m_compileDone.wait(lock, [this] { return m_compiling.empty(); });
+}
+
+auto
+PipelineRegistry::work() -> void
+{
+    while(true) {
+        auto lock = std::unique_lock{m_mutex};
+        m_jobReady.wait(lock, [this] {
+            return m_stopping || !m_queue.empty();
+        });
+
+        if(m_stopping) {
+            return;
+        }
+
+        auto job = std::move(m_queue.front());
+        m_queue.pop_front();
+
+        compile(job, lock);
+    }
+}
+
+// Entered and left with the lock held, but compiles without it so workers
+// run in parallel. The description is marked as compiling meanwhile, which
+// keeps the job's entry from being released. Errors are handed to whoever
+// waits on the pipeline and the entry is dropped.
+auto
+PipelineRegistry::compile(
+        CompileJob& job,
+        std::unique_lock<std::mutex>& lock) -> void
+{
+    m_compiling.push_back(&job.description);
+    lock.unlock();
+
+    auto pipeline = vk::UniquePipeline{};
+    auto error    = std::exception_ptr{};
+    try {
+        pipeline = create_graphics_pipeline(
+                m_pipelineCache.get(),
+                job.description);
+    }
+    catch(...) {
+        error = std::current_exception();
+    }
+
+    lock.lock();
+
+    auto const handle = *pipeline;
+    if(error) {
+        m_pipelines.erase(job.description);
+    }
+    else {
+        ++m_stats.compiles;
+        m_pipelines.at(job.description).pipeline = std::move(pipeline);
+    }
+
+    m_compiling.erase(std::find(
+            std::cbegin(m_compiling),
+            std::cend(m_compiling),
+            &job.description));
+    m_compileDone.notify_all();
+
+    if(error) {
+        job.promise.set_exception(error);
+    }
+    else {
+        job.promise.set_value(handle);
+    }
+}
+
+[[nodiscard]] auto
+PipelineRegistry::release(DescriptionFilter const& filter)
+        -> std::vector<vk::UniquePipeline>
+{
+    auto lock = std::unique_lock{m_mutex};
+
+    drop_queued(filter);
+    m_compileDone.wait(lock, [&] {
+        return std::none_of(
+                std::cbegin(m_compiling),
+                std::cend(m_compiling),
+                [&](GraphicsPipelineDescription const* compiling) {
+                    return filter(*compiling);
+                });
+    });
+
+    auto released = std::vector<vk::UniquePipeline>{};
+    for(auto entry = std::begin(m_pipelines); entry != std::end(m_pipelines);) {
+        if(filter(entry->first)) {
+            released.push_back(std::move(entry->second.pipeline));
+            entry = m_pipelines.erase(entry);
+        }
+        else {
+            ++entry;
+        }
+    }
+
+    return released;
+}
+
+auto
+PipelineRegistry::drop_queued(DescriptionFilter const& filter) -> void
+{
+    for(auto job = std::begin(m_queue); job != std::end(m_queue);) {
+        if(!filter(job->description)) {
+            ++job;
+            continue;
+        }
+
+        m_pipelines.erase(job->description);
+        job->promise.set_value(vk::Pipeline{});
+        job = m_queue.erase(job);
+    }
+}
+
+}    // namespace vulkanUtils
@@ -0,0 +1,98 @@
+#include "presentPolicy.hpp"
+#include "surface.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace vulkanUtils {
+
+[[nodiscard]] auto
+present_policy(PresentProfile const profile) -> PresentPolicy
+{
+    switch(profile) {
+    case PresentProfile::Latency:
+        return {{vk::PresentModeKHR::eMailbox,
+                 vk::PresentModeKHR::eImmediate,
+                 vk::PresentModeKHR::eFifoRelaxed},
+                0};
+    case PresentProfile::Throughput:
+        return {{vk::PresentModeKHR::eImmediate,
+                 vk::PresentModeKHR::eMailbox,
+                 vk::PresentModeKHR::eFifoRelaxed},
+                1};
+    case PresentProfile::Vsync:
+    default:
+        return {{vk::PresentModeKHR::eFifoRelaxed, vk::PresentModeKHR::eFifo},
+                0};
+    }
+}
+
+[[nodiscard]] auto
+parse_present_profile(std::string_view const name) -> PresentProfile
+{
+    using namespace std::literals;
+
+    if(name == "vsync"sv) {
+        return PresentProfile::Vsync;
+    }
+    if(name == "latency"sv) {
+        return PresentProfile::Latency;
+    }
+    if(name == "throughput"sv) {
+        return PresentProfile::Throughput;
+    }
+
+    throw std::invalid_argument(
+            "Unknown present profile " + std::string{name});
+}
+
+[[nodiscard]] auto
+to_string(PresentProfile const profile) noexcept -> char const*
+{
+    switch(profile) {
+    case PresentProfile::Latency:
+        return "latency";
+    case PresentProfile::Throughput:
+        return "throughput";
+    case PresentProfile::Vsync:
+    default:
+        return "vsync";
+    }
+}
+
+[[nodiscard]] auto
+choose_present_config(
+        PresentPolicy const& policy,
+        std::vector<vk::PresentModeKHR> const& supportedPresentationModes,
+        vk::SurfaceCapabilitiesKHR const& surfaceCaps) noexcept
+        -> PresentConfig
+{
+    auto const presentationMode = firstSupportedPresentationMode(
+            supportedPresentationModes,
+            policy.presentationModes);
+
+    auto const spareImage =
+            presentationMode == vk::PresentModeKHR::eMailbox ? 1u : 0u;
+
+    auto imageCount =
+            surfaceCaps.minImageCount + policy.extraImages + spareImage;
+
+    // A maximum of 0 means the surface has no upper limit.
+    if(surfaceCaps.maxImageCount != 0) {
+        imageCount = std::min(imageCount, surfaceCaps.maxImageCount);
+    }
+
+    return {presentationMode, imageCount};
+}
+
+auto
+operator<<(std::ostream& stream, PresentConfig const& config)
+        -> std::ostream&
+{
+    return stream << "Presenting with "
+                  << vk::to_string(config.presentationMode) << " and "
+                  << config.imageCount << " images\n";
+}
+
+}    // namespace vulkanUtils
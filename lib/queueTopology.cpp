@@ -0,0 +1,165 @@
+#include "queueTopology.hpp"
+
+#include <optional>
+
+namespace {
+
+auto constexpr graphicsPriority = 1.0f;
+auto constexpr computePriority  = 0.5f;
+auto constexpr transferPriority = 0.5f;
+
+// First family that supports every wanted flag and none of the excluded ones.
+[[nodiscard]] auto
+find_family(
+        std::vector<vk::QueueFamilyProperties> const& queueFamilies,
+        vk::QueueFlags const wanted,
+        vk::QueueFlags const excluded) noexcept -> std::optional<uint32_t>
+{
+    for(auto i = 0u; i < queueFamilies.size(); ++i) {
+        auto const flags = queueFamilies[i].queueFlags;
+        if((flags & wanted) == wanted && !(flags & excluded)
+           && queueFamilies[i].queueCount > 0) {
+            return i;
+        }
+    }
+
+    return std::nullopt;
+}
+
+// Takes the family's next unused queue, or shares its last one once every
+// queue has been handed out.
+[[nodiscard]] auto
+allocate_queue(
+        std::vector<vk::QueueFamilyProperties> const& queueFamilies,
+        std::vector<std::vector<float>>& priorities,
+        uint32_t const family,
+        float const priority) -> vulkanUtils::QueueLocation
+{
+    auto& familyPriorities = priorities.at(family);
+    if(familyPriorities.size() < queueFamilies[family].queueCount) {
+        familyPriorities.push_back(priority);
+    }
+
+    return {family, static_cast<uint32_t>(familyPriorities.size() - 1)};
+}
+
+}    // namespace
+
+namespace vulkanUtils {
+
+[[nodiscard]] auto
+create_queue_topology(
+        std::vector<vk::QueueFamilyProperties> const& queueFamilies,
+        uint32_t const graphicsFamily,
+        uint32_t const presentFamily) -> QueueTopology
+{
+    using Flag = vk::QueueFlagBits;
+
+    auto topology = QueueTopology{};
+    topology.priorities.resize(queueFamilies.size());
+
+    topology.graphics = allocate_queue(
+            queueFamilies,
+            topology.priorities,
+            graphicsFamily,
+            graphicsPriority);
+
+    topology.present = presentFamily == graphicsFamily
+                               ? topology.graphics
+                               : allocate_queue(
+                                       queueFamilies,
+                                       topology.priorities,
+                                       presentFamily,
+                                       graphicsPriority);
+
+    auto const computeFamily =
+            find_family(queueFamilies, Flag::eCompute, Flag::eGraphics)
+                    .value_or(graphicsFamily);
+
+    topology.compute = allocate_queue(
+            queueFamilies,
+            topology.priorities,
+            computeFamily,
+            computePriority);
+
+    auto const transferFamily =
+            find_family(
+                    queueFamilies,
+                    Flag::eTransfer,
+                    Flag::eGraphics | Flag::eCompute)
+                    .value_or(computeFamily);
+
+    topology.transfer = allocate_queue(
+            queueFamilies,
+            topology.priorities,
+            transferFamily,
+            transferPriority);
+
+    return topology;
+}
+
+[[nodiscard]] auto
+has_dedicated_transfer(QueueTopology const& topology) noexcept -> bool
+{
+    return topology.transfer.family != topology.graphics.family
+           && topology.transfer.family != topology.compute.family;
+}
+
+[[nodiscard]] auto
+has_async_compute(QueueTopology const& topology) noexcept -> bool
+{
+    return topology.compute.family != topology.graphics.family
+           || topology.compute.index != topology.graphics.index;
+}
+
+[[nodiscard]] auto
+queue_create_infos(QueueTopology const& topology)
+        -> std::vector<vk::DeviceQueueCreateInfo>
+{
+    auto createInfos = std::vector<vk::DeviceQueueCreateInfo>{};
+
+    for(auto family = 0u; family < topology.priorities.size(); ++family) {
+        auto const& familyPriorities = topology.priorities[family];
+        if(familyPriorities.empty()) {
+            continue;
+        }
+
+        createInfos.emplace_back(
+                vk::DeviceQueueCreateFlags{},
+                family,
+                static_cast<uint32_t>(familyPriorities.size()),
+                familyPriorities.data());
+    }
+
+    return createInfos;
+}
+
+[[nodiscard]] auto
+get_queue(vk::Device const& logicalDevice, QueueLocation const location)
+        -> vk::Queue
+{
+    return logicalDevice.getQueue(location.family, location.index);
+}
+
+auto
+operator<<(std::ostream& stream, QueueTopology const& topology)
+        -> std::ostream&
+{
+    auto const print = [&stream](char const* role, QueueLocation location) {
+        stream << "  " << role << ": family " << location.family << ", queue "
+               << location.index << '\n';
+    };
+
+    stream << "Queues:\n";
+    print("graphics", topology.graphics);
+    print("present ", topology.present);
+    print("compute ", topology.compute);
+    print("transfer", topology.transfer);
+
+    return stream << "  async compute: "
+                  << (has_async_compute(topology) ? "yes" : "no")
+                  << ", dedicated transfer: "
+                  << (has_dedicated_transfer(topology) ? "yes" : "no") << '\n';
+}
+
+}    // namespace vulkanUtils
@@ -0,0 +1,211 @@
+#include "rangeAllocator.hpp"
+
+#include <iterator>
+
+namespace vulkanUtils {
+
+RangeAllocator::RangeAllocator(
+        vk::DeviceSize const size,
+        AllocationStrategy const strategy,
+        vk::DeviceSize const granularity) :
+            m_size{size},
+            m_strategy{strategy},
+            m_granularity{granularity},
+            m_free{{0, size}},
+            m_allocated{},
+            m_used{0},
+            m_head{0},
+            m_generation{0}
+{}
+
+[[nodiscard]] auto
+RangeAllocator::size() const noexcept -> vk::DeviceSize
+{
+    return m_size;
+}
+
+[[nodiscard]] auto
+RangeAllocator::used() const noexcept -> vk::DeviceSize
+{
+    return m_used;
+}
+
+[[nodiscard]] auto
+RangeAllocator::allocationCount() const noexcept -> uint32_t
+{
+    return static_cast<uint32_t>(m_allocated.size());
+}
+
+[[nodiscard]] auto
+RangeAllocator::strategy() const noexcept -> AllocationStrategy
+{
+    return m_strategy;
+}
+
+[[nodiscard]] auto
+RangeAllocator::generation() const noexcept -> uint64_t
+{
+    return m_generation;
+}
+
+[[nodiscard]] auto
+RangeAllocator::try_allocate(
+        vk::DeviceSize const size,
+        vk::DeviceSize const alignment,
+        ResourceKind const kind) -> std::optional<vk::DeviceSize>
+{
+    auto const offset = m_strategy == AllocationStrategy::Linear
+                                ? find_linear(size, alignment, kind)
+                                : find_free(size, alignment, kind);
+
+    if(offset) {
+        m_allocated.emplace(*offset, Range{size, kind});
+        m_used += size;
+    }
+
+    return offset;
+}
+
+auto
+RangeAllocator::free(
+        vk::DeviceSize const offset,
+        uint64_t const generation) noexcept -> void
+{
+    auto const allocation = m_allocated.find(offset);
+    if(generation != m_generation || allocation == std::end(m_allocated)) {
+        return;
+    }
+
+    auto const size = allocation->second.size;
+    m_used -= size;
+    m_allocated.erase(allocation);
+
+    if(m_strategy == AllocationStrategy::FreeList) {
+        insert_free(offset, size);
+    }
+}
+
+auto
+RangeAllocator::reset() noexcept -> void
+{
+    m_allocated.clear();
+    m_free.clear();
+    m_free.emplace(0, m_size);
+    m_used = 0;
+    m_head = 0;
+    ++m_generation;
+}
+
+// Moves the offset onto the next page if the allocation ending just before
+// it is of the other kind and shares its page.
+[[nodiscard]] auto
+RangeAllocator::after_neighbour(
+        vk::DeviceSize offset,
+        ResourceKind const kind) const -> vk::DeviceSize
+{
+    auto const next = m_allocated.lower_bound(offset);
+    if(next == std::begin(m_allocated)) {
+        return offset;
+    }
+
+    auto const& [previousOffset, previous] = *std::prev(next);
+    auto const previousEnd = previousOffset + previous.size;
+
+    if(previous.kind != kind
+       && same_page(previousEnd - 1, offset, m_granularity)) {
+        offset = align_up(offset, m_granularity);
+    }
+
+    return offset;
+}
+
+[[nodiscard]] auto
+RangeAllocator::find_linear(
+        vk::DeviceSize const size,
+        vk::DeviceSize const alignment,
+        ResourceKind const kind) -> std::optional<vk::DeviceSize>
+{
+    auto const offset = after_neighbour(align_up(m_head, alignment), kind);
+    if(offset + size > m_size) {
+        return std::nullopt;
+    }
+
+    m_head = offset + size;
+
+    return offset;
+}
+
+// Best fit over the free ranges.
+[[nodiscard]] auto
+RangeAllocator::find_free(
+        vk::DeviceSize const size,
+        vk::DeviceSize const alignment,
+        ResourceKind const kind) -> std::optional<vk::DeviceSize>
+{
+    auto best       = std::end(m_free);
+    auto bestOffset = vk::DeviceSize{};
+
+    for(auto range = std::begin(m_free); range != std::end(m_free); ++range) {
+        auto const [start, rangeSize] = *range;
+        auto const rangeEnd           = start + rangeSize;
+
+        auto const offset = after_neighbour(align_up(start, alignment), kind);
+        if(offset + size > rangeEnd) {
+            continue;
+        }
+
+        auto const next = m_allocated.find(rangeEnd);
+        if(next != std::end(m_allocated) && next->second.kind != kind
+           && same_page(offset + size - 1, next->first, m_granularity)) {
+            continue;
+        }
+
+        if(best == std::end(m_free) || rangeSize < best->second) {
+            best       = range;
+            bestOffset = offset;
+        }
+    }
+
+    if(best == std::end(m_free)) {
+        return std::nullopt;
+    }
+
+    auto const [start, rangeSize] = *best;
+    m_free.erase(best);
+
+    if(bestOffset > start) {
+        m_free.emplace(start, bestOffset - start);
+    }
+
+    auto const end = bestOffset + size;
+    if(start + rangeSize > end) {
+        m_free.emplace(end, start + rangeSize - end);
+    }
+
+    return bestOffset;
+}
+
+auto
+RangeAllocator::insert_free(vk::DeviceSize offset, vk::DeviceSize size)
+        -> void
+{
+    auto const next = m_free.find(offset + size);
+    if(next != std::end(m_free)) {
+        size += next->second;
+        m_free.erase(next);
+    }
+
+    auto const following = m_free.lower_bound(offset);
+    if(following != std::begin(m_free)) {
+        auto const previous = std::prev(following);
+        if(previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            m_free.erase(previous);
+        }
+    }
+
+    m_free.emplace(offset, size);
+}
+
+}    // namespace vulkanUtils
@@ -0,0 +1,76 @@
+#include "renderSettings.hpp"
+
+#include <string>
+
+[[nodiscard]] auto
+flag_value(std::string_view const argument, std::string_view const flag)
+        -> uint32_t
+{
+    return static_cast<uint32_t>(
+            std::stoul(std::string{argument.substr(flag.size())}));
+}
+
+[[nodiscard]] auto
+has_flag(std::string_view const argument, std::string_view const flag) noexcept
+        -> bool
+{
+    return argument.substr(0, flag.size()) == flag;
+}
+
+[[nodiscard]] auto
+parse_render_setting(std::string_view const argument, RenderSettings& settings)
+        -> bool
+{
+    using namespace std::literals;
+
+    if(argument == "--headless"sv) {
+        settings.headless = true;
+    }
+    else if(argument == "--batch-draws"sv) {
+        settings.batchDraws = true;
+    }
+    else if(argument == "--rewrite-descriptors"sv) {
+        settings.rewriteDescriptors = true;
+    }
+    else if(argument == "--watch-shaders"sv) {
+        settings.watchShaders = true;
+    }
+    else if(argument == "--no-tint"sv) {
+        settings.tint = false;
+    }
+    else if(argument == "--compute"sv) {
+        settings.computeInstances = true;
+    }
+    else if(has_flag(argument, "--width="sv)) {
+        settings.extent.width = flag_value(argument, "--width="sv);
+    }
+    else if(has_flag(argument, "--height="sv)) {
+        settings.extent.height = flag_value(argument, "--height="sv);
+    }
+    else if(has_flag(argument, "--frames="sv)) {
+        settings.frameCount = flag_value(argument, "--frames="sv);
+    }
+    else if(has_flag(argument, "--frames-in-flight="sv)) {
+        settings.framesInFlight =
+                flag_value(argument, "--frames-in-flight="sv);
+    }
+    else if(has_flag(argument, "--present="sv)) {
+        settings.presentProfile = vulkanUtils::parse_present_profile(
+                argument.substr("--present="sv.size()));
+    }
+    else if(has_flag(argument, "--triangles="sv)) {
+        settings.triangleCount = flag_value(argument, "--triangles="sv);
+    }
+    else if(has_flag(argument, "--record-threads="sv)) {
+        settings.recordThreads = flag_value(argument, "--record-threads="sv);
+    }
+    else if(has_flag(argument, "--compile-threads="sv)) {
+        settings.compileThreads =
+                flag_value(argument, "--compile-threads="sv);
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,266 @@
+#include "shaderCompiler.hpp"
+#include "hashUtility.hpp"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef VKTUT_SHADER_COMPILER
+#    include <glslang/Public/ResourceLimits.h>
+#    include <glslang/Public/ShaderLang.h>
+#    include <glslang/SPIRV/GlslangToSpv.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// Bumped whenever the compiler or the way it is driven changes, so binaries
+// from an older build are never picked up.
+auto constexpr shaderCacheVersion = uint32_t{2};
+
+[[nodiscard]] auto
+read_source(std::string const& filePath) -> std::string
+{
+    auto file = std::ifstream(filePath, std::ios::binary);
+    if(!file.is_open()) {
+        throw std::runtime_error("No source of shader " + filePath);
+    }
+
+    auto source = std::ostringstream{};
+    source << file.rdbuf();
+
+    return source.str();
+}
+
+[[nodiscard]] auto
+source_hash(
+        std::string const& source,
+        shaderUtils::ShaderType const type,
+        shaderUtils::ShaderCompileOptions const& options) noexcept -> uint64_t
+{
+    auto const flags = std::array{
+            shaderCacheVersion,
+            static_cast<uint32_t>(type),
+            static_cast<uint32_t>(options.debugInfo)};
+
+    auto hash = vulkanUtils::fnv1a(source.data(), source.size());
+    hash      = vulkanUtils::fnv1a(flags.data(), sizeof(flags), hash);
+
+    // The terminators keep {"AB"} and {"A", "B"} apart.
+    for(auto const& define : options.defines) {
+        hash = vulkanUtils::fnv1a(define.c_str(), define.size() + 1, hash);
+    }
+
+    return hash;
+}
+
+[[nodiscard]] auto
+cached_binary_path(
+        std::string const& cachePath,
+        std::string const& sourcePath,
+        uint64_t const hash) -> std::string
+{
+    auto name = std::ostringstream{};
+    name << cachePath << std::filesystem::path{sourcePath}.filename().string()
+         << '.' << std::hex << std::setw(16) << std::setfill('0') << hash
+         << ".spv";
+
+    return name.str();
+}
+
+auto
+write_binary(std::string const& filePath, std::vector<uint32_t> const& words)
+        -> void
+{
+    auto const path = std::filesystem::path{filePath};
+    std::filesystem::create_directories(path.parent_path());
+
+    auto tempPath = path;
+    tempPath += ".tmp";
+
+    {
+        auto file = std::ofstream(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(
+                reinterpret_cast<char const*>(words.data()),
+                words.size() * sizeof(uint32_t));
+        file.flush();
+
+        if(!file) {
+            throw std::runtime_error("Could not write " + tempPath.string());
+        }
+    }
+
+    std::filesystem::rename(tempPath, path);
+}
+
+#ifdef VKTUT_SHADER_COMPILER
+[[nodiscard]] auto
+defines_preamble(std::vector<std::string> const& defines) -> std::string
+{
+    auto preamble = std::string{};
+    for(auto define : defines) {
+        auto const equals = define.find('=');
+        if(equals != std::string::npos) {
+            define[equals] = ' ';
+        }
+
+        preamble += "#define " + define + '\n';
+    }
+
+    return preamble;
+}
+
+[[nodiscard]] auto
+compile_glsl(
+        shaderUtils::ShaderType const type,
+        std::string const& source,
+        std::string const& sourcePath,
+        shaderUtils::ShaderCompileOptions const& options)
+        -> std::vector<uint32_t>
+{
+    auto const stage = [type]() {
+        switch(type) {
+        case shaderUtils::ShaderType::Vertex: return EShLangVertex;
+        case shaderUtils::ShaderType::Fragment: return EShLangFragment;
+        case shaderUtils::ShaderType::Compute: return EShLangCompute;
+        }
+
+        throw std::runtime_error("Unknown shader stage");
+    }();
+    auto constexpr messages =
+            static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
+
+    auto const* const text = source.c_str();
+    auto const* const name = sourcePath.c_str();
+    auto const preamble    = defines_preamble(options.defines);
+
+    auto shader = glslang::TShader(stage);
+    shader.setStringsWithLengthsAndNames(&text, nullptr, &name, 1);
+    shader.setPreamble(preamble.c_str());
+    shader.setEnvInput(
+            glslang::EShSourceGlsl,
+            stage,
+            glslang::EShClientVulkan,
+            100);
+    shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_0);
+    shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_0);
+
+    if(!shader.parse(GetDefaultResources(), 450, false, messages)) {
+        throw std::runtime_error(sourcePath + ":\n" + shader.getInfoLog());
+    }
+
+    auto program = glslang::TProgram{};
+    program.addShader(&shader);
+
+    if(!program.link(messages)) {
+        throw std::runtime_error(sourcePath + ":\n" + program.getInfoLog());
+    }
+
+    auto spirvOptions              = glslang::SpvOptions{};
+    spirvOptions.generateDebugInfo = options.debugInfo;
+
+    auto words = std::vector<uint32_t>{};
+    glslang::GlslangToSpv(
+            *program.getIntermediate(stage),
+            words,
+            &spirvOptions);
+
+    return words;
+}
+#endif
+
+namespace shaderUtils {
+
+auto
+operator<<(std::ostream& stream, ShaderCompileStats const& stats)
+        -> std::ostream&
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    return stream << "Shaders: " << stats.compiles << " compiled in "
+                  << Milliseconds(stats.compileTime).count() << "ms, "
+                  << stats.cacheHits << " from cache\n";
+}
+
+ShaderCompiler::ShaderCompiler(
+        std::string cachePath,
+        ShaderCompileOptions options) :
+            m_cachePath{std::move(cachePath)},
+            m_options{std::move(options)},
+            m_stats{}
+{
+#ifdef VKTUT_SHADER_COMPILER
+    glslang::InitializeProcess();
+#endif
+}
+
+ShaderCompiler::~ShaderCompiler()
+{
+#ifdef VKTUT_SHADER_COMPILER
+    glslang::FinalizeProcess();
+#endif
+}
+
+[[nodiscard]] auto
+ShaderCompiler::available() noexcept -> bool
+{
+#ifdef VKTUT_SHADER_COMPILER
+    return true;
+#else
+    return false;
+#endif
+}
+
+[[nodiscard]] auto
+ShaderCompiler::cachePath() const noexcept -> std::string const&
+{
+    return m_cachePath;
+}
+
+[[nodiscard]] auto
+ShaderCompiler::options() const noexcept -> ShaderCompileOptions const&
+{
+    return m_options;
+}
+
+[[nodiscard]] auto
+ShaderCompiler::stats() const noexcept -> ShaderCompileStats const&
+{
+    return m_stats;
+}
+
+[[nodiscard]] auto
+ShaderCompiler::binary_path(ShaderType const type, std::string const& name)
+        -> std::string
+{
+    auto const sourcePath = shader_source_path(type, name);
+    auto const source     = read_source(sourcePath);
+
+    auto const binaryPath = cached_binary_path(
+            m_cachePath,
+            sourcePath,
+            source_hash(source, type, m_options));
+
+    if(std::filesystem::exists(binaryPath)) {
+        ++m_stats.cacheHits;
+        return binaryPath;
+    }
+
+#ifdef VKTUT_SHADER_COMPILER
+    auto const start = Clock::now();
+    write_binary(binaryPath, compile_glsl(type, source, sourcePath, m_options));
+
+    ++m_stats.compiles;
+    m_stats.compileTime += Clock::now() - start;
+
+    return binaryPath;
+#else
+    throw std::runtime_error(
+            sourcePath + " has changed, but shaders can only be compiled "
+                         "when built with SHADER_COMPILER");
+#endif
+}
+
+}    // namespace shaderUtils
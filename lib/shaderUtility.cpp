@@ -1,4 +1,5 @@
 #include "shaderUtility.hpp"
+#include "shaderCompiler.hpp"
 
 #include <gsl/gsl>
 
@@ -6,53 +7,318 @@
 #include <fstream>
 #include <string>
 
+#ifndef _WIN32
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
 namespace shaderUtils {
 using namespace std::literals;
 
 auto const shaderPath      = "shaders/"s;
 auto const shaderBuildPath = shaderPath + "build/"s;
 
+auto constexpr spirvMagicNumber = uint32_t{0x07230203};
+
 [[nodiscard]] auto
-create_shader_module(
-        vk::UniqueDevice const& logicalDevice,
-        ShaderType const type,
-        std::string const& name) -> vk::UniqueShaderModule
+shader_source_directory() -> std::string const&
 {
-    auto const typeExtention =
-            gsl::span{type == ShaderType::Vertex ? ".vert.spv" : ".frag.spv"};
+    return shaderPath;
+}
 
-    auto const filePath = shaderBuildPath + name + typeExtention.data();
+[[nodiscard]] auto
+shader_binary_directory() -> std::string const&
+{
+    return shaderBuildPath;
+}
+
+[[nodiscard]] auto
+shader_extension(ShaderType const type) noexcept -> std::string_view
+{
+    switch(type) {
+    case ShaderType::Vertex: return ".vert"sv;
+    case ShaderType::Fragment: return ".frag"sv;
+    case ShaderType::Compute: return ".comp"sv;
+    }
+
+    return ""sv;
+}
+
+[[nodiscard]] auto
+shader_binary_path(ShaderType const type, std::string const& name)
+        -> std::string
+{
+    return shaderBuildPath + name + std::string{shader_extension(type)}
+           + ".spv";
+}
+
+[[nodiscard]] auto
+shader_source_path(ShaderType const type, std::string const& name)
+        -> std::string
+{
+    return shaderPath + name + std::string{shader_extension(type)};
+}
+
+#ifdef _WIN32
+[[nodiscard]] auto
+read_words(std::string const& filePath) -> std::vector<uint32_t>
+{
     auto shaderFile = std::ifstream(filePath, std::ios::ate | std::ios::binary);
 
     if(!shaderFile.is_open()) {
         throw std::runtime_error("No binary of given shader exists");
     }
 
-    auto const fileLength = shaderFile.tellg();
+    auto const fileLength = static_cast<size_t>(shaderFile.tellg());
+    if(fileLength % sizeof(uint32_t) != 0) {
+        throw std::runtime_error(filePath + " is not a SPIR-V binary");
+    }
 
-    auto byteCode = std::vector<char>(fileLength);
+    auto words = std::vector<uint32_t>(fileLength / sizeof(uint32_t));
 
     shaderFile.seekg(0);
-    shaderFile.read(byteCode.data(), fileLength);
+    shaderFile.read(reinterpret_cast<char*>(words.data()), fileLength);
 
-    auto const creationInfo = vk::ShaderModuleCreateInfo(
-            {},
-            byteCode.size(),
-            reinterpret_cast<uint32_t const*>(byteCode.data()));
+    return words;
+}
+
+SpirvBinary::SpirvBinary(std::string const& filePath) :
+            m_words{read_words(filePath)}
+{
+    if(m_words.empty() || m_words.front() != spirvMagicNumber) {
+        throw std::runtime_error(filePath + " is not a SPIR-V binary");
+    }
+}
+
+SpirvBinary::~SpirvBinary() = default;
+
+[[nodiscard]] auto
+SpirvBinary::words() const noexcept -> gsl::span<uint32_t const>
+{
+    return gsl::make_span(m_words.data(), m_words.size());
+}
+#else
+SpirvBinary::SpirvBinary(std::string const& filePath) :
+            m_mapping{MAP_FAILED},
+            m_mappingSize{0}
+{
+    auto const fileDescriptor = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if(fileDescriptor < 0) {
+        throw std::runtime_error("No binary of given shader exists");
+    }
+
+    struct stat fileStats {};
+    if(fstat(fileDescriptor, &fileStats) == 0) {
+        m_mappingSize = static_cast<size_t>(fileStats.st_size);
+    }
+
+    if(m_mappingSize >= sizeof(uint32_t)) {
+        m_mapping = mmap(
+                nullptr,
+                m_mappingSize,
+                PROT_READ,
+                MAP_PRIVATE,
+                fileDescriptor,
+                0);
+    }
+
+    close(fileDescriptor);
+
+    if(m_mapping == MAP_FAILED) {
+        throw std::runtime_error("Could not map " + filePath);
+    }
+
+    if(m_mappingSize % sizeof(uint32_t) != 0
+       || words()[0] != spirvMagicNumber) {
+        munmap(m_mapping, m_mappingSize);
+        throw std::runtime_error(filePath + " is not a SPIR-V binary");
+    }
+}
+
+SpirvBinary::~SpirvBinary()
+{
+    munmap(m_mapping, m_mappingSize);
+}
+
+[[nodiscard]] auto
+SpirvBinary::words() const noexcept -> gsl::span<uint32_t const>
+{
+    return gsl::make_span(
+            static_cast<uint32_t const*>(m_mapping),
+            m_mappingSize / sizeof(uint32_t));
+}
+#endif
+
+[[nodiscard]] auto
+create_shader_module(
+        vk::Device const& logicalDevice,
+        gsl::span<uint32_t const> const words) -> vk::UniqueShaderModule
+{
+    auto const creationInfo =
+            vk::ShaderModuleCreateInfo({}, words.size_bytes(), words.data());
+
+    return logicalDevice.createShaderModuleUnique(creationInfo);
+}
+
+[[nodiscard]] auto
+create_shader_module(
+        vk::Device const& logicalDevice,
+        std::string const& binaryPath) -> vk::UniqueShaderModule
+{
+    auto const binary = SpirvBinary(binaryPath);
+    return create_shader_module(logicalDevice, binary.words());
+}
+
+[[nodiscard]] auto
+create_shader_module(
+        vk::Device const& logicalDevice,
+        ShaderType const type,
+        std::string const& name) -> vk::UniqueShaderModule
+{
+    return create_shader_module(logicalDevice, shader_binary_path(type, name));
+}
+
+ShaderModuleCache::ShaderModuleCache(
+        vk::Device const& logicalDevice,
+        ShaderCompiler* const compiler) :
+            m_modules{},
+            m_reflections{},
+            m_compiler{compiler},
+            m_boundDevice{logicalDevice}
+{}
+
+[[nodiscard]] auto
+ShaderModuleCache::boundDevice() const noexcept -> vk::Device const&
+{
+    return m_boundDevice.get();
+}
+
+[[nodiscard]] auto
+ShaderModuleCache::compiler() const noexcept -> ShaderCompiler*
+{
+    return m_compiler;
+}
+
+[[nodiscard]] auto
+ShaderModuleCache::get(ShaderType const type, std::string const& name)
+        -> SharedShaderModule
+{
+    auto key = std::pair{name, type};
+
+    auto const cached = m_modules.find(key);
+    if(cached != std::cend(m_modules)) {
+        return cached->second;
+    }
+
+    auto const loaded = load(type, name);
+    commit(type, name, loaded);
+
+    return loaded.module;
+}
+
+[[nodiscard]] auto
+ShaderModuleCache::reload(ShaderType const type, std::string const& name)
+        -> LoadedShader
+{
+    return load(type, name);
+}
+
+auto
+ShaderModuleCache::commit(
+        ShaderType const type,
+        std::string const& name,
+        LoadedShader const& loaded) -> void
+{
+    m_modules.insert_or_assign(std::pair{name, type}, loaded.module);
+    m_reflections.insert_or_assign(std::pair{name, type}, loaded.reflection);
+}
+
+[[nodiscard]] auto
+ShaderModuleCache::reflection(ShaderType const type, std::string const& name)
+        const -> SharedReflection
+{
+    auto const cached = m_reflections.find(std::pair{name, type});
+    if(cached == std::cend(m_reflections)) {
+        throw std::runtime_error("Shader " + name + " has not been loaded");
+    }
+
+    return cached->second;
+}
+
+[[nodiscard]] auto
+ShaderModuleCache::load(ShaderType const type, std::string const& name)
+        -> LoadedShader
+{
+    auto const binaryPath = m_compiler != nullptr
+                                    ? m_compiler->binary_path(type, name)
+                                    : shader_binary_path(type, name);
+
+    auto const binary = SpirvBinary(binaryPath);
+    auto const words  = binary.words();
+
+    auto module = std::make_shared<vk::UniqueShaderModule const>(
+            create_shader_module(m_boundDevice.get(), words));
+
+    auto reflection = std::make_shared<ShaderReflection const>(reflect_spirv(
+            words,
+            static_cast<vk::ShaderStageFlagBits>(type)));
+
+    return {std::move(module), std::move(reflection)};
+}
+
+[[nodiscard]] auto
+ShaderModuleCache::size() const noexcept -> size_t
+{
+    return m_modules.size();
+}
+
+[[nodiscard]] auto
+operator==(
+        SpecializationConstants const& lhs,
+        SpecializationConstants const& rhs) -> bool
+{
+    return lhs.entries == rhs.entries && lhs.data == rhs.data;
+}
+
+[[nodiscard]] auto
+operator!=(
+        SpecializationConstants const& lhs,
+        SpecializationConstants const& rhs) -> bool
+{
+    return !(lhs == rhs);
+}
+
+[[nodiscard]] auto
+specialization_info(SpecializationConstants const& constants)
+        -> std::optional<vk::SpecializationInfo>
+{
+    if(constants.entries.empty()) {
+        return std::nullopt;
+    }
 
-    return logicalDevice->createShaderModuleUnique(creationInfo);
+    return vk::SpecializationInfo(
+            static_cast<uint32_t>(constants.entries.size()),
+            constants.entries.data(),
+            constants.data.size(),
+            constants.data.data());
 }
 
 [[nodiscard]] auto
 shader_stage_creation_info(
         vk::UniqueShaderModule const& shaderModule,
         ShaderType shaderType,
-        std::string_view stageName) -> vk::PipelineShaderStageCreateInfo
+        std::string_view stageName,
+        vk::SpecializationInfo const* const specialization)
+        -> vk::PipelineShaderStageCreateInfo
 {
     return vk::PipelineShaderStageCreateInfo(
             {},
             static_cast<vk::ShaderStageFlagBits>(shaderType),
             shaderModule.get(),
-            stageName.begin());
+            stageName.begin(),
+            specialization);
 }
 }    // namespace shaderUtils
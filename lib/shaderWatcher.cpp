@@ -0,0 +1,131 @@
+#include "shaderWatcher.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#ifdef __linux__
+#    include <sys/inotify.h>
+#    include <unistd.h>
+#endif
+
+namespace shaderUtils {
+using namespace std::literals;
+
+[[nodiscard]] auto
+operator==(ShaderChange const& lhs, ShaderChange const& rhs) -> bool
+{
+    return lhs.type == rhs.type && lhs.name == rhs.name;
+}
+
+[[nodiscard]] auto
+parse_shader_file(std::string_view fileName) -> std::optional<ShaderChange>
+{
+    auto constexpr binaryExtension = ".spv"sv;
+
+    if(fileName.size() > binaryExtension.size()
+       && fileName.substr(fileName.size() - binaryExtension.size())
+                  == binaryExtension) {
+        fileName.remove_suffix(binaryExtension.size());
+    }
+
+    auto const dot = fileName.rfind('.');
+    if(dot == std::string_view::npos || dot == 0) {
+        return std::nullopt;
+    }
+
+    auto const extension = fileName.substr(dot);
+    auto const name      = std::string{fileName.substr(0, dot)};
+
+    for(auto const type :
+        {ShaderType::Vertex, ShaderType::Fragment, ShaderType::Compute}) {
+        if(extension == shader_extension(type)) {
+            return ShaderChange{type, name};
+        }
+    }
+
+    return std::nullopt;
+}
+
+#ifdef __linux__
+ShaderWatcher::ShaderWatcher(std::string directory) :
+            m_directory{std::move(directory)},
+            m_fileDescriptor{inotify_init1(IN_NONBLOCK | IN_CLOEXEC)}
+{
+    if(m_fileDescriptor < 0) {
+        throw std::runtime_error("Could not create an inotify instance");
+    }
+
+    // Editors that save through a temporary file rename it into place.
+    auto const watch = inotify_add_watch(
+            m_fileDescriptor,
+            m_directory.c_str(),
+            IN_CLOSE_WRITE | IN_MOVED_TO);
+
+    if(watch < 0) {
+        close(m_fileDescriptor);
+        throw std::runtime_error("Could not watch " + m_directory);
+    }
+}
+
+ShaderWatcher::~ShaderWatcher()
+{
+    close(m_fileDescriptor);
+}
+
+[[nodiscard]] auto
+ShaderWatcher::poll() -> std::vector<ShaderChange>
+{
+    auto changes = std::vector<ShaderChange>{};
+
+    alignas(inotify_event) auto buffer = std::array<char, 4096>{};
+    while(true) {
+        auto const length =
+                read(m_fileDescriptor, buffer.data(), buffer.size());
+
+        if(length <= 0) {
+            return changes;
+        }
+
+        for(auto offset = ssize_t{0}; offset < length;) {
+            auto const* const event =
+                    reinterpret_cast<inotify_event const*>(&buffer[offset]);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            if(event->len == 0) {
+                continue;
+            }
+
+            auto change = parse_shader_file(event->name);
+            if(change
+               && std::find(std::cbegin(changes), std::cend(changes), *change)
+                          == std::cend(changes)) {
+                changes.push_back(std::move(*change));
+            }
+        }
+    }
+}
+#else
+ShaderWatcher::ShaderWatcher(std::string directory) :
+            m_directory{std::move(directory)},
+            m_fileDescriptor{-1}
+{
+    throw std::runtime_error("Watching shaders needs inotify");
+}
+
+ShaderWatcher::~ShaderWatcher() = default;
+
+[[nodiscard]] auto
+ShaderWatcher::poll() -> std::vector<ShaderChange>
+{
+    return {};
+}
+#endif
+
+[[nodiscard]] auto
+ShaderWatcher::directory() const noexcept -> std::string const&
+{
+    return m_directory;
+}
+
+}    // namespace shaderUtils
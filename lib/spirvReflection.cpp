@@ -0,0 +1,699 @@
+#include "spirvReflection.hpp"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace spirv {
+
+auto constexpr magicNumber = uint32_t{0x07230203};
+auto constexpr headerWords = size_t{5};
+
+enum Op : uint32_t {
+    TypeBool         = 20,
+    TypeInt          = 21,
+    TypeFloat        = 22,
+    TypeVector       = 23,
+    TypeMatrix       = 24,
+    TypeImage        = 25,
+    TypeSampler      = 26,
+    TypeSampledImage = 27,
+    TypeArray        = 28,
+    TypeRuntimeArray = 29,
+    TypeStruct       = 30,
+    TypePointer      = 32,
+    Constant         = 43,
+    SpecConstant     = 50,
+    Variable         = 59,
+    Decorate         = 71,
+    MemberDecorate   = 72
+};
+
+enum Decoration : uint32_t {
+    Block         = 2,
+    BufferBlock   = 3,
+    ArrayStride   = 6,
+    MatrixStride  = 7,
+    BuiltIn       = 11,
+    Location      = 30,
+    Binding       = 33,
+    DescriptorSet = 34,
+    Offset        = 35
+};
+
+enum StorageClass : uint32_t {
+    UniformConstant = 0,
+    Input           = 1,
+    Uniform         = 2,
+    PushConstant    = 9,
+    StorageBuffer   = 12
+};
+
+enum Dim : uint32_t { Buffer = 5, SubpassData = 6 };
+
+}    // namespace spirv
+
+struct SpirvType {
+    uint32_t opcode;
+
+    // Everything after the result id.
+    std::vector<uint32_t> operands;
+};
+
+struct SpirvDecorations {
+    std::optional<uint32_t> set;
+    std::optional<uint32_t> binding;
+    std::optional<uint32_t> location;
+    std::optional<uint32_t> arrayStride;
+    bool builtIn     = false;
+    bool bufferBlock = false;
+};
+
+struct SpirvMember {
+    uint32_t offset       = 0;
+    uint32_t matrixStride = 0;
+};
+
+struct SpirvVariable {
+    uint32_t id;
+    uint32_t pointerType;
+    uint32_t storageClass;
+};
+
+// The parts of a module reflection needs, indexed by result id.
+struct SpirvModule {
+    std::unordered_map<uint32_t, SpirvType> types;
+    std::unordered_map<uint32_t, uint32_t> constants;
+    std::unordered_map<uint32_t, SpirvDecorations> decorations;
+    std::unordered_map<uint32_t, std::vector<SpirvMember>> members;
+    std::vector<SpirvVariable> variables;
+};
+
+[[nodiscard]] auto
+member_of(SpirvModule& module, uint32_t const structType, uint32_t const member)
+        -> SpirvMember&
+{
+    auto& members = module.members[structType];
+    if(members.size() <= member) {
+        members.resize(member + 1);
+    }
+
+    return members[member];
+}
+
+auto
+parse_decoration(
+        SpirvDecorations& decorations,
+        uint32_t const decoration,
+        gsl::span<uint32_t const> const literals) -> void
+{
+    auto const literal = [&]() {
+        if(literals.empty()) {
+            throw std::runtime_error("SPIR-V decoration is missing its value");
+        }
+
+        return literals[0];
+    };
+
+    switch(decoration) {
+    case spirv::DescriptorSet: decorations.set = literal(); break;
+    case spirv::Binding: decorations.binding = literal(); break;
+    case spirv::Location: decorations.location = literal(); break;
+    case spirv::ArrayStride: decorations.arrayStride = literal(); break;
+    case spirv::BuiltIn: decorations.builtIn = true; break;
+    case spirv::BufferBlock: decorations.bufferBlock = true; break;
+    default: break;
+    }
+}
+
+// Operands the instructions read here need at least, the result id
+// included. Optional operands past these are checked where they are read.
+[[nodiscard]] auto
+minimum_operands(uint32_t const opcode) noexcept -> size_t
+{
+    switch(opcode) {
+    case spirv::TypeBool:
+    case spirv::TypeSampler:
+    case spirv::TypeStruct: return 1;
+    case spirv::TypeFloat:
+    case spirv::TypeSampledImage:
+    case spirv::TypeRuntimeArray:
+    case spirv::Constant:
+    case spirv::SpecConstant:
+    case spirv::Decorate: return 2;
+    case spirv::TypeInt:
+    case spirv::TypeVector:
+    case spirv::TypeMatrix:
+    case spirv::TypeArray:
+    case spirv::TypePointer:
+    case spirv::Variable:
+    case spirv::MemberDecorate: return 3;
+    case spirv::TypeImage: return 8;
+    default: return 0;
+    }
+}
+
+[[nodiscard]] auto
+parse_module(gsl::span<uint32_t const> const words) -> SpirvModule
+{
+    if(words.size() < spirv::headerWords || words[0] != spirv::magicNumber) {
+        throw std::runtime_error("Not a SPIR-V module");
+    }
+
+    auto module = SpirvModule{};
+
+    auto position = spirv::headerWords;
+    while(position < words.size()) {
+        auto const wordCount = words[position] >> 16u;
+        auto const opcode    = words[position] & 0xffffu;
+
+        if(wordCount == 0 || position + wordCount > words.size()) {
+            throw std::runtime_error("SPIR-V instruction runs past the end");
+        }
+
+        auto const operands = words.subspan(position + 1, wordCount - 1);
+        position += wordCount;
+
+        if(static_cast<size_t>(operands.size()) < minimum_operands(opcode)) {
+            throw std::runtime_error(
+                    "SPIR-V instruction " + std::to_string(opcode)
+                    + " is missing operands");
+        }
+
+        switch(opcode) {
+        case spirv::TypeBool:
+        case spirv::TypeInt:
+        case spirv::TypeFloat:
+        case spirv::TypeVector:
+        case spirv::TypeMatrix:
+        case spirv::TypeImage:
+        case spirv::TypeSampler:
+        case spirv::TypeSampledImage:
+        case spirv::TypeArray:
+        case spirv::TypeRuntimeArray:
+        case spirv::TypeStruct:
+        case spirv::TypePointer:
+            module.types[operands[0]] = {
+                    opcode,
+                    {std::cbegin(operands) + 1, std::cend(operands)}};
+            break;
+        case spirv::Constant:
+        case spirv::SpecConstant:
+            if(operands.size() >= 3) {
+                module.constants[operands[1]] = operands[2];
+            }
+            break;
+        case spirv::Variable:
+            module.variables.push_back({operands[1], operands[0], operands[2]});
+            break;
+        case spirv::Decorate:
+            parse_decoration(
+                    module.decorations[operands[0]],
+                    operands[1],
+                    operands.subspan(2));
+            break;
+        case spirv::MemberDecorate:
+            if((operands[2] == spirv::Offset
+                || operands[2] == spirv::MatrixStride)
+               && operands.size() < 4) {
+                throw std::runtime_error(
+                        "SPIR-V member decoration is missing its value");
+            }
+
+            if(operands[2] == spirv::Offset) {
+                member_of(module, operands[0], operands[1]).offset =
+                        operands[3];
+            }
+            else if(operands[2] == spirv::MatrixStride) {
+                member_of(module, operands[0], operands[1]).matrixStride =
+                        operands[3];
+            }
+            break;
+        default: break;
+        }
+    }
+
+    return module;
+}
+
+[[nodiscard]] auto
+type_of(SpirvModule const& module, uint32_t const id) -> SpirvType const&
+{
+    auto const type = module.types.find(id);
+    if(type == std::cend(module.types)) {
+        throw std::runtime_error(
+                "SPIR-V id " + std::to_string(id) + " is not a type");
+    }
+
+    return type->second;
+}
+
+[[nodiscard]] auto
+type_of(SpirvModule const& module, uint32_t const id, spirv::Op const opcode)
+        -> SpirvType const&
+{
+    auto const& type = type_of(module, id);
+    if(type.opcode != opcode) {
+        throw std::runtime_error(
+                "SPIR-V id " + std::to_string(id) + " is not a type "
+                + std::to_string(opcode));
+    }
+
+    return type;
+}
+
+// The type a variable's pointer type points to.
+[[nodiscard]] auto
+pointee(SpirvModule const& module, SpirvVariable const& variable) -> uint32_t
+{
+    return type_of(module, variable.pointerType, spirv::TypePointer)
+            .operands[1];
+}
+
+[[nodiscard]] auto
+type_size(
+        SpirvModule const& module,
+        uint32_t const id,
+        uint32_t const matrixStride = 0) -> uint32_t
+{
+    auto const& type = type_of(module, id);
+
+    switch(type.opcode) {
+    case spirv::TypeBool: return 4;
+    case spirv::TypeInt:
+    case spirv::TypeFloat: return type.operands[0] / 8;
+    case spirv::TypeVector:
+        return type.operands[1] * type_size(module, type.operands[0]);
+    case spirv::TypeMatrix: {
+        auto const columnSize = matrixStride != 0
+                                        ? matrixStride
+                                        : type_size(module, type.operands[0]);
+        return type.operands[1] * columnSize;
+    }
+    case spirv::TypeArray: {
+        auto const stride = module.decorations.count(id) != 0
+                                    ? module.decorations.at(id).arrayStride
+                                    : std::nullopt;
+        auto const length = module.constants.at(type.operands[1]);
+
+        return length
+               * stride.value_or(type_size(module, type.operands[0]));
+    }
+    case spirv::TypeStruct: {
+        auto const members = module.members.find(id);
+
+        auto size = uint32_t{0};
+        for(auto i = size_t{0}; i < type.operands.size(); ++i) {
+            auto const member = members != std::cend(module.members)
+                                                && i < members->second.size()
+                                        ? members->second[i]
+                                        : SpirvMember{};
+
+            size = std::max(
+                    size,
+                    member.offset
+                            + type_size(
+                                    module,
+                                    type.operands[i],
+                                    member.matrixStride));
+        }
+
+        return size;
+    }
+    default: return 0;
+    }
+}
+
+[[nodiscard]] auto
+image_descriptor_type(SpirvType const& image) -> vk::DescriptorType
+{
+    auto const dim     = image.operands[1];
+    auto const storage = image.operands[5] == 2;
+
+    if(dim == spirv::SubpassData) {
+        return vk::DescriptorType::eInputAttachment;
+    }
+
+    if(dim == spirv::Buffer) {
+        return storage ? vk::DescriptorType::eStorageTexelBuffer
+                       : vk::DescriptorType::eUniformTexelBuffer;
+    }
+
+    return storage ? vk::DescriptorType::eStorageImage
+                   : vk::DescriptorType::eSampledImage;
+}
+
+// Unwraps arrays of resources into the descriptor count. Returns nullopt for
+// variables that are not descriptors.
+[[nodiscard]] auto
+reflect_descriptor(SpirvModule const& module, SpirvVariable const& variable)
+        -> std::optional<shaderUtils::ReflectedDescriptor>
+{
+    auto const decorations = module.decorations.find(variable.id);
+    if(decorations == std::cend(module.decorations)
+       || !decorations->second.binding) {
+        return std::nullopt;
+    }
+
+    auto typeId = pointee(module, variable);
+    auto count  = uint32_t{1};
+    while(true) {
+        auto const& type = type_of(module, typeId);
+        if(type.opcode == spirv::TypeArray) {
+            count *= module.constants.at(type.operands[1]);
+        }
+        else if(type.opcode != spirv::TypeRuntimeArray) {
+            break;
+        }
+
+        typeId = type.operands[0];
+    }
+
+    auto const& type = type_of(module, typeId);
+    auto const descriptor = [&]() -> std::optional<vk::DescriptorType> {
+        switch(variable.storageClass) {
+        case spirv::Uniform:
+            return module.decorations.count(typeId) != 0
+                                   && module.decorations.at(typeId).bufferBlock
+                           ? vk::DescriptorType::eStorageBuffer
+                           : vk::DescriptorType::eUniformBuffer;
+        case spirv::StorageBuffer: return vk::DescriptorType::eStorageBuffer;
+        case spirv::UniformConstant:
+            if(type.opcode == spirv::TypeSampler) {
+                return vk::DescriptorType::eSampler;
+            }
+
+            if(type.opcode == spirv::TypeSampledImage) {
+                auto const& image =
+                        type_of(module, type.operands[0], spirv::TypeImage);
+                return image.operands[1] == spirv::Buffer
+                               ? vk::DescriptorType::eUniformTexelBuffer
+                               : vk::DescriptorType::eCombinedImageSampler;
+            }
+
+            if(type.opcode == spirv::TypeImage) {
+                return image_descriptor_type(type);
+            }
+
+            return std::nullopt;
+        default: return std::nullopt;
+        }
+    }();
+
+    if(!descriptor) {
+        return std::nullopt;
+    }
+
+    return shaderUtils::ReflectedDescriptor{
+            decorations->second.set.value_or(0),
+            *decorations->second.binding,
+            *descriptor,
+            count};
+}
+
+// 32 bit scalars and vectors, the only types vertex attributes are read as
+// here. Anything else is reported as undefined.
+[[nodiscard]] auto
+input_format(SpirvModule const& module, uint32_t const typeId) -> vk::Format
+{
+    auto const& type = type_of(module, typeId);
+
+    auto const isVector   = type.opcode == spirv::TypeVector;
+    auto const& component = isVector ? type_of(module, type.operands[0]) : type;
+    auto const components = isVector ? type.operands[1] : 1u;
+
+    if(component.operands.empty() || component.operands[0] != 32
+       || components < 1 || components > 4) {
+        return vk::Format::eUndefined;
+    }
+
+    if(component.opcode == spirv::TypeFloat) {
+        return std::array{
+                vk::Format::eR32Sfloat,
+                vk::Format::eR32G32Sfloat,
+                vk::Format::eR32G32B32Sfloat,
+                vk::Format::eR32G32B32A32Sfloat}[components - 1];
+    }
+
+    if(component.opcode != spirv::TypeInt) {
+        return vk::Format::eUndefined;
+    }
+
+    auto const isSigned = component.operands[1] == 1;
+    return isSigned ? std::array{
+                              vk::Format::eR32Sint,
+                              vk::Format::eR32G32Sint,
+                              vk::Format::eR32G32B32Sint,
+                              vk::Format::eR32G32B32A32Sint}[components - 1]
+                    : std::array{
+                              vk::Format::eR32Uint,
+                              vk::Format::eR32G32Uint,
+                              vk::Format::eR32G32B32Uint,
+                              vk::Format::eR32G32B32A32Uint}[components - 1];
+}
+
+[[nodiscard]] auto
+reflect_push_constants(
+        SpirvModule const& module,
+        SpirvVariable const& variable,
+        vk::ShaderStageFlagBits const stage) -> vk::PushConstantRange
+{
+    auto const blockType = pointee(module, variable);
+    auto const members   = module.members.find(blockType);
+
+    auto offset = uint32_t{0};
+    if(members != std::cend(module.members) && !members->second.empty()) {
+        offset = std::min_element(
+                         std::cbegin(members->second),
+                         std::cend(members->second),
+                         [](SpirvMember const& lhs, SpirvMember const& rhs) {
+                             return lhs.offset < rhs.offset;
+                         })
+                         ->offset;
+    }
+
+    return vk::PushConstantRange(
+            stage,
+            offset,
+            type_size(module, blockType) - offset);
+}
+
+namespace shaderUtils {
+
+[[nodiscard]] auto
+reflect_spirv(
+        gsl::span<uint32_t const> const words,
+        vk::ShaderStageFlagBits const stage) -> ShaderReflection
+{
+    auto const module = parse_module(words);
+
+    auto reflection  = ShaderReflection{};
+    reflection.stage = stage;
+
+    for(auto const& variable : module.variables) {
+        switch(variable.storageClass) {
+        case spirv::UniformConstant:
+        case spirv::Uniform:
+        case spirv::StorageBuffer:
+            if(auto const descriptor = reflect_descriptor(module, variable)) {
+                reflection.descriptors.push_back(*descriptor);
+            }
+            break;
+        case spirv::PushConstant:
+            reflection.pushConstants.push_back(
+                    reflect_push_constants(module, variable, stage));
+            break;
+        case spirv::Input: {
+            auto const decorations = module.decorations.find(variable.id);
+            if(stage != vk::ShaderStageFlagBits::eVertex
+               || decorations == std::cend(module.decorations)
+               || decorations->second.builtIn
+               || !decorations->second.location) {
+                break;
+            }
+
+            reflection.inputs.push_back(
+                    {*decorations->second.location,
+                     input_format(module, pointee(module, variable))});
+            break;
+        }
+        default: break;
+        }
+    }
+
+    std::sort(
+            std::begin(reflection.inputs),
+            std::end(reflection.inputs),
+            [](ReflectedInput const& lhs, ReflectedInput const& rhs) {
+                return lhs.location < rhs.location;
+            });
+
+    return reflection;
+}
+
+[[nodiscard]] auto
+operator==(
+        PipelineLayoutDescription const& lhs,
+        PipelineLayoutDescription const& rhs) -> bool
+{
+    return lhs.sets == rhs.sets && lhs.pushConstants == rhs.pushConstants;
+}
+
+[[nodiscard]] auto
+operator!=(
+        PipelineLayoutDescription const& lhs,
+        PipelineLayoutDescription const& rhs) -> bool
+{
+    return !(lhs == rhs);
+}
+
+// Push constant ranges are merged into one range visible to every stage
+// using any of them, which keeps the layout valid however the stages'
+// blocks overlap.
+[[nodiscard]] auto
+merge_reflections(std::vector<ShaderReflection const*> const& reflections)
+        -> PipelineLayoutDescription
+{
+    auto layout = PipelineLayoutDescription{};
+    auto pushConstants = std::optional<vk::PushConstantRange>{};
+
+    for(auto const* reflection : reflections) {
+        for(auto const& descriptor : reflection->descriptors) {
+            if(layout.sets.size() <= descriptor.set) {
+                layout.sets.resize(descriptor.set + 1);
+            }
+
+            auto& set     = layout.sets[descriptor.set];
+            auto existing = std::find_if(
+                    std::begin(set),
+                    std::end(set),
+                    [&](vk::DescriptorSetLayoutBinding const& binding) {
+                        return binding.binding == descriptor.binding;
+                    });
+
+            if(existing == std::end(set)) {
+                set.emplace_back(
+                        descriptor.binding,
+                        descriptor.type,
+                        descriptor.count,
+                        reflection->stage);
+                continue;
+            }
+
+            if(existing->descriptorType != descriptor.type
+               || existing->descriptorCount != descriptor.count) {
+                throw std::runtime_error(
+                        "Shaders disagree on set "
+                        + std::to_string(descriptor.set) + " binding "
+                        + std::to_string(descriptor.binding) + ": "
+                        + vk::to_string(existing->descriptorType)
+                        + " and " + vk::to_string(descriptor.type));
+            }
+
+            existing->stageFlags |= reflection->stage;
+        }
+
+        for(auto const& range : reflection->pushConstants) {
+            if(!pushConstants) {
+                pushConstants = range;
+                continue;
+            }
+
+            auto const end = std::max(
+                    pushConstants->offset + pushConstants->size,
+                    range.offset + range.size);
+
+            pushConstants->offset =
+                    std::min(pushConstants->offset, range.offset);
+            pushConstants->size   = end - pushConstants->offset;
+            pushConstants->stageFlags |= range.stageFlags;
+        }
+    }
+
+    for(auto& set : layout.sets) {
+        std::sort(
+                std::begin(set),
+                std::end(set),
+                [](vk::DescriptorSetLayoutBinding const& lhs,
+                   vk::DescriptorSetLayoutBinding const& rhs) {
+                    return lhs.binding < rhs.binding;
+                });
+    }
+
+    if(pushConstants) {
+        layout.pushConstants.push_back(*pushConstants);
+    }
+
+    return layout;
+}
+
+auto
+make_dynamic(
+        PipelineLayoutDescription& layout,
+        uint32_t const set,
+        uint32_t const binding) -> void
+{
+    auto const missing = std::runtime_error(
+            "No buffer at set " + std::to_string(set) + " binding "
+            + std::to_string(binding) + " to make dynamic");
+
+    if(set >= layout.sets.size()) {
+        throw missing;
+    }
+
+    for(auto& candidate : layout.sets[set]) {
+        if(candidate.binding != binding) {
+            continue;
+        }
+
+        if(candidate.descriptorType == vk::DescriptorType::eUniformBuffer) {
+            candidate.descriptorType =
+                    vk::DescriptorType::eUniformBufferDynamic;
+            return;
+        }
+
+        if(candidate.descriptorType == vk::DescriptorType::eStorageBuffer) {
+            candidate.descriptorType =
+                    vk::DescriptorType::eStorageBufferDynamic;
+            return;
+        }
+    }
+
+    throw missing;
+}
+
+auto
+verify_vertex_input(
+        ShaderReflection const& reflection,
+        gsl::span<vk::VertexInputAttributeDescription const> const attributes)
+        -> void
+{
+    for(auto const& input : reflection.inputs) {
+        auto const attribute = std::find_if(
+                std::cbegin(attributes),
+                std::cend(attributes),
+                [&](vk::VertexInputAttributeDescription const& candidate) {
+                    return candidate.location == input.location;
+                });
+
+        if(attribute == std::cend(attributes)) {
+            throw std::runtime_error(
+                    "No vertex attribute feeds location "
+                    + std::to_string(input.location));
+        }
+
+        if(input.format != vk::Format::eUndefined
+           && attribute->format != input.format) {
+            throw std::runtime_error(
+                    "Vertex attribute at location "
+                    + std::to_string(input.location) + " is "
+                    + vk::to_string(attribute->format) + ", the shader reads "
+                    + vk::to_string(input.format));
+        }
+    }
+}
+
+}    // namespace shaderUtils
@@ -0,0 +1,94 @@
+#include "stagingRing.hpp"
+
+#include <cstring>
+
+[[nodiscard]] auto
+create_staging_buffer(
+        vulkanUtils::MemoryAllocator& allocator,
+        vk::DeviceSize const capacity) -> vulkanUtils::AllocatedBuffer
+{
+    return allocator.create_buffer(
+            vk::BufferCreateInfo(
+                    {},
+                    capacity,
+                    vk::BufferUsageFlagBits::eTransferSrc,
+                    vk::SharingMode::eExclusive),
+            vk::MemoryPropertyFlagBits::eHostVisible
+                    | vk::MemoryPropertyFlagBits::eHostCoherent);
+}
+
+namespace vulkanUtils {
+
+StagingRing::StagingRing(
+        MemoryAllocator& allocator,
+        vk::DeviceSize const capacity,
+        uint32_t const framesInFlight) :
+            m_buffer{create_staging_buffer(allocator, capacity)},
+            m_capacity{capacity},
+            m_head{0},
+            m_used{0},
+            m_pending{0},
+            m_frameBytes(framesInFlight)
+{}
+
+[[nodiscard]] auto
+StagingRing::buffer() const noexcept -> vk::Buffer const&
+{
+    return *m_buffer.buffer;
+}
+
+[[nodiscard]] auto
+StagingRing::capacity() const noexcept -> vk::DeviceSize
+{
+    return m_capacity;
+}
+
+[[nodiscard]] auto
+StagingRing::write(
+        gsl::span<std::byte const> const data,
+        vk::DeviceSize const alignment) -> std::optional<vk::DeviceSize>
+{
+    auto const size = static_cast<vk::DeviceSize>(data.size());
+
+    auto offset = (m_head + alignment - 1) / alignment * alignment;
+    if(offset + size > m_capacity) {
+        offset = 0;
+    }
+
+    // Bytes skipped at the end of the ring when wrapping count as used, so
+    // that they are reclaimed together with the frame that skipped them.
+    auto const skipped =
+            offset >= m_head ? offset - m_head : m_capacity - m_head;
+    auto const needed = skipped + size;
+
+    if(m_used + needed > m_capacity) {
+        return std::nullopt;
+    }
+
+    std::memcpy(
+            static_cast<std::byte*>(m_buffer.allocation.mapped()) + offset,
+            data.data(),
+            data.size());
+
+    m_head = offset + size;
+    m_used += needed;
+    m_pending += needed;
+
+    return offset;
+}
+
+auto
+StagingRing::end_frame(uint32_t const frameIndex) noexcept -> void
+{
+    m_frameBytes[frameIndex] += m_pending;
+    m_pending = 0;
+}
+
+auto
+StagingRing::release_frame(uint32_t const frameIndex) noexcept -> void
+{
+    m_used -= m_frameBytes[frameIndex];
+    m_frameBytes[frameIndex] = 0;
+}
+
+}    // namespace vulkanUtils
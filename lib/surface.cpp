@@ -39,6 +39,40 @@ surfacePresentationModeSupported(
            != std::end(supportedPresentationModes);
 }
 
+// Falls back to the first format the surface offers, there is always one.
+[[nodiscard]] auto
+firstSupportedSurfaceFormat(
+        std::vector<vk::SurfaceFormatKHR> const& supportedFormats,
+        std::vector<vk::SurfaceFormatKHR> const& requestedFormats) noexcept
+        -> vk::SurfaceFormatKHR
+{
+    for(auto const& format : requestedFormats) {
+        if(surfaceFormatSupported(supportedFormats, format)) {
+            return format;
+        }
+    }
+
+    return supportedFormats.front();
+}
+
+// Falls back to FIFO, the only mode every surface has to support.
+[[nodiscard]] auto
+firstSupportedPresentationMode(
+        std::vector<vk::PresentModeKHR> const& supportedPresentationModes,
+        std::vector<vk::PresentModeKHR> const&
+                requestedPresentationModes) noexcept -> vk::PresentModeKHR
+{
+    for(auto const& presentationMode : requestedPresentationModes) {
+        if(surfacePresentationModeSupported(
+                   supportedPresentationModes,
+                   presentationMode)) {
+            return presentationMode;
+        }
+    }
+
+    return vk::PresentModeKHR::eFifo;
+}
+
 }    // namespace vulkanUtils
 
 namespace vulkanUtils {
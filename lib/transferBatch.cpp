@@ -0,0 +1,223 @@
+#include "transferBatch.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+auto constexpr stagingAlignment = vk::DeviceSize{16};
+
+[[nodiscard]] auto
+create_transfer_slots(
+        vk::Device const& logicalDevice,
+        uint32_t const transferFamily,
+        uint32_t const framesInFlight) -> std::vector<vulkanUtils::TransferSlot>
+{
+    auto slots = std::vector<vulkanUtils::TransferSlot>{};
+    slots.reserve(framesInFlight);
+
+    for(auto i = 0u; i < framesInFlight; ++i) {
+        auto commandPool = logicalDevice.createCommandPoolUnique(
+                vk::CommandPoolCreateInfo(
+                        vk::CommandPoolCreateFlagBits::eTransient,
+                        transferFamily));
+
+        auto commandBuffers = logicalDevice.allocateCommandBuffersUnique(
+                vk::CommandBufferAllocateInfo(
+                        *commandPool,
+                        vk::CommandBufferLevel::ePrimary,
+                        1));
+
+        slots.push_back(
+                {std::move(commandPool),
+                 std::move(commandBuffers.front()),
+                 logicalDevice.createSemaphoreUnique({}),
+                 logicalDevice.createFenceUnique(
+                         {vk::FenceCreateFlagBits::eSignaled})});
+    }
+
+    return slots;
+}
+
+namespace vulkanUtils {
+
+TransferBatch::TransferBatch(
+        vk::Device const& logicalDevice,
+        MemoryAllocator& allocator,
+        QueueTopology const& queues,
+        vk::Queue const& transferQueue,
+        uint32_t const framesInFlight,
+        vk::DeviceSize const stagingCapacity) :
+            m_transferFamily{queues.transfer.family},
+            m_graphicsFamily{queues.graphics.family},
+            m_transferQueue{transferQueue},
+            m_staging{allocator, stagingCapacity, framesInFlight},
+            m_slots{create_transfer_slots(
+                    logicalDevice,
+                    m_transferFamily,
+                    framesInFlight)},
+            m_pending{},
+            m_stats{},
+            m_boundDevice{logicalDevice}
+{}
+
+[[nodiscard]] auto
+TransferBatch::boundDevice() const noexcept -> vk::Device const&
+{
+    return m_boundDevice.get();
+}
+
+[[nodiscard]] auto
+TransferBatch::stats() const noexcept -> TransferStats const&
+{
+    return m_stats;
+}
+
+auto
+TransferBatch::begin_frame(uint32_t const frameIndex) -> void
+{
+    auto const& logicalDevice = m_boundDevice.get();
+    auto const& slot          = m_slots[frameIndex];
+
+    auto const signaled = logicalDevice.waitForFences(
+            *slot.done,
+            VK_TRUE,
+            std::numeric_limits<uint64_t>::max());
+
+    if(signaled != vk::Result::eSuccess) {
+        throw std::runtime_error("Transfer fence could not be signaled");
+    }
+
+    m_staging.release_frame(frameIndex);
+    logicalDevice.resetCommandPool(*slot.commandPool, {});
+}
+
+auto
+TransferBatch::upload(
+        vk::Buffer const& destination,
+        vk::DeviceSize const offset,
+        gsl::span<std::byte const> const data) -> void
+{
+    auto const stagingOffset = m_staging.write(data, stagingAlignment);
+    if(!stagingOffset) {
+        throw std::runtime_error(
+                "Staging ring is full, "
+                + std::to_string(data.size()) + " bytes do not fit in "
+                + std::to_string(m_staging.capacity()));
+    }
+
+    auto const size = static_cast<vk::DeviceSize>(data.size());
+    m_pending.push_back({destination, {*stagingOffset, offset, size}});
+
+    m_stats.bytesUploaded += size;
+    ++m_stats.copies;
+}
+
+// One barrier per destination buffer, m_pending has to be sorted by
+// destination. Only transfers ownership when the families differ.
+[[nodiscard]] auto
+TransferBatch::ownership_barriers(
+        vk::AccessFlags const srcAccess,
+        vk::AccessFlags const dstAccess) const
+        -> std::vector<vk::BufferMemoryBarrier>
+{
+    auto const transferOwnership = m_transferFamily != m_graphicsFamily;
+
+    auto const srcFamily =
+            transferOwnership ? m_transferFamily : VK_QUEUE_FAMILY_IGNORED;
+    auto const dstFamily =
+            transferOwnership ? m_graphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+
+    auto barriers = std::vector<vk::BufferMemoryBarrier>{};
+    for(auto const& copy : m_pending) {
+        if(!barriers.empty() && barriers.back().buffer == copy.destination) {
+            continue;
+        }
+
+        barriers.emplace_back(
+                srcAccess,
+                dstAccess,
+                srcFamily,
+                dstFamily,
+                copy.destination,
+                0,
+                VK_WHOLE_SIZE);
+    }
+
+    return barriers;
+}
+
+[[nodiscard]] auto
+TransferBatch::submit(uint32_t const frameIndex) -> UploadAcquire
+{
+    if(m_pending.empty()) {
+        return {};
+    }
+
+    auto const& logicalDevice = m_boundDevice.get();
+    auto const& slot          = m_slots[frameIndex];
+    auto const& commandBuffer = *slot.commandBuffer;
+
+    std::stable_sort(
+            std::begin(m_pending),
+            std::end(m_pending),
+            [](PendingCopy const& lhs, PendingCopy const& rhs) {
+                return lhs.destination < rhs.destination;
+            });
+
+    commandBuffer.begin(vk::CommandBufferBeginInfo{
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+
+    auto regions = std::vector<vk::BufferCopy>{};
+    for(auto copy = std::cbegin(m_pending); copy != std::cend(m_pending);) {
+        auto const destination = copy->destination;
+
+        regions.clear();
+        for(; copy != std::cend(m_pending) && copy->destination == destination;
+            ++copy) {
+            regions.push_back(copy->region);
+        }
+
+        commandBuffer.copyBuffer(m_staging.buffer(), destination, regions);
+    }
+
+    if(m_transferFamily != m_graphicsFamily) {
+        commandBuffer.pipelineBarrier(
+                vk::PipelineStageFlagBits::eTransfer,
+                vk::PipelineStageFlagBits::eBottomOfPipe,
+                {},
+                nullptr,
+                ownership_barriers(vk::AccessFlagBits::eTransferWrite, {}),
+                nullptr);
+    }
+
+    commandBuffer.end();
+
+    auto const submitInfo = vk::SubmitInfo(
+            0,
+            nullptr,
+            nullptr,
+            1,
+            &commandBuffer,
+            1,
+            &slot.uploaded.get());
+
+    logicalDevice.resetFences(*slot.done);
+    m_transferQueue.submit(submitInfo, *slot.done);
+
+    m_staging.end_frame(frameIndex);
+    ++m_stats.submissions;
+
+    auto acquire = UploadAcquire{
+            *slot.uploaded,
+            ownership_barriers(
+                    {},
+                    vk::AccessFlagBits::eVertexAttributeRead
+                            | vk::AccessFlagBits::eIndexRead)};
+
+    m_pending.clear();
+
+    return acquire;
+}
+
+}    // namespace vulkanUtils
@@ -0,0 +1,89 @@
+#include "uniformRing.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+[[nodiscard]] auto
+align_up(vk::DeviceSize const value, vk::DeviceSize const alignment) noexcept
+        -> vk::DeviceSize
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+[[nodiscard]] auto
+create_uniform_buffer(
+        vulkanUtils::MemoryAllocator& allocator,
+        vk::DeviceSize const size) -> vulkanUtils::AllocatedBuffer
+{
+    return allocator.create_buffer(
+            vk::BufferCreateInfo(
+                    {},
+                    size,
+                    vk::BufferUsageFlagBits::eUniformBuffer,
+                    vk::SharingMode::eExclusive),
+            vk::MemoryPropertyFlagBits::eHostVisible
+                    | vk::MemoryPropertyFlagBits::eHostCoherent);
+}
+
+namespace vulkanUtils {
+
+UniformRing::UniformRing(
+        MemoryAllocator& allocator,
+        vk::PhysicalDeviceLimits const& limits,
+        vk::DeviceSize const regionSize,
+        uint32_t const framesInFlight) :
+            m_alignment{std::max(
+                    limits.minUniformBufferOffsetAlignment,
+                    vk::DeviceSize{1})},
+            m_regionSize{align_up(regionSize, m_alignment)},
+            m_buffer{create_uniform_buffer(
+                    allocator,
+                    m_regionSize * framesInFlight)},
+            m_regionStart{0},
+            m_head{0}
+{}
+
+[[nodiscard]] auto
+UniformRing::buffer() const noexcept -> vk::Buffer const&
+{
+    return *m_buffer.buffer;
+}
+
+[[nodiscard]] auto
+UniformRing::regionSize() const noexcept -> vk::DeviceSize
+{
+    return m_regionSize;
+}
+
+auto
+UniformRing::begin_frame(uint32_t const frameIndex) noexcept -> void
+{
+    m_regionStart = m_regionSize * frameIndex;
+    m_head        = m_regionStart;
+}
+
+[[nodiscard]] auto
+UniformRing::push(gsl::span<std::byte const> const data) -> uint32_t
+{
+    auto const offset = m_head;
+    auto const size   = static_cast<vk::DeviceSize>(data.size());
+
+    if(offset + size > m_regionStart + m_regionSize) {
+        throw std::runtime_error(
+                "Uniform ring region of " + std::to_string(m_regionSize)
+                + " bytes is full");
+    }
+
+    std::memcpy(
+            static_cast<std::byte*>(m_buffer.allocation.mapped()) + offset,
+            data.data(),
+            data.size());
+
+    m_head = align_up(offset + size, m_alignment);
+
+    return static_cast<uint32_t>(offset);
+}
+
+}    // namespace vulkanUtils
@@ -6,64 +6,12 @@
 #include <GLFW/glfw3.h>
 
 #include <algorithm>
-#include <cstring>
 #include <vector>
 #include <iostream>
 #include <string>
 
 namespace vulkanUtils {
 
-[[nodiscard]] auto
-extensions_supported(std::vector<char const*> const& extensionNames) noexcept
-        -> bool
-{
-    auto const supportedProperties = vk::enumerateInstanceExtensionProperties();
-
-    auto allSupported = true;
-    for(auto const* name : extensionNames) {
-        auto const iterator = std::find_if(
-                std::cbegin(supportedProperties),
-                std::cend(supportedProperties),
-                [name](auto&& property) {
-                    return strcmp(name, property.extensionName.data()) == 0;
-                });
-
-        if(iterator == std::cend(supportedProperties)) {
-            std::cerr << "Extension " << iterator->extensionName.data()
-                      << " not supported!\n";
-
-            allSupported = false;
-        }
-    }
-
-    return allSupported;
-}
-
-[[nodiscard]] auto
-layers_supported(std::vector<char const*> const& layerNames) noexcept -> bool
-{
-    auto const supportedProperties = vk::enumerateInstanceLayerProperties();
-
-    auto allSupported = true;
-    for(auto const* name : layerNames) {
-        auto const iterator = std::find_if(
-                std::cbegin(supportedProperties),
-                std::cend(supportedProperties),
-                [name](auto&& property) {
-                    return strcmp(name, property.layerName.data()) == 0;
-                });
-
-        if(iterator == std::cend(supportedProperties)) {
-            std::cerr << "layer " << iterator->layerName.data()
-                      << " not supported!\n";
-
-            allSupported = false;
-        }
-    }
-
-    return allSupported;
-}
-
 VKAPI_ATTR VkBool32 VKAPI_CALL
 debugCallback(
         VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
@@ -106,90 +54,50 @@ create_debug_messenger(
             dispatcher);
 }
 
-[[nodiscard]] auto
-get_next_graphics_queue_family(
-        vk::PhysicalDevice const& device,
-        long startIndex) -> QueueFamilyAndPos
-{
-    auto constexpr isGraphicsQueue = [](vk::QueueFamilyProperties const& prop) {
-        return (prop.queueFlags & vk::QueueFlagBits::eGraphics)
-               == vk::QueueFlagBits::eGraphics;
-    };
-
-    auto const queueProperties = device.getQueueFamilyProperties();
-    auto const queueIterator   = std::find_if(
-            std::cbegin(queueProperties) + startIndex,
-            std::cend(queueProperties),
-            isGraphicsQueue);
-
-    if(queueIterator == std::cend(queueProperties)) {
-        throw std::runtime_error{"Physical device has no next graphics queue!"};
-    }
-
-    return {*queueIterator, queueIterator - std::cbegin(queueProperties)};
-}
-
-[[nodiscard]] auto
-get_graphics_queues(vk::PhysicalDevice const& device) -> QueueFamilyAndPos
-{
-    return get_next_graphics_queue_family(device, 0);
-}
-
-[[nodiscard]] auto
-get_present_queues(
-        vk::PhysicalDevice const& device,
-        QueueFamilyAndPos firstGraphicsQueueFamily,
-        vk::SurfaceKHR const& surface) -> QueueFamilyAndPos
-{
-    auto presentationFamily = firstGraphicsQueueFamily;
-
-    try {
-        while(device.getSurfaceSupportKHR(presentationFamily.position, surface)
-              == 0u) {
-            presentationFamily = get_next_graphics_queue_family(
-                    device,
-                    presentationFamily.position + 1);
-        }
-    }
-    catch(std::exception const& e) {
-        using namespace std::string_literals;
-        throw std::runtime_error(
-                "Could not find a presentationQueueFamily because:\n"s
-                + e.what());
-    }
-
-    return presentationFamily;
-}
-
 [[nodiscard]] auto
 create_logical_device(
         vk::PhysicalDevice const& physicalDevice,
-        QueueFamilyAndPos const& queue,
-        std::vector<float> const& queuePriorities,
+        QueueTopology const& queues,
         std::vector<char const*> const& validationLayers,
-        std::vector<char const*> const& extensions) -> vk::UniqueDevice
+        std::vector<char const*> const& extensions,
+        vk::PhysicalDeviceFeatures const& features) -> vk::UniqueDevice
 {
-    auto const queueCreationInfo = vk::DeviceQueueCreateInfo(
-            {},
-            queue.position,
-            1,
-            queuePriorities.data());
-
-    static auto const deviceFeatures = physicalDevice.getFeatures();
+    auto const queueCreationInfos = queue_create_infos(queues);
 
     auto const deviceCreationInfo = vk::DeviceCreateInfo(
             {},
-            queueCreationInfo.queueCount,
-            &queueCreationInfo,
+            queueCreationInfos.size(),
+            queueCreationInfos.data(),
             validationLayers.size(),
             validationLayers.data(),
             extensions.size(),
             extensions.data(),
-            &deviceFeatures);
+            &features);
 
     return physicalDevice.createDeviceUnique(deviceCreationInfo);
 }
 
+[[nodiscard]] auto
+find_memory_type(
+        vk::PhysicalDeviceMemoryProperties const& memoryProperties,
+        uint32_t const supportedTypeBits,
+        vk::MemoryPropertyFlags const requiredProperties) -> uint32_t
+{
+    for(auto i = 0u; i < memoryProperties.memoryTypeCount; ++i) {
+        auto const supported = (supportedTypeBits & (1u << i)) != 0u;
+        auto const hasProperties =
+                (memoryProperties.memoryTypes[i].propertyFlags
+                 & requiredProperties)
+                == requiredProperties;
+
+        if(supported && hasProperties) {
+            return i;
+        }
+    }
+
+    throw std::runtime_error("No memory type with the required properties!");
+}
+
 [[nodiscard]] auto
 clamp_extent_dimensions(
         vk::Extent2D const minExtent,
@@ -222,9 +130,11 @@ swap_chain_unique(
         vk::SurfaceCapabilitiesKHR const& surfaceCaps,
         vk::SurfaceFormatKHR const& surfaceFormat,
         vk::PresentModeKHR const& presentationMode,
+        uint32_t const imageCount,
         vk::Extent2D const currentDimensions,
         std::vector<uint32_t> const& queueFamilyIndicies,
-        vk::UniqueDevice const& logicalDevice) -> vk::UniqueSwapchainKHR
+        vk::UniqueDevice const& logicalDevice,
+        vk::SwapchainKHR const& oldSwapchain) -> vk::UniqueSwapchainKHR
 {
     auto const sharingMode = queueFamilyIndicies.size() > 1u
                                      ? vk::SharingMode::eConcurrent
@@ -233,7 +143,7 @@ swap_chain_unique(
     return logicalDevice->createSwapchainKHRUnique(vk::SwapchainCreateInfoKHR(
             {},
             surface,
-            surfaceCaps.minImageCount,
+            imageCount,
             surfaceFormat.format,
             surfaceFormat.colorSpace,
             currentDimensions,
@@ -245,7 +155,8 @@ swap_chain_unique(
             surfaceCaps.currentTransform,
             vk::CompositeAlphaFlagBitsKHR::eOpaque,
             presentationMode,
-            VK_TRUE));
+            VK_TRUE,
+            oldSwapchain));
 }
 
 [[nodiscard]] auto
@@ -254,22 +165,25 @@ create_swap_chain(
         vk::SurfaceCapabilitiesKHR const& surfaceCaps,
         vk::SurfaceFormatKHR const& surfaceFormat,
         vk::PresentModeKHR const& presentationMode,
+        uint32_t const imageCount,
         vk::UniqueDevice const& logicalDevice,
         vk::Extent2D requestedDimensions,
-        std::vector<uint32_t> const& queueFamilyIndicies)
-        -> vk::UniqueSwapchainKHR
+        std::vector<uint32_t> const& queueFamilyIndicies,
+        vk::SwapchainKHR const& oldSwapchain) -> vk::UniqueSwapchainKHR
 {
     return swap_chain_unique(
             surface,
             surfaceCaps,
             surfaceFormat,
             presentationMode,
+            imageCount,
             clamp_extent_dimensions(
                     surfaceCaps.minImageExtent,
                     surfaceCaps.maxImageExtent,
                     requestedDimensions),
             queueFamilyIndicies,
-            logicalDevice);
+            logicalDevice,
+            oldSwapchain);
 }
 
 [[nodiscard]] auto
@@ -315,8 +229,9 @@ create_image_views(
     return imageViews;
 }
 
-[[nodiscard]] auto constexpr colour_attachment(vk::Format format) noexcept
-        -> vk::AttachmentDescription
+[[nodiscard]] auto constexpr colour_attachment(
+        vk::Format format,
+        vk::ImageLayout finalLayout) noexcept -> vk::AttachmentDescription
 {
     return vk::AttachmentDescription(
             {},
@@ -327,14 +242,16 @@ create_image_views(
             vk::AttachmentLoadOp::eDontCare,
             vk::AttachmentStoreOp::eDontCare,
             vk::ImageLayout::eUndefined,
-            vk::ImageLayout::ePresentSrcKHR);
+            finalLayout);
 }
 
 [[nodiscard]] auto
-create_render_pass(vk::UniqueDevice const& logicalDevice, vk::Format format)
-        -> vk::UniqueRenderPass
+create_render_pass(
+        vk::UniqueDevice const& logicalDevice,
+        vk::Format format,
+        vk::ImageLayout finalLayout) -> vk::UniqueRenderPass
 {
-    auto const colourAttachment          = colour_attachment(format);
+    auto const colourAttachment = colour_attachment(format, finalLayout);
     auto const colourAttachmentReference = vk::AttachmentReference{
             0,
             vk::ImageLayout::eColorAttachmentOptimal};
@@ -367,116 +284,6 @@ create_render_pass(vk::UniqueDevice const& logicalDevice, vk::Format format)
     return logicalDevice->createRenderPassUnique(renderPassCreationInfo);
 }
 
-[[nodiscard]] auto
-graphics_pipeline_create_info(
-        vk::PipelineCreateFlags const flags,
-        ShaderStageInfoVec const* shaderStages,
-        VertexInputState const* vertexInputState,
-        InputAssemblyState const* inputAssemblyState,
-        TessellationState const* tessellationState,
-        ViewportState const* viewportState,
-        RasterizationState const* rasterizationState,
-        MultisampleState const* multisampleState,
-        DepthStencilState const* depthStencilState,
-        ColourBlendState const* colourBlendState,
-        DynamicState const* dynamicState,
-        vk::UniquePipelineLayout const& layout,
-        vk::UniqueRenderPass const& renderPass,
-        uint32_t const renderPassPosition) -> vk::GraphicsPipelineCreateInfo
-{
-    return vk::GraphicsPipelineCreateInfo(
-            flags,
-            shaderStages != nullptr ? shaderStages->size() : 0,
-            shaderStages != nullptr ? shaderStages->data() : nullptr,
-            vertexInputState,
-            inputAssemblyState,
-            tessellationState,
-            viewportState,
-            rasterizationState,
-            multisampleState,
-            depthStencilState,
-            colourBlendState,
-            dynamicState,
-            *layout,
-            *renderPass,
-            renderPassPosition,
-            nullptr,
-            -1);
-}
-
-[[nodiscard]] auto
-create_graphics_pipeline(
-        vk::UniqueDevice const& logicalDevice,
-        shaderUtils::VertexShader const& vertexShader,
-        shaderUtils::FragmentShader const& fragmentShader,
-        int const width,
-        int const height,
-        ColourBlendState const& colourBlendState,
-        DynamicState const* dynamicState,
-        vk::UniquePipelineLayout const& pipelineLayout,
-        vk::UniqueRenderPass const& renderPass) -> vk::UniquePipeline
-{
-    auto const shaderStageInfos = ShaderStageInfoVec{
-            shaderUtils::shader_stage_creation_info(
-                    vertexShader.module,
-                    shaderUtils::VertexShader::type,
-                    "main"),
-            shaderUtils::shader_stage_creation_info(
-                    fragmentShader.module,
-                    shaderUtils::FragmentShader::type,
-                    "main")};
-
-    auto constexpr vertexInput = VertexInputState{};
-
-    auto constexpr inputAssembly = InputAssemblyState(
-            {},
-            vk::PrimitiveTopology::eTriangleList,
-            vkFalse);
-
-    auto constexpr* tessellationStatePtr =
-            static_cast<TessellationState*>(nullptr);
-
-    auto const viewport      = create_viewport(width, height);
-    auto const scissor       = create_scissor(width, height);
-    auto const viewportState = create_viewport_state(viewport, scissor);
-
-    auto const rasterisationState = RasterizationState{
-            {},
-            vkFalse,
-            vkFalse,
-            vk::PolygonMode::eFill,
-            vk::CullModeFlagBits::eBack,
-            vk::FrontFace::eClockwise,
-            vkFalse,
-            0.0f,
-            0.0f,
-            0.0f,
-            1.0f};
-
-    auto constexpr multisampleState  = MultisampleState{};
-    auto constexpr depthStencilState = DepthStencilState{};
-
-    return logicalDevice
-            ->createGraphicsPipelineUnique(
-                    nullptr,
-                    vulkanUtils::graphics_pipeline_create_info(
-                            {},
-                            &shaderStageInfos,
-                            &vertexInput,
-                            &inputAssembly,
-                            tessellationStatePtr,
-                            &viewportState,
-                            &rasterisationState,
-                            &multisampleState,
-                            &depthStencilState,
-                            &colourBlendState,
-                            dynamicState,
-                            pipelineLayout,
-                            renderPass,
-                            0))
-            .value;
-}
-
 [[nodiscard]] auto
 create_framebuffer(
         vk::UniqueDevice const& logicalDevice,
@@ -496,6 +303,93 @@ create_framebuffer(
     return logicalDevice->createFramebufferUnique(creationInfo);
 }
 
+[[nodiscard]] auto
+create_pipeline_layout(
+        vk::Device const& logicalDevice,
+        std::vector<vk::DescriptorSetLayout> const& setLayouts,
+        std::vector<vk::PushConstantRange> const& pushConstantRanges)
+        -> vk::UniquePipelineLayout
+{
+    return logicalDevice.createPipelineLayoutUnique(
+            vk::PipelineLayoutCreateInfo(
+                    {},
+                    static_cast<uint32_t>(setLayouts.size()),
+                    setLayouts.data(),
+                    static_cast<uint32_t>(pushConstantRanges.size()),
+                    pushConstantRanges.data()));
+}
+
+auto
+write_dynamic_uniform(
+        vk::Device const& logicalDevice,
+        vk::DescriptorSet const& set,
+        uint32_t const binding,
+        vk::Buffer const& buffer,
+        vk::DeviceSize const offset,
+        vk::DeviceSize const range) -> void
+{
+    auto const bufferInfo = vk::DescriptorBufferInfo(buffer, offset, range);
+
+    auto const write = vk::WriteDescriptorSet(
+            set,
+            binding,
+            0,
+            1,
+            vk::DescriptorType::eUniformBufferDynamic,
+            nullptr,
+            &bufferInfo,
+            nullptr);
+
+    logicalDevice.updateDescriptorSets(write, nullptr);
+}
+
+auto
+write_storage_buffer(
+        vk::Device const& logicalDevice,
+        vk::DescriptorSet const& set,
+        uint32_t const binding,
+        vk::Buffer const& buffer,
+        vk::DeviceSize const offset,
+        vk::DeviceSize const range) -> void
+{
+    auto const bufferInfo = vk::DescriptorBufferInfo(buffer, offset, range);
+
+    auto const write = vk::WriteDescriptorSet(
+            set,
+            binding,
+            0,
+            1,
+            vk::DescriptorType::eStorageBuffer,
+            nullptr,
+            &bufferInfo,
+            nullptr);
+
+    logicalDevice.updateDescriptorSets(write, nullptr);
+}
+
+auto
+write_storage_image(
+        vk::Device const& logicalDevice,
+        vk::DescriptorSet const& set,
+        uint32_t const binding,
+        vk::ImageView const& imageView) -> void
+{
+    auto const imageInfo =
+            vk::DescriptorImageInfo({}, imageView, vk::ImageLayout::eGeneral);
+
+    auto const write = vk::WriteDescriptorSet(
+            set,
+            binding,
+            0,
+            1,
+            vk::DescriptorType::eStorageImage,
+            &imageInfo,
+            nullptr,
+            nullptr);
+
+    logicalDevice.updateDescriptorSets(write, nullptr);
+}
+
 [[nodiscard]] auto
 create_framebuffers(
         vk::UniqueDevice const& logicalDevice,
@@ -519,30 +413,4 @@ create_framebuffers(
     return framebuffers;
 }
 
-[[nodiscard]] auto
-create_command_pool(
-        vk::UniqueDevice const& logicalDevice,
-        QueueFamilyAndPos const& queueFamily) -> vk::UniqueCommandPool
-{
-    auto const creationInfo =
-            vk::CommandPoolCreateInfo({}, queueFamily.position);
-
-    return logicalDevice->createCommandPoolUnique(creationInfo);
-}
-
-[[nodiscard]] auto
-allocate_command_buffers(
-        vk::UniqueDevice const& logicalDevice,
-        vk::UniqueCommandPool const& commandPool,
-        vk::CommandBufferLevel const commandLevel,
-        uint32_t const nrBuffers) -> std::vector<vk::UniqueCommandBuffer>
-{
-    auto const allocationInfo = vk::CommandBufferAllocateInfo(
-            *commandPool,
-            commandLevel,
-            nrBuffers);
-
-    return logicalDevice->allocateCommandBuffersUnique(allocationInfo);
-}
-
 }    // namespace vulkanUtils
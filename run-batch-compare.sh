@@ -0,0 +1,11 @@
+#!/bin/sh
+
+# Records the same 100k triangles with one draw call each and through the
+# draw batcher. Compare the "record" percentiles of the two reports.
+
+triangles=100000
+
+build-release/bench/vkTut_bench --headless --triangles=$triangles \
+    --output=draws_naive.json "$@"
+build-release/bench/vkTut_bench --headless --triangles=$triangles \
+    --batch-draws --output=draws_batched.json "$@"
@@ -0,0 +1,3 @@
+#!/bin/sh
+
+build-release/bench/vkTut_bench "$@"
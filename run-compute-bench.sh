@@ -0,0 +1,13 @@
+#!/bin/sh
+
+# Records headless frames with and without the compute pass animating the
+# triangles. Compare the "compute" and "render_pass" GPU scopes of the two
+# reports. Runs on lavapipe by pointing the loader at its ICD, e.g.
+# VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json
+
+triangles=100000
+
+build-release/bench/vkTut_bench --headless --triangles=$triangles \
+    --output=compute_off.json "$@"
+build-release/bench/vkTut_bench --headless --triangles=$triangles \
+    --compute --output=compute_on.json "$@"
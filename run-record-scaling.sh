@@ -0,0 +1,12 @@
+#!/bin/sh
+
+# Records the same draw list with an increasing number of threads, 0 being
+# the single threaded inline path. Any extra arguments go to every run.
+
+triangles=100000
+threads=$(nproc)
+
+for count in $(seq 0 "$threads"); do
+    build-release/bench/vkTut_bench --headless --triangles=$triangles \
+        --record-threads="$count" --output="record_threads_$count.json" "$@"
+done
@@ -0,0 +1,12 @@
+#!/bin/sh
+
+# Records the same frames binding the uniforms through a dynamic offset and
+# through a descriptor set written every frame. Compare the "record"
+# percentiles of the two reports.
+
+triangles=100000
+
+build-release/bench/vkTut_bench --headless --triangles=$triangles \
+    --output=uniforms_dynamic.json "$@"
+build-release/bench/vkTut_bench --headless --triangles=$triangles \
+    --rewrite-descriptors --output=uniforms_rewrite.json "$@"
@@ -1,21 +1,30 @@
 #version 450
 
-vec2 positions[3] = vec2[](
-    vec2(0.0, -0.5),
-    vec2(0.5, 0.5),
-    vec2(-0.5, 0.5)
-);
-
-vec3 colours[3] = vec3[](
-    vec3(1.0, 0.0, 0.0),
-    vec3(0.0, 1.0, 0.0),
-    vec3(0.0, 0.0, 1.0)
-);
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec3 colour;
+
+layout(location = 2) in vec2 instanceOffset;
+layout(location = 3) in vec2 instanceScale;
+
+layout(set = 0, binding = 0) uniform Frame {
+    vec2 scale;
+    vec2 offset;
+} frame;
+
+layout(push_constant) uniform Draw {
+    vec4 tint;
+} draw;
+
+// Specialized rather than branched on a uniform, the untinted variant has
+// the multiply folded away.
+layout(constant_id = 0) const bool tinted = true;
 
 layout(location = 0) out vec4 vertexColour;
 
 void 
 main() {
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-    vertexColour = vec4(colours[gl_VertexIndex], 1.0);
+    vec2 placed = position * instanceScale + instanceOffset;
+
+    gl_Position = vec4(placed * frame.scale + frame.offset, 0.0, 1.0);
+    vertexColour = tinted ? vec4(colour, 1.0) * draw.tint : vec4(colour, 1.0);
 }
@@ -0,0 +1,96 @@
+#include "drawBatcher.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstring>
+
+using vulkanUtils::IndirectBatch;
+using vulkanUtils::QueuedDraw;
+using vulkanUtils::SubMesh;
+
+// Handles are only compared here, any distinct values do.
+[[nodiscard]] auto
+fake_pipeline(uint64_t const value) -> vk::Pipeline
+{
+    auto handle = VkPipeline{};
+    std::memcpy(&handle, &value, sizeof(handle));
+
+    return vk::Pipeline{handle};
+}
+
+auto constexpr quad     = SubMesh{6, 0, 0};
+auto constexpr triangle = SubMesh{3, 6, 4};
+
+TEST_CASE("Draws of the same geometry become one command", "[drawBatcher]")
+{
+    auto const pipeline = fake_pipeline(1);
+
+    auto draws = std::vector<QueuedDraw>{
+            {pipeline, nullptr, quad, {{0.0f, 0.0f}, {1.0f, 1.0f}}},
+            {pipeline, nullptr, quad, {{1.0f, 0.0f}, {1.0f, 1.0f}}},
+            {pipeline, nullptr, quad, {{2.0f, 0.0f}, {1.0f, 1.0f}}}};
+    auto commands = std::vector<vk::DrawIndexedIndirectCommand>{};
+    auto batches  = std::vector<IndirectBatch>{};
+
+    vulkanUtils::build_batches(draws, commands, batches);
+
+    REQUIRE(commands.size() == 1);
+    REQUIRE(commands[0]
+            == vk::DrawIndexedIndirectCommand(
+                    quad.indexCount,
+                    3,
+                    quad.firstIndex,
+                    quad.vertexOffset,
+                    0));
+
+    REQUIRE(batches.size() == 1);
+    REQUIRE(batches[0].pipeline == pipeline);
+    REQUIRE(batches[0].firstCommand == 0);
+    REQUIRE(batches[0].commandCount == 1);
+}
+
+TEST_CASE("Draws are sorted and split by pipeline", "[drawBatcher]")
+{
+    auto const first  = fake_pipeline(1);
+    auto const second = fake_pipeline(2);
+
+    auto draws = std::vector<QueuedDraw>{
+            {second, nullptr, quad, {{0.0f, 0.0f}, {1.0f, 1.0f}}},
+            {first, nullptr, triangle, {{1.0f, 0.0f}, {1.0f, 1.0f}}},
+            {first, nullptr, quad, {{2.0f, 0.0f}, {1.0f, 1.0f}}},
+            {second, nullptr, quad, {{3.0f, 0.0f}, {1.0f, 1.0f}}}};
+    auto commands = std::vector<vk::DrawIndexedIndirectCommand>{};
+    auto batches  = std::vector<IndirectBatch>{};
+
+    vulkanUtils::build_batches(draws, commands, batches);
+
+    REQUIRE(draws[0].pipeline == first);
+    REQUIRE(draws[0].instance.offset.x == 2.0f);
+    REQUIRE(draws[1].instance.offset.x == 1.0f);
+
+    REQUIRE(commands.size() == 3);
+    REQUIRE(commands[0].firstIndex == quad.firstIndex);
+    REQUIRE(commands[0].instanceCount == 1);
+    REQUIRE(commands[1].firstIndex == triangle.firstIndex);
+    REQUIRE(commands[1].vertexOffset == triangle.vertexOffset);
+    REQUIRE(commands[1].firstInstance == 1);
+    REQUIRE(commands[2].instanceCount == 2);
+    REQUIRE(commands[2].firstInstance == 2);
+
+    REQUIRE(batches.size() == 2);
+    REQUIRE(batches[0].pipeline == first);
+    REQUIRE(batches[0].firstCommand == 0);
+    REQUIRE(batches[0].commandCount == 2);
+    REQUIRE(batches[1].pipeline == second);
+    REQUIRE(batches[1].firstCommand == 2);
+    REQUIRE(batches[1].commandCount == 1);
+
+    SECTION("Building again replaces the previous batches")
+    {
+        draws.clear();
+        vulkanUtils::build_batches(draws, commands, batches);
+
+        REQUIRE(commands.empty());
+        REQUIRE(batches.empty());
+    }
+}
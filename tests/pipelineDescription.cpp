@@ -0,0 +1,90 @@
+#include "pipelineDescription.hpp"
+
+#include <catch2/catch.hpp>
+
+using vulkanUtils::GraphicsPipelineDescription;
+using vulkanUtils::GraphicsPipelineDescriptionHash;
+
+using Tinted = shaderUtils::SpecializationPack<
+        shaderUtils::SpecializationConstant<0, bool>>;
+
+[[nodiscard]] auto
+described_pipeline(shaderUtils::SpecializationConstants specialization)
+        -> GraphicsPipelineDescription
+{
+    auto description = vulkanUtils::default_pipeline_description();
+
+    description.stages.push_back(
+            {vk::ShaderStageFlagBits::eVertex,
+             vk::ShaderModule{},
+             "main",
+             std::move(specialization)});
+    description.vertexBindings.emplace_back(
+            0,
+            uint32_t{8},
+            vk::VertexInputRate::eVertex);
+    description.vertexAttributes.emplace_back(
+            0,
+            0,
+            vk::Format::eR32G32Sfloat,
+            0);
+    description.extent = vk::Extent2D{800, 600};
+
+    return description;
+}
+
+TEST_CASE("Equal pipeline descriptions hash alike", "[pipelineDescription]")
+{
+    auto const hash     = GraphicsPipelineDescriptionHash{};
+    auto const original = described_pipeline(Tinted::values(true));
+
+    auto copy = described_pipeline(Tinted::values(true));
+    REQUIRE(copy == original);
+    REQUIRE(hash(copy) == hash(original));
+
+    SECTION("Rasterisation state is compared")
+    {
+        copy.cullMode = vk::CullModeFlagBits::eNone;
+    }
+
+    SECTION("Blend constants are compared")
+    {
+        copy.blendConstants[3] = 0.5f;
+    }
+
+    SECTION("Dynamic states are compared")
+    {
+        copy.dynamicStates.pop_back();
+    }
+
+    SECTION("Vertex input is compared")
+    {
+        copy.vertexAttributes[0].format = vk::Format::eR32G32B32Sfloat;
+    }
+
+    SECTION("Specialization values are compared")
+    {
+        copy.stages[0].specialization = Tinted::values(false);
+    }
+
+    SECTION("The subpass is compared")
+    {
+        copy.subpass = 1;
+    }
+
+    // Every run goes through exactly one of the sections above.
+    REQUIRE(copy != original);
+    REQUIRE(hash(copy) != hash(original));
+}
+
+TEST_CASE(
+        "Unspecialized stages differ from specialized ones",
+        "[pipelineDescription]")
+{
+    auto const hash        = GraphicsPipelineDescriptionHash{};
+    auto const specialized = described_pipeline(Tinted::values(true));
+    auto const plain       = described_pipeline({});
+
+    REQUIRE(specialized != plain);
+    REQUIRE(hash(specialized) != hash(plain));
+}
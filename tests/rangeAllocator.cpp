@@ -0,0 +1,98 @@
+#include "rangeAllocator.hpp"
+
+#include <catch2/catch.hpp>
+
+using vulkanUtils::AllocationStrategy;
+using vulkanUtils::RangeAllocator;
+using vulkanUtils::ResourceKind;
+
+TEST_CASE("Offsets are rounded up to the alignment", "[rangeAllocator]")
+{
+    STATIC_REQUIRE(vulkanUtils::align_up(0, 16) == 0);
+    STATIC_REQUIRE(vulkanUtils::align_up(1, 16) == 16);
+    STATIC_REQUIRE(vulkanUtils::align_up(16, 16) == 16);
+    STATIC_REQUIRE(vulkanUtils::align_up(17, 256) == 256);
+    STATIC_REQUIRE(vulkanUtils::align_up(17, 1) == 17);
+
+    STATIC_REQUIRE(vulkanUtils::same_page(0, 1023, 1024));
+    STATIC_REQUIRE_FALSE(vulkanUtils::same_page(1023, 1024, 1024));
+}
+
+TEST_CASE("Free list allocations are aligned", "[rangeAllocator]")
+{
+    auto ranges = RangeAllocator{1024, AllocationStrategy::FreeList, 1};
+
+    REQUIRE(ranges.try_allocate(100, 16, ResourceKind::Linear) == 0u);
+    REQUIRE(ranges.try_allocate(10, 256, ResourceKind::Linear) == 256u);
+    REQUIRE(ranges.try_allocate(4, 4, ResourceKind::Linear) == 100u);
+
+    REQUIRE(ranges.used() == 114);
+    REQUIRE(ranges.allocationCount() == 3);
+
+    REQUIRE_FALSE(ranges.try_allocate(1024, 1, ResourceKind::Linear));
+}
+
+TEST_CASE("Freed ranges are merged and reused by best fit", "[rangeAllocator]")
+{
+    auto ranges = RangeAllocator{1024, AllocationStrategy::FreeList, 1};
+    auto const generation = ranges.generation();
+
+    REQUIRE(ranges.try_allocate(64, 1, ResourceKind::Linear) == 0u);
+    REQUIRE(ranges.try_allocate(256, 1, ResourceKind::Linear) == 64u);
+    REQUIRE(ranges.try_allocate(64, 1, ResourceKind::Linear) == 320u);
+    REQUIRE(ranges.try_allocate(128, 1, ResourceKind::Linear) == 384u);
+
+    // Leaves a 256 byte hole and a 640 byte tail.
+    ranges.free(64, generation);
+    ranges.free(384, generation);
+
+    REQUIRE(ranges.try_allocate(200, 1, ResourceKind::Linear) == 64u);
+    REQUIRE(ranges.try_allocate(600, 1, ResourceKind::Linear) == 384u);
+
+    SECTION("Freeing everything leaves one range")
+    {
+        for(auto const offset : {0u, 64u, 320u, 384u}) {
+            ranges.free(offset, generation);
+        }
+
+        REQUIRE(ranges.used() == 0);
+        REQUIRE(ranges.allocationCount() == 0);
+        REQUIRE(ranges.try_allocate(1024, 1, ResourceKind::Linear) == 0u);
+    }
+}
+
+TEST_CASE(
+        "Linear and optimal resources do not share a granularity page",
+        "[rangeAllocator]")
+{
+    auto ranges = RangeAllocator{4096, AllocationStrategy::FreeList, 1024};
+
+    REQUIRE(ranges.try_allocate(100, 4, ResourceKind::Linear) == 0u);
+    REQUIRE(ranges.try_allocate(100, 4, ResourceKind::Optimal) == 1024u);
+
+    // Fits before the optimal page, but another optimal resource does not.
+    REQUIRE(ranges.try_allocate(100, 4, ResourceKind::Linear) == 100u);
+    REQUIRE(ranges.try_allocate(100, 4, ResourceKind::Optimal) == 1124u);
+}
+
+TEST_CASE("Linear allocations are only reclaimed by reset", "[rangeAllocator]")
+{
+    auto ranges = RangeAllocator{1024, AllocationStrategy::Linear, 1};
+    auto const generation = ranges.generation();
+
+    REQUIRE(ranges.try_allocate(100, 1, ResourceKind::Linear) == 0u);
+    REQUIRE(ranges.try_allocate(10, 64, ResourceKind::Linear) == 128u);
+
+    ranges.free(0, generation);
+    REQUIRE(ranges.try_allocate(4, 1, ResourceKind::Linear) == 138u);
+    REQUIRE_FALSE(ranges.try_allocate(1024, 1, ResourceKind::Linear));
+
+    ranges.reset();
+    REQUIRE(ranges.generation() != generation);
+    REQUIRE(ranges.used() == 0);
+    REQUIRE(ranges.try_allocate(64, 1, ResourceKind::Linear) == 0u);
+
+    // A handle from before the reset must not free the new allocation.
+    ranges.free(0, generation);
+    REQUIRE(ranges.used() == 64);
+}
@@ -0,0 +1,21 @@
+#version 450
+
+layout(location = 0) in vec4 vertexColour;
+
+layout(set = 0, binding = 0) uniform Frame {
+    vec2 scale;
+    vec2 offset;
+} frame;
+
+layout(set = 1, binding = 0) uniform sampler2D image;
+
+layout(push_constant) uniform Draw {
+    layout(offset = 16) float fade;
+} draw;
+
+layout(location = 0) out vec4 outColour;
+
+void
+main() {
+    outColour = texture(image, frame.offset) * vertexColour * draw.fade;
+}
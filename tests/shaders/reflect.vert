@@ -0,0 +1,21 @@
+#version 450
+
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec3 colour;
+
+layout(set = 0, binding = 0) uniform Frame {
+    vec2 scale;
+    vec2 offset;
+} frame;
+
+layout(push_constant) uniform Draw {
+    vec4 tint;
+} draw;
+
+layout(location = 0) out vec4 vertexColour;
+
+void
+main() {
+    gl_Position = vec4(position * frame.scale + frame.offset, 0.0, 1.0);
+    vertexColour = vec4(colour, 1.0) * draw.tint;
+}
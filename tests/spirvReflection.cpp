@@ -0,0 +1,134 @@
+#include "shaderUtility.hpp"
+#include "spirvReflection.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+
+using shaderUtils::ReflectedDescriptor;
+using shaderUtils::SpirvBinary;
+
+// SPIR-V of the GLSL next to it, rebuild with glslc -c when that changes.
+auto const testShaderPath = std::string{VKTUT_TEST_SHADER_PATH} + "/";
+
+auto constexpr vertexStage   = vk::ShaderStageFlagBits::eVertex;
+auto constexpr fragmentStage = vk::ShaderStageFlagBits::eFragment;
+
+[[nodiscard]] auto
+same_descriptor(ReflectedDescriptor const& lhs, ReflectedDescriptor const& rhs)
+        -> bool
+{
+    return lhs.set == rhs.set && lhs.binding == rhs.binding
+           && lhs.type == rhs.type && lhs.count == rhs.count;
+}
+
+TEST_CASE("A vertex shader's interface is reflected", "[spirvReflection]")
+{
+    auto const binary = SpirvBinary{testShaderPath + "reflect.vert.spv"};
+    auto const reflection =
+            shaderUtils::reflect_spirv(binary.words(), vertexStage);
+
+    REQUIRE(reflection.stage == vertexStage);
+
+    REQUIRE(reflection.descriptors.size() == 1);
+    REQUIRE(same_descriptor(
+            reflection.descriptors[0],
+            {0, 0, vk::DescriptorType::eUniformBuffer, 1}));
+
+    REQUIRE(reflection.pushConstants
+            == std::vector{vk::PushConstantRange(vertexStage, 0, 16)});
+
+    REQUIRE(reflection.inputs.size() == 2);
+    REQUIRE(reflection.inputs[0].location == 0);
+    REQUIRE(reflection.inputs[0].format == vk::Format::eR32G32Sfloat);
+    REQUIRE(reflection.inputs[1].location == 1);
+    REQUIRE(reflection.inputs[1].format == vk::Format::eR32G32B32Sfloat);
+
+    SECTION("Vertex attributes are checked against the inputs")
+    {
+        auto attributes = std::vector<vk::VertexInputAttributeDescription>{
+                {0, 0, vk::Format::eR32G32Sfloat, 0},
+                {1, 0, vk::Format::eR32G32B32Sfloat, 8}};
+        REQUIRE_NOTHROW(
+                shaderUtils::verify_vertex_input(reflection, attributes));
+
+        attributes[1].format = vk::Format::eR32G32Sfloat;
+        REQUIRE_THROWS(
+                shaderUtils::verify_vertex_input(reflection, attributes));
+
+        attributes.pop_back();
+        REQUIRE_THROWS(
+                shaderUtils::verify_vertex_input(reflection, attributes));
+    }
+}
+
+TEST_CASE("Shaders are merged into one layout", "[spirvReflection]")
+{
+    auto const vertexBinary = SpirvBinary{testShaderPath + "reflect.vert.spv"};
+    auto const fragmentBinary =
+            SpirvBinary{testShaderPath + "reflect.frag.spv"};
+
+    auto const vertex =
+            shaderUtils::reflect_spirv(vertexBinary.words(), vertexStage);
+    auto const fragment =
+            shaderUtils::reflect_spirv(fragmentBinary.words(), fragmentStage);
+
+    REQUIRE(fragment.inputs.empty());
+    REQUIRE(fragment.pushConstants
+            == std::vector{vk::PushConstantRange(fragmentStage, 16, 4)});
+
+    auto layout = shaderUtils::merge_reflections({&vertex, &fragment});
+
+    auto expected = shaderUtils::PipelineLayoutDescription{};
+    expected.sets = {
+            {vk::DescriptorSetLayoutBinding(
+                    0,
+                    vk::DescriptorType::eUniformBuffer,
+                    1,
+                    vertexStage | fragmentStage)},
+            {vk::DescriptorSetLayoutBinding(
+                    0,
+                    vk::DescriptorType::eCombinedImageSampler,
+                    1,
+                    fragmentStage)}};
+    expected.pushConstants = {
+            vk::PushConstantRange(vertexStage | fragmentStage, 0, 20)};
+    REQUIRE(layout == expected);
+
+    SECTION("Only buffers can be made dynamic")
+    {
+        shaderUtils::make_dynamic(layout, 0, 0);
+        REQUIRE(layout.sets[0][0].descriptorType
+                == vk::DescriptorType::eUniformBufferDynamic);
+
+        REQUIRE_THROWS(shaderUtils::make_dynamic(layout, 1, 0));
+        REQUIRE_THROWS(shaderUtils::make_dynamic(layout, 2, 0));
+    }
+
+    SECTION("Shaders that disagree on a binding are rejected")
+    {
+        auto clashing = fragment;
+        for(auto& descriptor : clashing.descriptors) {
+            if(descriptor.set == 0) {
+                descriptor.type = vk::DescriptorType::eStorageBuffer;
+            }
+        }
+
+        REQUIRE_THROWS(shaderUtils::merge_reflections({&vertex, &clashing}));
+    }
+}
+
+TEST_CASE("Malformed SPIR-V is rejected", "[spirvReflection]")
+{
+    auto const binary = SpirvBinary{testShaderPath + "reflect.vert.spv"};
+    auto const words  = binary.words();
+
+    // Cuts the first instruction after the header short.
+    REQUIRE_THROWS(shaderUtils::reflect_spirv(words.first(6), vertexStage));
+
+    auto corrupted =
+            std::vector<uint32_t>(std::cbegin(words), std::cend(words));
+    corrupted[0] = 0;
+    REQUIRE_THROWS(shaderUtils::reflect_spirv(corrupted, vertexStage));
+}